@@ -0,0 +1,454 @@
+// SPDX-License-Identifier: GPL-3.0-only
+//
+// (c) 2024 h67ma <szycikm@gmail.com>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+
+#ifdef _WIN32
+// windows.h must be included first
+#include <windows.h>
+
+#include <psapi.h>
+#elif defined(__linux__)
+#include <unistd.h>
+#endif
+
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <SFML/System/Clock.hpp>
+#include <SFML/Window/Context.hpp>
+#include <nlohmann/json.hpp>
+
+#include "campaigns/campaign.hpp"
+#include "campaigns/cell_layer_mesh.hpp"
+#include "campaigns/cell_row_tokenizer.hpp"
+#include "campaigns/room.hpp"
+#include "campaigns/room_cache_pool.hpp"
+#include "campaigns/room_cell.hpp"
+#include "campaigns/room_template.hpp"
+#include "consts.hpp"
+#include "entities/player.hpp"
+#include "hud/log.hpp"
+#include "materials/material_manager.hpp"
+#include "objects/object_manager.hpp"
+#include "resources/asset_archive.hpp"
+#include "resources/asset_manifest.hpp"
+#include "resources/resource_manager.hpp"
+#include "settings/settings_manager.hpp"
+#include "util/json.hpp"
+
+constexpr uint DEFAULT_ITERATIONS = 100;
+constexpr uint DEFAULT_CAMPAIGN_ITERATIONS = 3;
+const std::string ARG_CAMPAIGN = "--campaign";
+
+/**
+ * @return resident memory of the process in KiB, or 0 if it can't be determined on this platform
+ */
+static std::size_t getResidentMemoryKib()
+{
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS counters;
+	if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+		return 0;
+
+	return counters.WorkingSetSize / 1024;
+#elif defined(__linux__)
+	// total program size, followed by resident set size, both in pages
+	std::ifstream statm("/proc/self/statm");
+	std::size_t totalPages;
+	std::size_t residentPages;
+	if (!(statm >> totalPages >> residentPages))
+		return 0;
+
+	return residentPages * static_cast<std::size_t>(sysconf(_SC_PAGESIZE)) / 1024;
+#else
+	return 0;
+#endif
+}
+
+/**
+ * Splits a row of room cell data into cells one character at a time, as Room::load() did before tokenizeCellRow() was
+ * introduced. Kept here as a reference.
+ */
+static void scanCellRow(const std::string& row, struct cell_row_tokens& tokens)
+{
+	std::size_t cellBegin = 0;
+
+	tokens.cellCnt = 0;
+	for (std::size_t i = 0; i <= row.size(); i++)
+	{
+		if (i < row.size() && row[i] != ROOM_SYMBOL_SEPARATOR)
+			continue;
+
+		if (tokens.cellCnt < ROOM_WIDTH_WITH_BORDER)
+		{
+			tokens.cellBegins[tokens.cellCnt] = static_cast<std::uint32_t>(cellBegin);
+			tokens.cellEnds[tokens.cellCnt] = static_cast<std::uint32_t>(i);
+		}
+
+		tokens.cellCnt++;
+		cellBegin = i + 1;
+	}
+}
+
+static bool tokensEqual(const struct cell_row_tokens& a, const struct cell_row_tokens& b)
+{
+	if (a.cellCnt != b.cellCnt)
+		return false;
+
+	for (std::size_t x = 0; x < a.cellCnt && x < ROOM_WIDTH_WITH_BORDER; x++)
+	{
+		if (a.cellBegins[x] != b.cellBegins[x] || a.cellEnds[x] != b.cellEnds[x])
+			return false;
+	}
+
+	return true;
+}
+
+/**
+ * @return true if benchmark was run
+ */
+static bool benchTokenizer(const std::vector<const std::string*>& rows, uint iterations)
+{
+	struct cell_row_tokens tokens;
+	struct cell_row_tokens scanTokens;
+
+	// both need to give the same result, otherwise comparing them makes no sense
+	for (const std::string* row : rows)
+	{
+		tokenizeCellRow(row->data(), row->size(), tokens);
+		scanCellRow(*row, scanTokens);
+		if (!tokensEqual(tokens, scanTokens))
+		{
+			std::cerr << "Tokenizer result differs for row: " << *row << std::endl;
+			return false;
+		}
+	}
+
+	// cell counts are summed, so that the loops can't be optimized away
+	std::size_t cellSum = 0;
+	sf::Clock timer;
+	for (uint i = 0; i < iterations; i++)
+	{
+		for (const std::string* row : rows)
+		{
+			tokenizeCellRow(row->data(), row->size(), tokens);
+			cellSum += tokens.cellCnt;
+		}
+	}
+
+	const std::int64_t tokenizerUs = timer.restart().asMicroseconds();
+
+	for (uint i = 0; i < iterations; i++)
+	{
+		for (const std::string* row : rows)
+		{
+			scanCellRow(*row, scanTokens);
+			cellSum -= scanTokens.cellCnt;
+		}
+	}
+
+	const std::int64_t scanUs = timer.getElapsedTime().asMicroseconds();
+
+	std::cout << "Cell rows: " << rows.size() << " x " << iterations << " iterations" << std::endl;
+	std::cout << "  tokenizeCellRow(): " << tokenizerUs << " us" << std::endl;
+	std::cout << "  per-character loop: " << scanUs << " us" << std::endl;
+
+	return cellSum == 0;
+}
+
+static bool loadRooms(const nlohmann::json& roomNodes, const std::string& path, ResourceManager& resMgr,
+					  const MaterialManager& matMgr, const ObjectManager& objMgr, Player& player,
+					  std::vector<std::unique_ptr<Room>>& rooms)
+{
+	for (const auto& node : roomNodes)
+	{
+		// the background cache is disabled, so the cache id doesn't matter
+		std::unique_ptr<Room> room = std::make_unique<Room>(player, 0);
+		if (!room->load(resMgr, matMgr, objMgr, node, path, RoomTemplate::getJsonHash(node), false))
+			return false;
+
+		rooms.push_back(std::move(room));
+	}
+
+	return !rooms.empty();
+}
+
+/**
+ * @return true if benchmark was run
+ */
+static bool benchRoomInit(const nlohmann::json& roomNodes, const std::string& path, uint iterations)
+{
+	ResourceManager resMgr;
+	MaterialManager matMgr;
+	ObjectManager objMgr;
+	if (!matMgr.load() || !objMgr.load())
+		return false;
+
+	Player player(resMgr);
+
+	// rooms are loaded on another thread, same as in game (see Campaign::changeLocationAsync()), where textures are not
+	// uploaded right away
+	std::vector<std::unique_ptr<Room>> rooms;
+	bool loaded = false;
+	std::thread loader([&]() { loaded = loadRooms(roomNodes, path, resMgr, matMgr, objMgr, player, rooms); });
+	loader.join();
+	if (!loaded)
+		return false;
+
+	// textures are decoded in the background, they need to be ready before drawing
+	resMgr.finishPendingTextures();
+
+	// textures are shared between Rooms, so loading the same Rooms again only takes as much memory as the Rooms
+	// themselves
+	std::size_t memBeforeKib = getResidentMemoryKib();
+	std::vector<std::unique_ptr<Room>> roomsCopy;
+	if (!loadRooms(roomNodes, path, resMgr, matMgr, objMgr, player, roomsCopy))
+		return false;
+
+	std::size_t memAfterKib = getResidentMemoryKib();
+	roomsCopy.clear();
+
+	// sizes of the objects themselves, without anything they allocate, as a lower bound for the measured memory
+	std::cout << "Rooms: " << rooms.size() << std::endl;
+	std::cout << "  sizeof(Room): " << sizeof(Room) << " B, sizeof(RoomCell): " << sizeof(RoomCell) << " B"
+			  << std::endl;
+
+	if (memBeforeKib != 0)
+	{
+		std::size_t roomsKib = memAfterKib > memBeforeKib ? memAfterKib - memBeforeKib : 0;
+		std::cout << "  resident memory (without textures): " << roomsKib << " KiB, " << roomsKib / rooms.size()
+				  << " KiB per room" << std::endl;
+	}
+	else
+	{
+		std::cout << "  resident memory can't be measured on this platform" << std::endl;
+	}
+
+	// render textures are created only once, and then reused, same as in game. first round creates them, so it's not
+	// measured
+	RoomCachePool cachePool;
+	RoomBackCacheWriter backCacheWriter; // not used, as the background cache is disabled
+	for (auto& room : rooms)
+	{
+		room->init(cachePool, backCacheWriter);
+
+		// sprites set up before their textures were uploaded would not be drawn at all
+		if (room->hasEmptySprites())
+		{
+			std::cerr << "Room has sprites with empty texture rects after baking" << std::endl;
+			return false;
+		}
+
+		room->deinit(cachePool);
+	}
+
+	// cells are drawn in batches (see CellLayerMesh). drawing them one by one is measured too, for comparison
+	std::cout << "Rooms: " << rooms.size() << " x " << iterations << " iterations" << std::endl;
+	for (bool batched : { true, false })
+	{
+		CellLayerMesh::batched = batched;
+
+		sf::Clock timer;
+		for (uint i = 0; i < iterations; i++)
+		{
+			for (auto& room : rooms)
+			{
+				room->init(cachePool, backCacheWriter);
+				room->deinit(cachePool);
+			}
+		}
+
+		const std::int64_t initUs = timer.getElapsedTime().asMicroseconds();
+
+		std::cout << "  Room::init(), " << (batched ? "batched cells" : "draw call per cell quad") << ": " << initUs
+				  << " us, " << initUs / static_cast<std::int64_t>(rooms.size() * iterations) << " us per room"
+				  << std::endl;
+	}
+
+	CellLayerMesh::batched = true;
+	return true;
+}
+
+/**
+ * Removes all files from the cache dir (see SettingsManager::getCacheDir()), so that nothing can be loaded from cache.
+ */
+static bool clearCacheDir()
+{
+	std::error_code err;
+	std::filesystem::remove_all(SettingsManager::getCacheDir(), err);
+	if (err)
+		return false;
+
+	std::filesystem::create_directories(SettingsManager::getCacheDir(), err);
+	return !err;
+}
+
+/**
+ * Loads the campaign, including decoding all textures needed by the start Location and baking the start Room, same as
+ * before the first frame is displayed in game. Managers are created from scratch, so that nothing is kept in memory
+ * between loads.
+ *
+ * @param timeUs load time will be added to this
+ */
+static bool loadCampaign(const std::string& campaignId, std::int64_t& timeUs)
+{
+	ResourceManager resMgr;
+	Campaign campaign(resMgr);
+
+	sf::Clock timer;
+	if (!campaign.load(campaignId))
+		return false;
+
+	campaign.getCurrentLocation()->bakeCurrentRoom();
+	timeUs += timer.getElapsedTime().asMicroseconds();
+
+	// pick up messages logged by worker threads
+	Log::tick();
+	return true;
+}
+
+/**
+ * Compares full loads of a campaign without the texture cache (see TextureCache), with an empty cache, and with all
+ * textures already cached. Other caches (e.g. compiled rooms) are warm in the first and the last case.
+ *
+ * Note: this removes everything from the cache dir.
+ *
+ * @return true if benchmark was run
+ */
+static bool benchCampaignLoad(const std::string& campaignId, uint iterations)
+{
+	std::int64_t offUs = 0;
+	std::int64_t coldUs = 0;
+	std::int64_t warmUs = 0;
+
+	for (uint i = 0; i < iterations; i++)
+	{
+		if (!clearCacheDir())
+		{
+			std::cerr << "Failed to clear the cache dir: " << SettingsManager::getCacheDir() << std::endl;
+			return false;
+		}
+
+		SettingsManager::textureCache = true;
+		if (!loadCampaign(campaignId, coldUs) || !loadCampaign(campaignId, warmUs))
+			return false;
+
+		SettingsManager::textureCache = false;
+		if (!loadCampaign(campaignId, offUs))
+			return false;
+	}
+
+	std::cout << "Campaign " << campaignId << " x " << iterations << " iterations" << std::endl;
+	std::cout << "  texture cache off: " << offUs / iterations << " us per load" << std::endl;
+	std::cout << "  texture cache cold: " << coldUs / iterations << " us per load" << std::endl;
+	std::cout << "  texture cache warm: " << warmUs / iterations << " us per load" << std::endl;
+
+	return true;
+}
+
+/**
+ * Room loading benchmark.
+ *
+ * Measures splitting cell rows (see tokenizeCellRow()) against a plain per-character loop, resident memory of loaded
+ * Rooms, and baking Rooms (see Room::init()) with and without batching cells (see CellLayerMesh), using all Rooms of a
+ * rooms file. Rooms are baked without the background cache (see RoomBackCache), so that every bake actually draws the
+ * Room. A GL context is created, but no window. Results are printed to stdout.
+ *
+ * Rooms are loaded on another thread, same as in game, and checked to be baked with all their sprites visible.
+ *
+ * With --campaign, full loads of a campaign are measured instead, with and without cached textures (see
+ * benchCampaignLoad()). Note that this clears the cache dir.
+ *
+ * Usage:
+ *   foerr-bench <rooms file> [iterations]
+ *   foerr-bench --campaign <campaign id> [iterations]
+ *
+ * Exit code is 0 if the benchmark was run, 1 otherwise.
+ */
+int main(int argc, char* argv[])
+{
+	const bool campaignMode = argc >= 2 && argv[1] == ARG_CAMPAIGN;
+	const int argOffset = campaignMode ? 1 : 0;
+	if (argc != 2 + argOffset && argc != 3 + argOffset)
+	{
+		std::cerr << "Usage: " << argv[0] << " <rooms file> [iterations]" << std::endl;
+		std::cerr << "       " << argv[0] << " " << ARG_CAMPAIGN << " <campaign id> [iterations]" << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	const std::string path = argv[1 + argOffset];
+	uint iterations = campaignMode ? DEFAULT_CAMPAIGN_ITERATIONS : DEFAULT_ITERATIONS;
+	if (argc == 3 + argOffset)
+	{
+		iterations = static_cast<uint>(std::strtoul(argv[2 + argOffset], nullptr, 10));
+		if (iterations == 0)
+		{
+			std::cerr << "Invalid iteration count: " << argv[2 + argOffset] << std::endl;
+			return EXIT_FAILURE;
+		}
+	}
+
+	SettingsManager::setup();
+	Log::setup();
+	SettingsManager::debugVerbose = false;
+	SettingsManager::roomBackCache = false;
+
+	AssetArchive::open(PATH_ASSET_ARCHIVE); // optional
+	AssetManifest::build(PATH_DIR_RES);
+
+	if (campaignMode)
+	{
+		// rooms are drawn to render textures, which need a GL context
+		sf::Context context;
+		return benchCampaignLoad(path, iterations) ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	nlohmann::json root;
+	if (!loadJsonFromFile(root, path))
+		return EXIT_FAILURE;
+
+	auto roomsSearch = root.find(FOERR_JSON_KEY_ROOMS);
+	if (roomsSearch == root.end() || !roomsSearch->is_array())
+	{
+		std::cerr << "No rooms in " << path << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	std::vector<const std::string*> rows;
+	for (const auto& roomNode : *roomsSearch)
+	{
+		auto cellsSearch = roomNode.find(FOERR_JSON_KEY_CELLS);
+		if (cellsSearch == roomNode.end() || !cellsSearch->is_array())
+			continue;
+
+		for (const auto& rowNode : *cellsSearch)
+		{
+			if (rowNode.is_string())
+				rows.push_back(&rowNode.get_ref<const std::string&>());
+		}
+	}
+
+	if (!benchTokenizer(rows, iterations))
+		return EXIT_FAILURE;
+
+	// rooms are drawn to render textures, which need a GL context
+	sf::Context context;
+
+	bool result = benchRoomInit(*roomsSearch, path, iterations);
+
+	// pick up messages logged by worker threads
+	Log::tick();
+
+	return result ? EXIT_SUCCESS : EXIT_FAILURE;
+}
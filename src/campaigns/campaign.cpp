@@ -4,18 +4,34 @@
 
 #include "campaign.hpp"
 
+#include <algorithm>
 #include <string>
+#include <utility>
+
+#include <SFML/System/Clock.hpp>
 
 #include "../consts.hpp"
 #include "../hud/log.hpp"
+#include "../resources/asset_manifest.hpp"
+#include "../settings/settings_manager.hpp"
 #include "../util/i18n.hpp"
 #include "../util/json.hpp"
+#include "../util/load_progress.hpp"
+#include "../util/parallel.hpp"
 
 Campaign::Campaign(ResourceManager& resMgr) : resMgr(resMgr), player(resMgr)
 {
 	// big iron on his hip
 }
 
+Campaign::~Campaign()
+{
+	// the load threads can't be left running, as they're accessing the Campaign
+	this->stopLoad();
+	this->discardPrefetch();
+	this->handleDiscardedPrefetches(true);
+}
+
 /**
  * Loads a campaign from path. If previous campaign is loaded, it will be automatically unloaded first.
  * Also loads materials into Material Manager.
@@ -48,10 +64,55 @@ bool Campaign::load(const std::string& campaignId)
 {
 	Log::d(STR_CAMPAIGN_LOADING, campaignId.c_str());
 
+	// logged, so that load times can be compared, e.g. with and without the texture cache
+	sf::Clock loadTimer;
+
 	this->unload();
 
-	// load basic campaign infos
+	if (!this->loadInfo(campaignId))
+		return false;
+
+	if (LoadProgress::getCurrent()->isCancelled())
+	{
+		this->unload();
+		return false;
+	}
+
+	// TODO load other stuffs (most probably campaign-specific resources, so just /audio, /texture, etc)
+	// TODO restore game state from save
+
+	// TODO restore from save
+
+	if (!this->matMgr.load())
+		return false;
+
+	if (!this->objMgr.load())
+		return false;
+
+	if (!this->changeLocation(this->startLocationId))
+	{
+		// don't leave a half-loaded Campaign behind if the load was cancelled while loading the start Location
+		if (LoadProgress::getCurrent()->isCancelled())
+			this->unload();
+
+		return false;
+	}
+
+	Log::d(STR_CAMPAIGN_LOADED, pathCombine(PATH_CAMPAIGNS, campaignId).c_str(),
+		   loadTimer.getElapsedTime().asMilliseconds());
+	return true;
+}
 
+/**
+ * Loads basic campaign infos from the index file and metadata for all Locations (see ::load() for file structure).
+ * Location content is not loaded.
+ *
+ * @param campaignId id of the campaign to load
+ * @return true if load succeeded
+ * @return false if load failed
+ */
+bool Campaign::loadInfo(const std::string& campaignId)
+{
 	this->id = campaignId;
 
 	const std::string campaignDir = pathCombine(PATH_CAMPAIGNS, campaignId);
@@ -71,8 +132,7 @@ bool Campaign::load(const std::string& campaignId)
 
 	// TODO translate title & description
 
-	std::string startLocation;
-	if (!parseJsonKey<std::string>(root, indexPath, FOERR_JSON_KEY_START_LOC, startLocation))
+	if (!parseJsonKey<std::string>(root, indexPath, FOERR_JSON_KEY_START_LOC, this->startLocationId))
 		return false;
 
 	// load metadata for all locations inside this campaign.
@@ -81,9 +141,7 @@ bool Campaign::load(const std::string& campaignId)
 	// middle of gameplay, but even then the player could save game and fix/report the faulty location without losing
 	// progress. Metadata for all locations is kept in a single file, separate from room data (and background big path),
 	// to avoid processing all files containing all room data when we only want to get metadata for each location to
-	// display it on the world map.
-	// TODO? we could add a button in campaign selector which would trigger test-loading all locations along with all
-	// rooms.
+	// display it on the world map. All locations along with all rooms can be test-loaded via ::validate().
 
 	std::string locMetaPath = pathCombine(campaignDir, PATH_LOCATIONS_META);
 	root.clear();
@@ -128,32 +186,100 @@ bool Campaign::load(const std::string& campaignId)
 		this->locations.emplace(locId, loc);
 	}
 
-	// TODO load other stuffs (most probably campaign-specific resources, so just /audio, /texture, etc)
-	// TODO restore game state from save
+	return true;
+}
 
-	// TODO restore from save
+/**
+ * Validates a campaign without playing it: loads campaign infos, materials and objects, and then validates content of
+ * all Locations (see Location::validateContent()), in parallel. Nothing is drawn, so this can be used with a headless
+ * Resource Manager. The campaign is unloaded afterwards.
+ *
+ * Any previously loaded campaign is unloaded first. Errors are logged.
+ *
+ * @param campaignId id of the campaign to validate
+ * @param result validation result will be stored here
+ * @return true if the campaign is valid
+ * @return false if the campaign is invalid
+ */
+bool Campaign::validate(const std::string& campaignId, struct campaign_validation& result)
+{
+	this->unload();
 
-	if (!this->matMgr.load())
+	result = {};
+	if (!this->loadInfo(campaignId) || !this->matMgr.load() || !this->objMgr.load())
+	{
+		this->unload();
 		return false;
+	}
 
-	if (!this->objMgr.load())
-		return false;
+	result.startLocationFound = this->locations.find(this->startLocationId) != this->locations.end();
+	if (!result.startLocationFound)
+		Log::e(STR_START_LOC_NOT_FOUND, this->startLocationId.c_str());
 
-	if (!this->changeLocation(startLocation))
-		return false;
+	// sort by id to get stable results
+	for (const auto& entry : this->locations)
+	{
+		result.locations.emplace_back(entry.first, location_validation());
+	}
 
-	Log::d(STR_CAMPAIGN_LOADED, campaignDir.c_str());
-	return true;
+	std::sort(result.locations.begin(), result.locations.end(),
+			  [](const auto& left, const auto& right) { return left.first < right.first; });
+
+	// all Locations are validated, even if some are invalid, to report as many errors as possible in one go
+	parallelFor(result.locations.size(),
+				[this, &result](std::size_t i)
+				{
+					this->locations.at(result.locations[i].first)
+						->validateContent(this->resMgr, this->matMgr, this->objMgr, this->roomTemplates,
+										  result.locations[i].second);
+					return true;
+				});
+
+	result.missingTextures = this->resMgr.takeMissingTextures();
+	result.valid = result.startLocationFound &&
+				   std::all_of(result.locations.begin(), result.locations.end(),
+							   [](const auto& loc) { return loc.second.valid; });
+
+	this->unload();
+	return result.valid;
+}
+
+/**
+ * Starts loading a campaign (see ::load()) on a separate thread. Until the load is finished, the Campaign must not be
+ * accessed, except for calling ::isLoading(), ::cancelLoad(), and ::handleLoadFinished().
+ *
+ * Load progress can be tracked via LoadProgress::getMain().
+ *
+ * @param campaignId id of the campaign to load
+ * @param callback will be called on the main thread (from ::handleLoadFinished()) with the result of the load
+ */
+void Campaign::loadAsync(const std::string& campaignId, const std::function<void(bool)>& callback)
+{
+	// the prefetched Location belongs to the previous Campaign
+	this->discardPrefetch();
+
+	// Locations of the previous Campaign hold render caches of their Rooms, which must be destroyed on the main
+	// thread, so the previous Campaign is unloaded here rather than in ::load()
+	this->stopLoad();
+	if (!this->locations.empty())
+		this->unload();
+
+	this->startLoadJob([this, campaignId]() { return this->load(campaignId); }, callback);
 }
 
 void Campaign::unload()
 {
 	Log::d(STR_CAMPAIGN_UNLOADING);
+	this->discardPrefetch();
+	this->roomFileWatcher.clear();
+	this->watchedRoomDataPath.clear();
 	this->title = "";
 	this->description = "";
+	this->startLocationId = "";
 	this->currentLocation = nullptr;
 	this->lastUnloadableLocation = nullptr;
 	this->locations.clear();
+	this->roomTemplates.clear(); // templates depend on materials of the Campaign
 	this->resMgr.cleanUnused();
 	Log::d(STR_CAMPAIGN_UNLOADED);
 }
@@ -224,11 +350,27 @@ bool Campaign::changeLocation(const std::string& newLocId)
 
 	std::shared_ptr<Location> newLoc = newLocSearch->second;
 
+	bool prefetched = false;
+	if (this->prefetch != nullptr && this->prefetch->loc == newLoc)
+	{
+		// the Location was selected on the world map, so it has been (or still is being) loaded in the background.
+		// cancelling this load also cancels the prefetch (see ::cancelLoad())
+		this->prefetch->thread.join();
+		prefetched = this->prefetch->result;
+		this->prefetch = nullptr;
+	}
+	else
+	{
+		this->discardPrefetch();
+	}
+
 	// load the new location. don't unload the old one yet, as the new one might fail to load and then we need to keep
 	// the old one
-	if (!newLoc->loadContent(this->resMgr, this->matMgr, this->objMgr))
+	if (!prefetched && !newLoc->loadContent(this->resMgr, this->matMgr, this->objMgr, this->roomTemplates))
 	{
-		Log::e(STR_LOADING_LOCATION_CONTENT_ERROR, newLocSearch->first.c_str());
+		if (!LoadProgress::getCurrent()->isCancelled())
+			Log::e(STR_LOADING_LOCATION_CONTENT_ERROR, newLocSearch->first.c_str());
+
 		return false;
 	}
 
@@ -258,9 +400,8 @@ bool Campaign::changeLocation(const std::string& newLocId)
 		}
 		else if (!this->currentLocation->isBasecamp() && !newLoc->isBasecamp())
 		{
-			// non-basecamp -> non-basecamp: unload old location
-			this->currentLocation->unloadContent();
-			this->resMgr.cleanUnused();
+			// non-basecamp -> non-basecamp: unload old location (see ::handleLoadFinished())
+			this->pendingUnloads.push_back(this->currentLocation);
 			// we don't care about last unloadable loc in this case.
 			// we'll take care of it when we transition to a basecamp (see first branch)
 		}
@@ -269,10 +410,7 @@ bool Campaign::changeLocation(const std::string& newLocId)
 			// basecamp -> non-basecamp: unload last unloadable (if it exists and is not the location which we're
 			// trying to load now) and unset it
 			if (this->lastUnloadableLocation != nullptr && this->lastUnloadableLocation != newLoc)
-			{
-				this->lastUnloadableLocation->unloadContent();
-				this->resMgr.cleanUnused();
-			}
+				this->pendingUnloads.push_back(this->lastUnloadableLocation);
 
 			this->lastUnloadableLocation = nullptr;
 		}
@@ -281,6 +419,9 @@ bool Campaign::changeLocation(const std::string& newLocId)
 
 	this->currentLocation = newLoc;
 
+	// basecamps and prefetched Locations could have been loaded when the window had a different size
+	this->currentLocation->updateBackgroundFull(this->resMgr);
+
 	sf::Vector2u spawnCoordsPx = this->currentLocation->getSpawnCoords() * CELL_SIDE_LEN;
 	this->player.setPosition(spawnCoordsPx.x, spawnCoordsPx.y);
 
@@ -288,6 +429,235 @@ bool Campaign::changeLocation(const std::string& newLocId)
 	return true;
 }
 
+/**
+ * Starts changing the current Location (see ::changeLocation()) on a separate thread. Same restrictions as in
+ * ::loadAsync() apply.
+ *
+ * @param newLocId new location id
+ * @param callback will be called on the main thread (from ::handleLoadFinished()) with the result of the change
+ */
+void Campaign::changeLocationAsync(const std::string& newLocId, const std::function<void(bool)>& callback)
+{
+	// discarded here rather than in ::changeLocation(), so that the prefetch is stopped before the load starts (see
+	// ::startLoadJob())
+	if (this->prefetch != nullptr && this->prefetch->loc->getId() != newLocId)
+		this->discardPrefetch();
+
+	// a kept Location (e.g. a basecamp) is loaded again from scratch (see Location::loadContent()). its Rooms hold
+	// render caches, which must be destroyed on the main thread, so the old content is unloaded here. discarded
+	// prefetches could still be loading the Location, so they need to stop first
+	this->stopLoad();
+	this->handleDiscardedPrefetches(true);
+
+	auto search = this->locations.find(newLocId);
+	if (search != this->locations.end() && search->second != this->currentLocation && this->prefetch == nullptr &&
+		search->second->isContentLoaded())
+		search->second->unloadContent();
+
+	if (this->prefetch != nullptr)
+		this->loadPrefetchProgress = this->prefetch->progress;
+
+	this->startLoadJob([this, newLocId]() { return this->changeLocation(newLocId); }, callback);
+}
+
+/**
+ * Starts loading content of a Location in the background, on the assumption that the player will travel to it soon
+ * (e.g. because it was selected on the world map). If ::changeLocation() is then called for the same Location, it
+ * doesn't need to load it again. Only one Location is prefetched at a time - prefetching another one discards the
+ * previous one.
+ *
+ * Has no effect if the Location is already loaded or being prefetched, or if prefetching is disabled via
+ * SettingsManager::prefetchLocations.
+ *
+ * Must not be called while a load started via ::loadAsync() or ::changeLocationAsync() is in progress.
+ *
+ * @param locId id of the Location to prefetch
+ */
+void Campaign::prefetchLocation(const std::string& locId)
+{
+	if (!SettingsManager::prefetchLocations)
+		return;
+
+	if (this->prefetch != nullptr && this->prefetch->loc->getId() == locId)
+		return;
+
+	auto search = this->locations.find(locId);
+	if (search == this->locations.end())
+		return;
+
+	this->handleDiscardedPrefetches(false);
+
+	// a Location can't be loaded twice at the same time. it's only a hint anyway, so just skip it
+	for (const auto& discarded : this->discardedPrefetches)
+	{
+		if (discarded->loc == search->second)
+			return;
+	}
+
+	// the current Location and kept basecamps are already loaded
+	if (search->second->isContentLoaded())
+		return;
+
+	this->discardPrefetch();
+
+	Log::v(STR_PREFETCHING_LOCATION, locId.c_str());
+
+	this->prefetch = std::make_unique<struct location_prefetch>();
+	this->prefetch->loc = search->second;
+
+	struct location_prefetch* pf = this->prefetch.get();
+	pf->thread = std::thread(
+		[this, pf]()
+		{
+			// the prefetch reports to its own progress, so that it doesn't mix with other loads
+			LoadProgress::setCurrent(pf->progress);
+			pf->result = pf->loc->loadContent(this->resMgr, this->matMgr, this->objMgr, this->roomTemplates);
+			pf->finished = true;
+		});
+}
+
+/**
+ * Cancels prefetching a Location (see ::prefetchLocation()). Doesn't wait for the prefetch to stop - the Location is
+ * unloaded later, once it has stopped (see ::handleDiscardedPrefetches()). Has no effect if nothing is prefetched.
+ */
+void Campaign::discardPrefetch()
+{
+	if (this->prefetch == nullptr)
+		return;
+
+	this->prefetch->progress->cancel();
+	this->discardedPrefetches.push_back(std::move(this->prefetch));
+}
+
+/**
+ * Unloads Locations of discarded prefetches (see ::discardPrefetch()) which have stopped. Must be called on the main
+ * thread, while no load is in progress.
+ *
+ * @param wait if true, waits for all discarded prefetches to stop. they're cancelled, so it shouldn't take long
+ */
+void Campaign::handleDiscardedPrefetches(bool wait)
+{
+	if (this->discardedPrefetches.empty())
+		return;
+
+	std::size_t oldCnt = this->discardedPrefetches.size();
+	for (auto it = this->discardedPrefetches.begin(); it != this->discardedPrefetches.end();)
+	{
+		if (!wait && !(*it)->finished)
+		{
+			it++;
+			continue;
+		}
+
+		(*it)->thread.join();
+		(*it)->loc->unloadContent();
+		it = this->discardedPrefetches.erase(it);
+	}
+
+	if (this->discardedPrefetches.size() == oldCnt)
+		return;
+
+	this->resMgr.cleanUnused();
+	this->roomTemplates.cleanUnused();
+}
+
+void Campaign::startLoadJob(const std::function<bool()>& job, const std::function<void(bool)>& callback)
+{
+	// only one load can be in progress at a time
+	this->stopLoad();
+
+	// discarded prefetches would keep adding to the progress of this load
+	this->handleDiscardedPrefetches(true);
+
+	LoadProgress::getMain()->reset();
+	this->loadFinished = false;
+	this->loadCallback = callback;
+	this->loadThread = std::thread(
+		[this, job]()
+		{
+			this->loadResult = job();
+			this->loadFinished = true;
+		});
+}
+
+/**
+ * @return true if a load started by ::loadAsync() or ::changeLocationAsync() hasn't been handled yet
+ */
+bool Campaign::isLoading() const
+{
+	return this->loadThread.joinable();
+}
+
+/**
+ * Requests the current load to be cancelled. The load will fail shortly after, and the callback will be called with
+ * false. If a Location was being changed, the previous Location will stay active. If the load is waiting for a
+ * prefetch of that Location, the prefetch is cancelled as well.
+ */
+void Campaign::cancelLoad()
+{
+	if (!this->loadThread.joinable())
+		return;
+
+	LoadProgress::getMain()->cancel();
+	if (this->loadPrefetchProgress != nullptr)
+		this->loadPrefetchProgress->cancel();
+}
+
+/**
+ * Cancels the current load (if any) and waits until it stops. The callback is not called.
+ */
+void Campaign::stopLoad()
+{
+	if (!this->loadThread.joinable())
+		return;
+
+	this->cancelLoad();
+	this->loadThread.join();
+	this->loadCallback = nullptr;
+	this->loadPrefetchProgress = nullptr;
+}
+
+/**
+ * Should be called on the main thread on every frame while a load is in progress. If the load has finished, calls
+ * the callback passed when starting the load.
+ *
+ * The load itself only loads data. Render caches can only be used on the main thread, so this is where old Locations
+ * are unloaded (see ::changeLocation()) and the current Room is baked.
+ */
+void Campaign::handleLoadFinished()
+{
+	if (!this->loadThread.joinable() || !this->loadFinished)
+		return;
+
+	this->loadThread.join();
+	this->loadPrefetchProgress = nullptr;
+	this->handleDiscardedPrefetches(false);
+
+	if (!this->pendingUnloads.empty())
+	{
+		for (const auto& loc : this->pendingUnloads)
+		{
+			loc->unloadContent();
+		}
+
+		this->pendingUnloads.clear();
+		this->resMgr.cleanUnused();
+		this->roomTemplates.cleanUnused();
+	}
+
+	if (this->loadResult && this->currentLocation != nullptr)
+		this->currentLocation->bakeCurrentRoom();
+
+	if (!this->loadResult && LoadProgress::getMain()->isCancelled())
+		Log::i(STR_LOADING_CANCELLED);
+
+	// callback could start another load, which would replace the callback
+	std::function<void(bool)> callback = std::move(this->loadCallback);
+	this->loadCallback = nullptr;
+	if (callback)
+		callback(this->loadResult);
+}
+
 bool Campaign::isLoaded()
 {
 	return this->currentLocation != nullptr;
@@ -323,6 +693,60 @@ void Campaign::redraw()
 	this->currentLocation->redraw();
 }
 
+/**
+ * Switches the background of current Location to a variant matching current size of the game world viewport (see
+ * ResourceManager::setWorldViewportSize()). Other Locations are updated when they're entered.
+ */
+void Campaign::handleWorldViewportChange()
+{
+	if (this->currentLocation == nullptr)
+		return;
+
+	// previous variant is not used anymore
+	if (this->currentLocation->updateBackgroundFull(this->resMgr))
+		this->resMgr.cleanUnused();
+}
+
+void Campaign::redrawIfUsesTexture(const std::unordered_set<const sf::Texture*>& textures)
+{
+	if (this->currentLocation == nullptr)
+		return;
+
+	this->currentLocation->redrawIfUsesTexture(textures);
+}
+
+/**
+ * Watches the rooms file of the current Location, and reloads Rooms which changed when the file is modified (see
+ * Location::reloadChangedRooms()). Meant for editing Rooms while the game is running.
+ *
+ * Should be called periodically (e.g. on every frame) while SettingsManager::debugHotReloadRooms is set.
+ */
+void Campaign::hotReloadRooms()
+{
+	if (this->currentLocation == nullptr)
+		return;
+
+	const std::string path = this->currentLocation->getRoomDataPath();
+	if (path != this->watchedRoomDataPath)
+	{
+		// only the current Location is watched
+		this->roomFileWatcher.clear();
+		this->watchedRoomDataPath = path;
+
+		// archived files can't be edited anyway
+		if (!AssetManifest::isLoose(path) || !this->roomFileWatcher.watch(path))
+			Log::w(STR_HOT_RELOAD_WATCH_FAIL, path.c_str());
+
+		return;
+	}
+
+	if (this->roomFileWatcher.pollChanged().empty())
+		return;
+
+	if (!this->currentLocation->reloadChangedRooms(this->resMgr, this->matMgr, this->objMgr, this->roomTemplates))
+		Log::e(STR_ROOMS_RELOAD_FAILED, path.c_str());
+}
+
 /**
  * Logs a message consisting of current Location name, Room coordinates, Player position, and Cell coordinates at
  * Player's position.
@@ -349,6 +773,8 @@ void Campaign::tick(uint lastFrameDurationUs)
 	if (this->currentLocation == nullptr)
 		return;
 
+	this->handleDiscardedPrefetches(false);
+
 	this->currentLocation->tick(lastFrameDurationUs);
 }
 
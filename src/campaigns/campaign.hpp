@@ -4,9 +4,15 @@
 
 #pragma once
 
+#include <atomic>
+#include <functional>
 #include <memory>
 #include <string>
+#include <thread>
 #include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include <SFML/System/Vector3.hpp>
 
@@ -15,7 +21,29 @@
 #include "../objects/object_manager.hpp"
 #include "../resources/resource_manager.hpp"
 #include "../settings/keymap.hpp"
+#include "../util/file_watcher.hpp"
+#include "../util/load_progress.hpp"
 #include "location.hpp"
+#include "room_template_cache.hpp"
+
+// result of validating a campaign, see Campaign::validate()
+struct campaign_validation
+{
+		bool valid = false;
+		bool startLocationFound = false;
+		std::vector<std::pair<std::string, struct location_validation>> locations;
+		std::vector<std::string> missingTextures;
+};
+
+// Location being loaded in the background, see Campaign::prefetchLocation()
+struct location_prefetch
+{
+		std::shared_ptr<Location> loc;
+		std::thread thread;
+		std::shared_ptr<LoadProgress> progress = std::make_shared<LoadProgress>(); // also used to cancel the prefetch
+		std::atomic<bool> finished = false;
+		bool result = false;
+};
 
 /**
  * The Campaign class stores Locations and other useful information related to the currently loaded campaign.
@@ -23,6 +51,10 @@
  * Metadata for all Locations is kept loaded, but not all Location content is kept loaded at the same time. Apart from
  * the current Location, all basecamps visited since the Campaign was created are kept fully loaded, as well as the
  * previous non-basecamp Location, if the player traveled from it to a basecamp.
+ *
+ * Loading the Campaign and changing Locations can take a while, so it can also be done on a separate thread (see
+ * ::loadAsync() and ::changeLocationAsync()), while the main thread keeps displaying the loading screen. The Campaign
+ * must not be accessed in any other way until the load is finished.
  */
 class Campaign : public sf::Drawable
 {
@@ -30,10 +62,12 @@ class Campaign : public sf::Drawable
 		std::string id;
 		std::string title;
 		std::string description;
+		std::string startLocationId;
 		Player player;
 		ResourceManager& resMgr;
 		MaterialManager matMgr;
 		ObjectManager objMgr;
+		RoomTemplateCache roomTemplates; // must outlive Locations, as they can still be loading Rooms in the background
 
 		std::shared_ptr<Location> currentLocation = nullptr;
 
@@ -42,10 +76,37 @@ class Campaign : public sf::Drawable
 
 		std::unordered_map<std::string, std::shared_ptr<Location>> locations;
 
+		std::thread loadThread;
+		std::atomic<bool> loadFinished = false;
+		bool loadResult = false;
+		std::function<void(bool)> loadCallback;
+		std::vector<std::shared_ptr<Location>> pendingUnloads; // see ::handleLoadFinished()
+
+		// Location loaded speculatively, before the player actually travels to it (see ::prefetchLocation())
+		std::unique_ptr<struct location_prefetch> prefetch;
+
+		// progress of the prefetch which the current load waits for, it's cancelled along with the load (see
+		// ::cancelLoad())
+		std::shared_ptr<LoadProgress> loadPrefetchProgress = nullptr;
+
+		// cancelled prefetches which might still be running (see ::discardPrefetch())
+		std::vector<std::unique_ptr<struct location_prefetch>> discardedPrefetches;
+
+		// rooms file of the current Location is watched for changes when SettingsManager::debugHotReloadRooms is set
+		FileWatcher roomFileWatcher;
+		std::string watchedRoomDataPath;
+
+		bool loadInfo(const std::string& campaignId);
+		void startLoadJob(const std::function<bool()>& job, const std::function<void(bool)>& callback);
+		void handleDiscardedPrefetches(bool wait);
+
 	public:
 		explicit Campaign(ResourceManager& resMgr);
+		~Campaign() override;
 		bool load(const std::string& campaignId);
+		void loadAsync(const std::string& campaignId, const std::function<void(bool)>& callback);
 		void unload();
+		bool validate(const std::string& campaignId, struct campaign_validation& result);
 		std::string getId() const;
 		std::string getTitle() const;
 		std::string getDescription() const;
@@ -54,10 +115,20 @@ class Campaign : public sf::Drawable
 		const std::shared_ptr<Location> getCurrentLocation() const;
 		const std::shared_ptr<Location> getLocation(const std::string& locId) const;
 		bool changeLocation(const std::string& newLocId);
+		void changeLocationAsync(const std::string& newLocId, const std::function<void(bool)>& callback);
+		void prefetchLocation(const std::string& locId);
+		void discardPrefetch();
+		bool isLoading() const;
+		void cancelLoad();
+		void stopLoad();
+		void handleLoadFinished();
 		bool isLoaded();
 		bool gotoRoom(Direction direction);
 		bool gotoRoom(HashableVector3i coords);
 		void redraw();
+		void handleWorldViewportChange();
+		void redrawIfUsesTexture(const std::unordered_set<const sf::Texture*>& textures);
+		void hotReloadRooms();
 		void logWhereAmI();
 		void tick(uint lastFrameDurationUs);
 		void nextFrame();
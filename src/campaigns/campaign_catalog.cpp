@@ -0,0 +1,300 @@
+// SPDX-License-Identifier: GPL-3.0-only
+//
+// (c) 2024 h67ma <szycikm@gmail.com>
+
+#include "campaign_catalog.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <set>
+#include <system_error>
+#include <unordered_map>
+
+#include "../consts.hpp"
+#include "../hud/log.hpp"
+#include "../resources/asset_archive.hpp"
+#include "../settings/settings_manager.hpp"
+#include "../util/i18n.hpp"
+#include "../util/json.hpp"
+#include "../util/mapped_file.hpp"
+#include "../util/util.hpp"
+
+const std::string FILENAME_CAMPAIGN_CATALOG = "campaigns.bin";
+
+CampaignCatalog::~CampaignCatalog()
+{
+	// the rescan thread stores its results in the catalog, so it must not outlive it
+	if (this->rescanThread.joinable())
+		this->rescanThread.join();
+}
+
+std::string CampaignCatalog::getCachePath()
+{
+	return pathCombine(SettingsManager::getCacheDir(), FILENAME_CAMPAIGN_CATALOG);
+}
+
+/**
+ * Unlike AssetArchive::getFileStamp(), loose files are checked on the filesystem, not in the asset manifest, so that
+ * campaigns added while the game is running are also found.
+ */
+struct file_stamp CampaignCatalog::getFileStamp(const std::string& path)
+{
+	struct file_stamp stamp;
+
+	std::error_code err;
+	stamp.size = std::filesystem::file_size(path, err);
+	if (!err)
+	{
+		stamp.mtime = std::filesystem::last_write_time(path, err).time_since_epoch().count();
+		stamp.exists = !err;
+		return stamp;
+	}
+
+	stamp.exists = AssetArchive::getFileStamp(path, stamp.size, stamp.mtime);
+	return stamp;
+}
+
+bool CampaignCatalog::readEntry(BinaryReader& reader, struct campaign_catalog_entry& entry)
+{
+	return reader.readString(entry.id) && reader.readString(entry.title) && reader.readString(entry.description) &&
+		   reader.read(entry.locationCnt) && reader.read(entry.indexStamp) && reader.read(entry.locationsStamp);
+}
+
+void CampaignCatalog::writeEntry(BinaryWriter& writer, const struct campaign_catalog_entry& entry)
+{
+	writer.writeString(entry.id);
+	writer.writeString(entry.title);
+	writer.writeString(entry.description);
+	writer.write(entry.locationCnt);
+	writer.write(entry.indexStamp);
+	writer.write(entry.locationsStamp);
+}
+
+/**
+ * Reads campaign infos from the index file and Locations metadata file of a campaign. In case of any errors, title
+ * and description will be filled with ??? and errors/warnings will be logged.
+ *
+ * @param entry entry to fill, only the id needs to be set
+ */
+void CampaignCatalog::parseEntry(struct campaign_catalog_entry& entry)
+{
+	std::string indexPath = pathCombine(PATH_CAMPAIGNS, entry.id, FILENAME_INDEX);
+	std::string locMetaPath = pathCombine(PATH_CAMPAIGNS, entry.id, PATH_LOCATIONS_META);
+
+	entry.indexStamp = CampaignCatalog::getFileStamp(indexPath);
+	entry.locationsStamp = CampaignCatalog::getFileStamp(locMetaPath);
+	entry.locationCnt = 0;
+
+	nlohmann::json root;
+	if (!loadJsonFromFile(root, indexPath))
+	{
+		entry.title = CONFUSION;
+		entry.description = CONFUSION;
+		return;
+	}
+
+	if (!parseJsonKey<std::string>(root, indexPath, FOERR_JSON_KEY_TITLE, entry.title))
+		entry.title = CONFUSION;
+
+	if (!parseJsonKey<std::string>(root, indexPath, FOERR_JSON_KEY_DESCRIPTION, entry.description))
+		entry.description = CONFUSION;
+
+	// errors will be reported when the campaign is loaded
+	root.clear();
+	if (!loadJsonFromFile(root, locMetaPath, true))
+		return;
+
+	auto locsSearch = root.find(FOERR_JSON_KEY_LOCATIONS);
+	if (locsSearch != root.end() && locsSearch->is_object())
+		entry.locationCnt = static_cast<std::uint32_t>(locsSearch->size());
+}
+
+/**
+ * Finds all installed campaigns and gets their infos. Campaigns which haven't changed since they were last scanned
+ * are not parsed again.
+ *
+ * @param known entries from the previous scan
+ * @param entries entries of all installed campaigns will be stored here, sorted by id
+ * @return true if any entry was added, removed or changed
+ */
+bool CampaignCatalog::scan(const std::vector<struct campaign_catalog_entry>& known,
+						   std::vector<struct campaign_catalog_entry>& entries)
+{
+	// directory_iterator outputs unsorted entries, use a set to sort them
+	std::set<std::string> sortedIds;
+
+	// campaigns can be either loose or archived (or both, if a loose campaign overrides some archived files)
+	AssetArchive::addSubdirNames(PATH_CAMPAIGNS, sortedIds);
+
+	std::error_code err;
+	for (const auto& entry : std::filesystem::directory_iterator(PATH_CAMPAIGNS, err))
+	{
+		if (!entry.is_directory())
+			continue;
+
+		sortedIds.insert(entry.path().stem().string());
+	}
+
+	std::unordered_map<std::string, const struct campaign_catalog_entry*> knownEntries;
+	for (const auto& entry : known)
+	{
+		knownEntries.emplace(entry.id, &entry);
+	}
+
+	bool changed = sortedIds.size() != known.size();
+
+	entries.clear();
+	for (const std::string& campaignId : sortedIds)
+	{
+		auto search = knownEntries.find(campaignId);
+		if (search != knownEntries.end())
+		{
+			const struct campaign_catalog_entry& knownEntry = *search->second;
+			struct file_stamp indexStamp =
+				CampaignCatalog::getFileStamp(pathCombine(PATH_CAMPAIGNS, campaignId, FILENAME_INDEX));
+			struct file_stamp locationsStamp =
+				CampaignCatalog::getFileStamp(pathCombine(PATH_CAMPAIGNS, campaignId, PATH_LOCATIONS_META));
+
+			if (indexStamp.exists == knownEntry.indexStamp.exists && indexStamp.size == knownEntry.indexStamp.size &&
+				indexStamp.mtime == knownEntry.indexStamp.mtime &&
+				locationsStamp.exists == knownEntry.locationsStamp.exists &&
+				locationsStamp.size == knownEntry.locationsStamp.size &&
+				locationsStamp.mtime == knownEntry.locationsStamp.mtime)
+			{
+				entries.push_back(knownEntry);
+				continue;
+			}
+		}
+
+		struct campaign_catalog_entry entry;
+		entry.id = campaignId;
+		CampaignCatalog::parseEntry(entry);
+		entries.push_back(entry);
+		changed = true;
+	}
+
+	return changed;
+}
+
+/**
+ * Writes the catalog to cache. Failing to write is not critical, campaigns will just be parsed again next time.
+ */
+void CampaignCatalog::save(const std::vector<struct campaign_catalog_entry>& entries)
+{
+	BinaryWriter writer;
+	writer.write(CAMPAIGN_CATALOG_MAGIC);
+	writer.write(CAMPAIGN_CATALOG_VERSION);
+	writer.write(static_cast<std::uint32_t>(entries.size()));
+
+	for (const auto& entry : entries)
+	{
+		CampaignCatalog::writeEntry(writer, entry);
+	}
+
+	const std::string cachePath = CampaignCatalog::getCachePath();
+	if (!writer.saveToFile(cachePath))
+		Log::w(STR_CAMPAIGN_CATALOG_WRITE_FAIL, cachePath.c_str());
+}
+
+/**
+ * Loads the catalog from cache. If the cache is missing or corrupted, campaigns are scanned right away, so that the
+ * catalog is never empty if any campaigns are installed.
+ *
+ * The catalog might be outdated, ::startRescan() should be called afterwards.
+ */
+void CampaignCatalog::load()
+{
+	this->entries.clear();
+
+	MappedFile cacheFile;
+	if (cacheFile.open(CampaignCatalog::getCachePath()))
+	{
+		BinaryReader reader(cacheFile.getData(), cacheFile.getSize());
+		std::uint32_t magic;
+		std::uint32_t version;
+		std::uint32_t entryCnt;
+		if (reader.read(magic) && magic == CAMPAIGN_CATALOG_MAGIC && reader.read(version) &&
+			version == CAMPAIGN_CATALOG_VERSION && reader.read(entryCnt))
+		{
+			// entries are read one by one, as the count might be corrupted
+			for (std::uint32_t i = 0; i < entryCnt; i++)
+			{
+				struct campaign_catalog_entry entry;
+				if (!CampaignCatalog::readEntry(reader, entry))
+				{
+					this->entries.clear();
+					break;
+				}
+
+				this->entries.push_back(entry);
+			}
+
+			if (!this->entries.empty())
+				return;
+		}
+	}
+
+	Log::d(STR_CAMPAIGN_CATALOG_SCANNING);
+
+	CampaignCatalog::scan({}, this->entries);
+	CampaignCatalog::save(this->entries);
+}
+
+/**
+ * Starts rescanning installed campaigns on a separate thread. Entries are updated in ::handleRescanFinished(). Does
+ * nothing if a rescan is already in progress.
+ */
+void CampaignCatalog::startRescan()
+{
+	if (this->isRescanning())
+		return;
+
+	if (this->rescanThread.joinable())
+		this->rescanThread.join();
+
+	this->rescanFinished = false;
+
+	// the thread works on its own copy of entries, results are only picked up after ::rescanFinished is set
+	this->rescanThread = std::thread(
+		[this, known = this->entries]()
+		{
+			std::vector<struct campaign_catalog_entry> scanned;
+			bool changed = CampaignCatalog::scan(known, scanned);
+			if (changed)
+				CampaignCatalog::save(scanned);
+
+			this->rescannedEntries = std::move(scanned);
+			this->rescanChanged = changed;
+			this->rescanFinished = true;
+		});
+}
+
+bool CampaignCatalog::isRescanning() const
+{
+	return this->rescanThread.joinable() && !this->rescanFinished;
+}
+
+/**
+ * Should be called periodically on the main thread. If a rescan has finished, entries are replaced with rescanned ones.
+ *
+ * @return true if entries have changed since the last call
+ */
+bool CampaignCatalog::handleRescanFinished()
+{
+	if (!this->rescanThread.joinable() || !this->rescanFinished)
+		return false;
+
+	this->rescanThread.join();
+
+	if (!this->rescanChanged)
+		return false;
+
+	this->entries = std::move(this->rescannedEntries);
+	this->rescannedEntries.clear();
+	return true;
+}
+
+const std::vector<struct campaign_catalog_entry>& CampaignCatalog::getEntries() const
+{
+	return this->entries;
+}
@@ -0,0 +1,81 @@
+// SPDX-License-Identifier: GPL-3.0-only
+//
+// (c) 2024 h67ma <szycikm@gmail.com>
+
+#pragma once
+
+#include <cstdint>
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../util/binary_stream.hpp"
+
+// cache files with a different magic or version are ignored (and overwritten)
+constexpr std::uint32_t CAMPAIGN_CATALOG_MAGIC = 0x43434F46; // "FOCC"
+constexpr std::uint32_t CAMPAIGN_CATALOG_VERSION = 1;
+
+// size and modification time of a file, see AssetArchive::getFileStamp()
+struct file_stamp
+{
+		std::uint64_t size = 0;
+		std::int64_t mtime = 0;
+		bool exists = false;
+};
+
+struct campaign_catalog_entry
+{
+		std::string id;
+		std::string title;
+		std::string description;
+		std::uint32_t locationCnt = 0;
+		struct file_stamp indexStamp;
+		struct file_stamp locationsStamp;
+};
+
+/**
+ * CampaignCatalog keeps basic infos (title, description, number of Locations) of all installed campaigns, so that they
+ * can be listed without parsing the index file of each campaign. The catalog is stored in the cache dir, and loaded
+ * instantly on startup.
+ *
+ * As campaigns can be added, removed or modified at any time, the catalog can be rescanned in the background (see
+ * ::startRescan()). Only campaigns with changed files (see struct file_stamp) are parsed again during a rescan.
+ *
+ * Cache file structure (native byte order):
+ *   - magic (uint32)
+ *   - version (uint32)
+ *   - entry count (uint32)
+ *   - entries (see ::writeEntry())
+ */
+class CampaignCatalog
+{
+	private:
+		std::vector<struct campaign_catalog_entry> entries; // sorted by id
+
+		std::thread rescanThread;
+		std::atomic<bool> rescanFinished = false;
+		std::vector<struct campaign_catalog_entry> rescannedEntries;
+		bool rescanChanged = false;
+
+		static std::string getCachePath();
+		static struct file_stamp getFileStamp(const std::string& path);
+		static bool readEntry(BinaryReader& reader, struct campaign_catalog_entry& entry);
+		static void writeEntry(BinaryWriter& writer, const struct campaign_catalog_entry& entry);
+		static void parseEntry(struct campaign_catalog_entry& entry);
+		static bool scan(const std::vector<struct campaign_catalog_entry>& known,
+						 std::vector<struct campaign_catalog_entry>& entries);
+		static void save(const std::vector<struct campaign_catalog_entry>& entries);
+
+	public:
+		CampaignCatalog() = default;
+		CampaignCatalog(const CampaignCatalog&) = delete;
+		CampaignCatalog& operator=(const CampaignCatalog&) = delete;
+		~CampaignCatalog();
+		void load();
+		void startRescan();
+		bool isRescanning() const;
+		bool handleRescanFinished();
+		const std::vector<struct campaign_catalog_entry>& getEntries() const;
+};
@@ -0,0 +1,92 @@
+// SPDX-License-Identifier: GPL-3.0-only
+//
+// (c) 2024 h67ma <szycikm@gmail.com>
+
+#include "cell_layer_mesh.hpp"
+
+#include <cstddef>
+
+#include <SFML/Graphics/PrimitiveType.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+#include <SFML/System/Vector2.hpp>
+
+bool CellLayerMesh::batched = true;
+
+sf::VertexArray& CellLayerMesh::getMesh(const sf::Texture* texture)
+{
+	for (auto& [meshTexture, mesh] : this->meshes)
+	{
+		if (meshTexture == texture)
+			return mesh;
+	}
+
+	this->meshes.emplace_back(texture, sf::VertexArray(sf::Quads));
+	return this->meshes.back().second;
+}
+
+/**
+ * Adds a textured quad to the mesh.
+ *
+ * @param texture texture of the quad. Textures which are not repeated must contain the whole textureRect
+ * @param area position and size of the quad, in Room coordinates
+ * @param textureRect part of the texture to show, in pixels. Negative width can be used to flip the texture
+ * horizontally (same as with sf::Sprite::setTextureRect())
+ * @param color color to modulate the texture with
+ */
+void CellLayerMesh::addQuad(const sf::Texture* texture, const sf::FloatRect& area, const sf::FloatRect& textureRect,
+							sf::Color color)
+{
+	sf::VertexArray& mesh = this->getMesh(texture);
+
+	const float right = area.left + area.width;
+	const float bottom = area.top + area.height;
+	const float txtRight = textureRect.left + textureRect.width;
+	const float txtBottom = textureRect.top + textureRect.height;
+
+	mesh.append(sf::Vertex({ area.left, area.top }, color, { textureRect.left, textureRect.top }));
+	mesh.append(sf::Vertex({ right, area.top }, color, { txtRight, textureRect.top }));
+	mesh.append(sf::Vertex({ right, bottom }, color, { txtRight, txtBottom }));
+	mesh.append(sf::Vertex({ area.left, bottom }, color, { textureRect.left, txtBottom }));
+}
+
+/**
+ * Adds a quad filled with solid color to the mesh.
+ *
+ * @param area position and size of the quad, in Room coordinates
+ * @param color fill color
+ */
+void CellLayerMesh::addQuad(const sf::FloatRect& area, sf::Color color)
+{
+	this->addQuad(nullptr, area, sf::FloatRect(), color);
+}
+
+/**
+ * Removes all quads, so that the mesh can be reused for another layer.
+ */
+void CellLayerMesh::clear()
+{
+	this->meshes.clear();
+}
+
+/**
+ * Draws the mesh with a single draw call per texture. If ::batched is unset, every quad is drawn with a separate draw
+ * call instead, as cells were drawn before they were batched. This is only meant for comparing both (see
+ * benchmark.cpp).
+ */
+void CellLayerMesh::draw(sf::RenderTarget& target, sf::RenderStates states) const
+{
+	for (const auto& [texture, mesh] : this->meshes)
+	{
+		states.texture = texture;
+		if (CellLayerMesh::batched)
+		{
+			target.draw(mesh, states);
+			continue;
+		}
+
+		for (std::size_t i = 0; i < mesh.getVertexCount(); i += 4)
+		{
+			target.draw(&mesh[i], 4, sf::Quads, states);
+		}
+	}
+}
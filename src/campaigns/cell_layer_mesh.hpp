@@ -0,0 +1,41 @@
+// SPDX-License-Identifier: GPL-3.0-only
+//
+// (c) 2024 h67ma <szycikm@gmail.com>
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include <SFML/Graphics/Color.hpp>
+#include <SFML/Graphics/Drawable.hpp>
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/Graphics/RenderStates.hpp>
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/Texture.hpp>
+#include <SFML/Graphics/VertexArray.hpp>
+
+/**
+ * A batch of textured quads making up a single layer of cells (e.g. all backgrounds of a Room), grouped by texture, so
+ * that the whole layer can be drawn with a single draw call per texture, instead of a draw call per cell.
+ *
+ * Quads using different textures can be drawn in a different order than they were added. This doesn't matter as long
+ * as quads in the same layer don't overlap, or overlap only with quads using the same texture.
+ */
+class CellLayerMesh : public sf::Drawable
+{
+	private:
+		// rooms only use a few materials, so a linear search is fast enough
+		std::vector<std::pair<const sf::Texture*, sf::VertexArray>> meshes;
+
+		sf::VertexArray& getMesh(const sf::Texture* texture);
+
+	public:
+		static bool batched; // see ::draw()
+
+		void addQuad(const sf::Texture* texture, const sf::FloatRect& area, const sf::FloatRect& textureRect,
+					 sf::Color color = sf::Color::White);
+		void addQuad(const sf::FloatRect& area, sf::Color color);
+		void clear();
+		void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+};
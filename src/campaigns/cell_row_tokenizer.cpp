@@ -0,0 +1,102 @@
+// SPDX-License-Identifier: GPL-3.0-only
+//
+// (c) 2024 h67ma <szycikm@gmail.com>
+
+#include "cell_row_tokenizer.hpp"
+
+#if defined(__AVX2__)
+#define FOERR_TOKENIZER_AVX2
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FOERR_TOKENIZER_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/**
+ * @return index of the lowest set bit in a non-zero mask
+ */
+static inline uint countTrailingZeros(std::uint32_t mask)
+{
+#if defined(_MSC_VER)
+	unsigned long idx;
+	_BitScanForward(&idx, mask);
+	return static_cast<uint>(idx);
+#else
+	return static_cast<uint>(__builtin_ctz(mask));
+#endif
+}
+
+/**
+ * Marks the end of the current cell at separator position (or end of the row) and starts a new cell after it.
+ */
+static inline void endCell(struct cell_row_tokens& tokens, std::size_t& cellBegin, std::size_t pos)
+{
+	if (tokens.cellCnt < ROOM_WIDTH_WITH_BORDER)
+	{
+		tokens.cellBegins[tokens.cellCnt] = static_cast<std::uint32_t>(cellBegin);
+		tokens.cellEnds[tokens.cellCnt] = static_cast<std::uint32_t>(pos);
+	}
+
+	tokens.cellCnt++;
+	cellBegin = pos + 1;
+}
+
+/**
+ * Splits a row of room cell data into cells, i.e. finds all separators in the row (see Room::load() for data format).
+ *
+ * Separators are searched for in blocks of 32 (AVX2) or 16 (SSE2) characters at once, depending on what the game was
+ * compiled for, and the rest of the row is searched one character at a time. Cells are at most a few characters long,
+ * so most blocks contain multiple separators, which are then read from the comparison mask without branching on each
+ * character.
+ *
+ * @param row row data
+ * @param len length of row data
+ * @param tokens cell positions will be stored here
+ */
+void tokenizeCellRow(const char* row, std::size_t len, struct cell_row_tokens& tokens)
+{
+	std::size_t cellBegin = 0;
+	std::size_t i = 0;
+
+	tokens.cellCnt = 0;
+
+#if defined(FOERR_TOKENIZER_AVX2)
+	const __m256i separators = _mm256_set1_epi8(ROOM_SYMBOL_SEPARATOR);
+	for (; i + sizeof(__m256i) <= len; i += sizeof(__m256i))
+	{
+		__m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + i));
+		std::uint32_t mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, separators)));
+		while (mask != 0)
+		{
+			endCell(tokens, cellBegin, i + countTrailingZeros(mask));
+			mask &= mask - 1; // clear lowest set bit
+		}
+	}
+#elif defined(FOERR_TOKENIZER_SSE2)
+	const __m128i separators = _mm_set1_epi8(ROOM_SYMBOL_SEPARATOR);
+	for (; i + sizeof(__m128i) <= len; i += sizeof(__m128i))
+	{
+		__m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i));
+		std::uint32_t mask = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, separators)));
+		while (mask != 0)
+		{
+			endCell(tokens, cellBegin, i + countTrailingZeros(mask));
+			mask &= mask - 1; // clear lowest set bit
+		}
+	}
+#endif
+
+	// rest of the row (or the whole row, if SIMD is not available)
+	for (; i < len; i++)
+	{
+		if (row[i] == ROOM_SYMBOL_SEPARATOR)
+			endCell(tokens, cellBegin, i);
+	}
+
+	// last cell is not followed by a separator
+	endCell(tokens, cellBegin, len);
+}
@@ -0,0 +1,68 @@
+// SPDX-License-Identifier: GPL-3.0-only
+//
+// (c) 2024 h67ma <szycikm@gmail.com>
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <array>
+
+#include "../consts.hpp"
+#include "room_template.hpp"
+
+constexpr char ROOM_SYMBOL_SEPARATOR = '|';
+constexpr char ROOM_SYMBOL_EMPTY = '_';
+constexpr char ROOM_SYMBOL_UNKNOWN = '?';
+constexpr char ROOM_SYMBOL_HEIGHT_3_4 = ',';
+constexpr char ROOM_SYMBOL_HEIGHT_1_2 = ';';
+constexpr char ROOM_SYMBOL_HEIGHT_1_4 = ':';
+
+enum CellSymbolClass : uchar
+{
+	CELL_SYMBOL_MATERIAL, // any symbol which isn't special, needs to be looked up in Material Manager
+	CELL_SYMBOL_SEPARATOR,
+	CELL_SYMBOL_EMPTY,
+	CELL_SYMBOL_UNKNOWN,
+	CELL_SYMBOL_HEIGHT_FLAG,
+};
+
+/**
+ * Builds a table containing the class of each possible symbol, so that symbols can be classified with a single lookup
+ * instead of a chain of comparisons.
+ */
+constexpr std::array<enum CellSymbolClass, 256> makeCellSymbolClasses()
+{
+	std::array<enum CellSymbolClass, 256> classes {}; // CELL_SYMBOL_MATERIAL
+
+	classes[static_cast<uchar>(ROOM_SYMBOL_SEPARATOR)] = CELL_SYMBOL_SEPARATOR;
+	classes[static_cast<uchar>(ROOM_SYMBOL_EMPTY)] = CELL_SYMBOL_EMPTY;
+	classes[static_cast<uchar>(ROOM_SYMBOL_UNKNOWN)] = CELL_SYMBOL_UNKNOWN;
+	classes[static_cast<uchar>(ROOM_SYMBOL_HEIGHT_3_4)] = CELL_SYMBOL_HEIGHT_FLAG;
+	classes[static_cast<uchar>(ROOM_SYMBOL_HEIGHT_1_2)] = CELL_SYMBOL_HEIGHT_FLAG;
+	classes[static_cast<uchar>(ROOM_SYMBOL_HEIGHT_1_4)] = CELL_SYMBOL_HEIGHT_FLAG;
+
+	return classes;
+}
+
+constexpr std::array<enum CellSymbolClass, 256> CELL_SYMBOL_CLASSES = makeCellSymbolClasses();
+
+constexpr enum CellSymbolClass getCellSymbolClass(char symbol)
+{
+	return CELL_SYMBOL_CLASSES[static_cast<uchar>(symbol)];
+}
+
+/**
+ * Positions of cells in a single row of room cell data (see Room::load()). Symbols of cell x are in
+ * [cellBegins[x], cellEnds[x]) range of the row. Only positions of the first ROOM_WIDTH_WITH_BORDER cells are stored,
+ * but all cells are counted.
+ */
+struct cell_row_tokens
+{
+		std::size_t cellCnt = 0;
+		std::uint32_t cellBegins[ROOM_WIDTH_WITH_BORDER];
+		std::uint32_t cellEnds[ROOM_WIDTH_WITH_BORDER];
+};
+
+void tokenizeCellRow(const char* row, std::size_t len, struct cell_row_tokens& tokens);
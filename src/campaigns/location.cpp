@@ -4,15 +4,36 @@
 
 #include "location.hpp"
 
+#include <climits>
+#include <cstdint>
+#include <cstdlib>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <initializer_list>
 #include <memory>
 #include <string>
+#include <system_error>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include <SFML/Graphics/RenderTexture.hpp>
 
 #include "../hud/log.hpp"
+#include "../resources/asset_archive.hpp"
 #include "../settings/settings_manager.hpp"
+#include "../util/binary_stream.hpp"
 #include "../util/i18n.hpp"
 #include "../util/json.hpp"
+#include "../util/load_progress.hpp"
+#include "../util/mapped_file.hpp"
+#include "../util/parallel.hpp"
+#include "../util/random.hpp"
+#include "../util/util.hpp"
+#include "rooms_sax_handler.hpp"
 
 constexpr int LOC_WORLDMAP_MAX = 600; // max x/y coordinate of worldmap icons
 
@@ -20,6 +41,14 @@ constexpr float PLAYER_NEW_ROOM_OFFSET_H = 60;
 constexpr float PLAYER_NEW_ROOM_OFFSET_V_TOP = 40;
 constexpr float PLAYER_NEW_ROOM_OFFSET_V_BOTTOM = 80; // platform jump
 
+// how long Rooms can be baked for on a single frame, see Location::bakeNearRoom(). a single bake stage can take longer
+constexpr std::int64_t ROOM_BAKE_BUDGET_US = 4000;
+
+// compiled rooms files with a different version are ignored. bump this when changing the format of compiled rooms, or
+// when changing how rooms are parsed from json (e.g. new keys)
+constexpr std::uint32_t COMPILED_ROOMS_MAGIC = 0x52524F46; // "FORR"
+constexpr std::uint32_t COMPILED_ROOMS_VERSION = 2;
+
 constexpr uint ROOM_BORDER_LEFT_X = 0;
 constexpr uint ROOM_BORDER_LEFT_INNER_X = 1;
 constexpr uint ROOM_BORDER_RIGHT_X = ROOM_WIDTH_WITH_BORDER - 1;
@@ -114,6 +143,16 @@ bool Location::loadMeta(const nlohmann::json& locMetaNode, const std::string& ca
  *
  * In case when loading fails, all previously allocated rooms will be automatically deallocated.
  *
+ * If the compiled (binary) version of the rooms file is up to date, rooms are loaded from it instead of the json file.
+ * Otherwise, the json file is loaded and the compiled file is regenerated (see ::openCompiledRooms()).
+ *
+ * When SettingsManager::maxLoadedRooms is set (and the compiled file is available), only the start Room is loaded
+ * here. Other Rooms will be loaded when they are needed (see ::updateLoadedRooms()).
+ *
+ * Content which is already loaded is unloaded first. Rooms of such content could have been baked, and their render
+ * caches must be destroyed on the main thread, so when loading on another thread, content should be unloaded on the
+ * main thread beforehand (see Campaign::changeLocationAsync()).
+ *
  * Rooms file structure:
  * {
  *	"api_version": 1,
@@ -129,71 +168,515 @@ bool Location::loadMeta(const nlohmann::json& locMetaNode, const std::string& ca
  * @param resMgr reference to Resource Manager object
  * @param matMgr reference to Material Manager object
  * @param objMgr reference to Object Manager object
+ * @param roomTemplates reference to cache of room templates, shared between Locations of the Campaign
  * @returns true if load succeeded
  * @returns false if load failed
  */
-bool Location::loadContent(ResourceManager& resMgr, const MaterialManager& matMgr, const ObjectManager& objMgr)
+bool Location::loadContent(ResourceManager& resMgr, const MaterialManager& matMgr, const ObjectManager& objMgr,
+						   RoomTemplateCache& roomTemplates)
 {
-	std::string backgroundFullPath;
-	nlohmann::json root;
+	HashableVector3i startRoomCoords;
 
 	this->unloadContent();
 
 	Log::v(STR_LOADING_LOCATION_CONTENT, this->id.c_str());
+	resMgr.forgetMissingTextures();
+
+	// a new set of Rooms is mirrored every time the Location is loaded
+	if (this->grind)
+		this->mirrorSeed = static_cast<std::uint64_t>(Randomizer::getRandomBetween(0, INT_MAX));
+
+	std::uint64_t compiledKey;
+	bool canUseCompiled = this->getCompiledRoomsKey(compiledKey);
+	bool streamRooms = SettingsManager::maxLoadedRooms > 0;
+	bool loaded = false;
+
+	if (canUseCompiled && this->openCompiledRooms(compiledKey, startRoomCoords))
+	{
+		if (streamRooms)
+		{
+			std::shared_ptr<Room> startRoom = this->loadCompiledRoom(startRoomCoords, resMgr, matMgr, objMgr,
+																	 roomTemplates);
+			if (startRoom != nullptr)
+			{
+				this->rooms.set(startRoomCoords, startRoom);
+				loaded = true;
+			}
+		}
+		else
+		{
+			loaded = this->loadAllCompiledRooms(resMgr, matMgr, objMgr, roomTemplates);
+		}
+
+		if (loaded && !this->backgroundFullPath.empty())
+			this->setupBackgroundFull(resMgr);
+
+		// if something went wrong, just load from json
+		if (!loaded)
+			this->unloadContent();
+	}
+
+	if (!loaded)
+	{
+		// when Rooms are streamed, only the start Room is kept while loading, the rest is loaded from the compiled
+		// rooms file when needed
+		room_table roomTable;
+		bool keepAllRooms = !canUseCompiled || !streamRooms;
+		if (!this->loadJsonRooms(resMgr, matMgr, objMgr, roomTemplates, startRoomCoords, roomTable, keepAllRooms))
+			return false;
+
+		if (canUseCompiled)
+		{
+			this->writeCompiledRooms(compiledKey, startRoomCoords, roomTable);
+
+			// if the file can't be opened, all rooms are loaded again, and will just stay loaded
+			if (streamRooms && !this->openCompiledRooms(compiledKey, startRoomCoords))
+			{
+				this->unloadContent();
+				roomTable.clear();
+				if (!this->loadJsonRooms(resMgr, matMgr, objMgr, roomTemplates, startRoomCoords, roomTable, true))
+					return false;
+			}
+		}
+	}
+
+	this->resMgr = &resMgr;
+
+	if (streamRooms && !this->compiledRoomsIndex.empty())
+	{
+		this->roomStreamer.start(
+			[this, &resMgr, &matMgr, &objMgr, &roomTemplates](const HashableVector3i& coords)
+			{
+				std::shared_ptr<Room> room = this->loadCompiledRoom(coords, resMgr, matMgr, objMgr, roomTemplates);
+				if (room != nullptr)
+					this->restoreRoomState(coords, *room, resMgr, objMgr);
+
+				return room;
+			});
+	}
+	else
+	{
+		// not needed anymore
+		this->closeCompiledRooms();
+	}
 
-	if (!loadJsonFromFile(root, this->roomDataPath))
+	// enter the starting room
+	this->currentRoom = this->rooms.moveTo(startRoomCoords);
+	if (this->currentRoom == nullptr)
+	{
+		Log::e(STR_ROOM_MISSING_COORDS, this->roomDataPath.c_str(), startRoomCoords.x, startRoomCoords.y,
+			   startRoomCoords.z);
+		this->unloadContent();
 		return false;
+	}
 
-	// not present -> black background
-	if (parseJsonKey<std::string>(root, this->roomDataPath, FOERR_JSON_KEY_BACKGROUND_FULL, backgroundFullPath, true))
+	// the current Room is baked later, on the main thread (see ::bakeCurrentRoom())
+	this->updateLoadedRooms();
+	resMgr.reportMissingTextures(this->roomDataPath);
+
+	// more expensive checks (e.g. reachability of all rooms) are only done when validating the Location offline, see
+	// ::validateContent()
+
+	Log::v(STR_LOADED_LOCATION_CONTENT, this->roomDataPath.c_str());
+	return true;
+}
+
+/**
+ * Validates Location content without entering it, e.g. to check all Locations of a Campaign before shipping it. All
+ * Rooms are loaded from the json file (even if a compiled file is available), which includes all checks done when
+ * loading the Location normally (e.g. Room geometry). Nothing is drawn, so this can be used without a window (see
+ * ResourceManager headless mode). Content is unloaded afterwards.
+ *
+ * Additionally, rooms which can't be reached from the start Room are found. Unreachable Rooms don't make the Location
+ * invalid, as they might be intentional (e.g. sections reachable only via teleportation).
+ *
+ * Errors are logged. Multiple Locations can be validated at the same time.
+ *
+ * TODO more checks, when the game will have the required objects:
+ * - at least one MAS terminal
+ * - [grind maps only] at least one exit
+ * - all doors/vents/etc must have a counterpart in another room, so that all passages actually lead to other rooms
+ *
+ * @param result validation result will be stored here
+ * @returns true if the Location is valid
+ * @returns false if the Location is invalid
+ */
+bool Location::validateContent(ResourceManager& resMgr, const MaterialManager& matMgr, const ObjectManager& objMgr,
+							   RoomTemplateCache& roomTemplates, struct location_validation& result)
+{
+	this->unloadContent();
+
+	HashableVector3i startRoomCoords;
+	room_table roomTable;
+	result.valid = this->loadJsonRooms(resMgr, matMgr, objMgr, roomTemplates, startRoomCoords, roomTable, true);
+	result.roomCnt = this->rooms.size();
+
+	// note: same as geometry, reachability is only checked for unique (non-grind) locations, as passages of grind
+	// rooms can change with mirroring
+	if (result.valid && !this->grind)
+		result.unreachableRooms = this->findUnreachableRooms(startRoomCoords);
+
+	this->unloadContent();
+	return result.valid;
+}
+
+/**
+ * Loads rooms and big background from the rooms json file (see ::loadContent() for file structure).
+ *
+ * Only the first Room with given content is actually loaded from json. Rooms identical to an already loaded Room (in
+ * this or any other Location) are set up from its template (see RoomTemplate).
+ *
+ * All Rooms need to be loaded in order to be validated, but only their templates and collider Cells are needed
+ * afterwards (see ::writeCompiledRooms() and ::validateRoomGeometry()). So if not all Rooms should be kept loaded, each
+ * Room (except the start Room) is unloaded right after it's loaded, and memory used doesn't depend on Location size.
+ *
+ * @param startRoomCoords coordinates of the start room will be stored here
+ * @param roomTable coordinates and templates of all Rooms will be stored here
+ * @param keepAllRooms true if all Rooms should be kept loaded, false if only the start Room should be kept
+ * @returns true if load succeeded
+ * @returns false if load failed
+ */
+bool Location::loadJsonRooms(ResourceManager& resMgr, const MaterialManager& matMgr, const ObjectManager& objMgr,
+							 RoomTemplateCache& roomTemplates, HashableVector3i& startRoomCoords, room_table& roomTable,
+							 bool keepAllRooms)
+{
+	// archived rooms file is parsed straight from the archive mapping
+	const char* archivedData;
+	std::size_t archivedSize;
+	bool archived = AssetArchive::getFile(this->roomDataPath, archivedData, archivedSize);
+
+	std::ifstream reader;
+	if (!archived)
 	{
-		backgroundFullPath = pathCombine(PATH_BACKGROUNDS_FULL, backgroundFullPath + ".png");
-		this->backgroundFullSprite.setTexture(resMgr.getTexture(backgroundFullPath));
+		reader.open(this->roomDataPath);
+		if (!reader.is_open())
+		{
+			Log::e(STR_FILE_OPEN_ERROR, this->roomDataPath.c_str());
+			return false;
+		}
 	}
 
+	// the file is streamed, and rooms are loaded in batches as soon as enough room nodes are parsed. this way only a
+	// few room nodes are kept in memory at any time, while rooms in a batch are still loaded in parallel.
+	// the cheap checks (coordinates, duplicates, start room) are done right away on this thread, in the same order as
+	// rooms are defined in the file.
+	const std::size_t batchSize = getParallelThreadCnt();
+	std::vector<nlohmann::json> batchNodes;
+	std::vector<HashableVector3i> batchCoords;
+	std::vector<std::uint64_t> batchHashes;
+	std::vector<std::shared_ptr<Room>> batchRooms;
+	std::vector<std::vector<struct log_message>> batchMessages; // held back until the batch is loaded
+	room_colliders_map colliders;
+	bool foundStart = false;
+
+	auto loadBatch = [this, &resMgr, &matMgr, &objMgr, &roomTemplates, &startRoomCoords, &roomTable, &keepAllRooms,
+					  &batchNodes, &batchCoords, &batchHashes, &batchRooms, &batchMessages, &colliders, &foundStart]()
+	{
+		if (this->isLoadCancelled())
+			return false;
+
+		// rooms with a template already in use (or with the same content as a room earlier in the batch) are only
+		// instantiated after the rest of the batch is loaded, so that each template is parsed exactly once
+		std::vector<std::size_t> toLoad;
+		std::vector<std::size_t> toInstantiate;
+		std::unordered_set<std::uint64_t> loadedHashes;
+		for (std::size_t i = 0; i < batchRooms.size(); i++)
+		{
+			if (loadedHashes.count(batchHashes[i]) == 0 && roomTemplates.get(batchHashes[i]) == nullptr)
+			{
+				loadedHashes.insert(batchHashes[i]);
+				toLoad.push_back(i);
+			}
+			else
+			{
+				toInstantiate.push_back(i);
+			}
+		}
+
+		// rooms finish loading in any order, so messages of each room (starting with ones from the cheap checks) are
+		// held back, and then logged in the same order as rooms are defined in the file. only messages up to the first
+		// room which failed to load are logged, same as if the rooms were loaded one by one
+		std::vector<std::vector<struct log_message>>& messages = batchMessages;
+		std::vector<char> failed(batchRooms.size(), false);
+
+		// each room only touches its own data during load, and managers are either read-only or thread-safe
+		// (Resource Manager, template cache). if any room fails to load, rooms after it won't be loaded.
+		parallelFor(toLoad.size(),
+					[this, &resMgr, &matMgr, &objMgr, &batchNodes, &batchCoords, &batchHashes, &batchRooms, &toLoad,
+					 &messages, &failed](std::size_t idx)
+					{
+						std::size_t i = toLoad[idx];
+						Log::startCapture(messages[i]);
+						failed[i] = !batchRooms[i]->load(resMgr, matMgr, objMgr, batchNodes[i], this->roomDataPath,
+														 batchHashes[i], this->isRoomMirrored(batchCoords[i]));
+						Log::stopCapture();
+						return !failed[i];
+					});
+
+		const std::size_t firstLoadFail =
+			std::find(failed.begin(), failed.end(), static_cast<char>(true)) - failed.begin();
+
+		for (std::size_t i : toLoad)
+		{
+			if (i < firstLoadFail)
+				roomTemplates.add(batchRooms[i]->getTemplate());
+		}
+
+		// rooms before the first failed one can still be instantiated, as their templates were loaded by rooms even
+		// earlier in the file (or in a previous batch)
+		while (!toInstantiate.empty() && toInstantiate.back() > firstLoadFail)
+		{
+			toInstantiate.pop_back();
+		}
+
+		parallelFor(toInstantiate.size(),
+					[this, &resMgr, &matMgr, &objMgr, &roomTemplates, &batchCoords, &batchHashes, &batchRooms,
+					 &toInstantiate, &messages, &failed](std::size_t idx)
+					{
+						std::size_t i = toInstantiate[idx];
+						std::shared_ptr<const RoomTemplate> roomTemplate = roomTemplates.get(batchHashes[i]);
+						Log::startCapture(messages[i]);
+						failed[i] = roomTemplate == nullptr ||
+									!batchRooms[i]->instantiate(roomTemplate, resMgr, matMgr, objMgr,
+																this->isRoomMirrored(batchCoords[i]));
+						Log::stopCapture();
+						return !failed[i];
+					});
+
+		bool loaded = true;
+		for (std::size_t i = 0; i < batchRooms.size() && loaded; i++)
+		{
+			Log::replay(messages[i]);
+			loaded = !failed[i];
+		}
+
+		for (std::size_t i = 0; i < batchRooms.size() && loaded; i++)
+		{
+			colliders.emplace(batchCoords[i], batchRooms[i]->getColliders());
+			roomTable.emplace_back(batchCoords[i], batchRooms[i]->getTemplate());
+
+			if (!keepAllRooms && !(foundStart && batchCoords[i] == startRoomCoords))
+				this->rooms.remove(batchCoords[i]);
+		}
+
+		LoadProgress::getCurrent()->addRoomsParsed(batchRooms.size());
+
+		batchNodes.clear();
+		batchCoords.clear();
+		batchHashes.clear();
+		batchRooms.clear();
+		batchMessages.clear();
+		return loaded;
+	};
+
+	auto checkRoom = [this, &startRoomCoords, &colliders, &foundStart](nlohmann::json& roomNode,
+																		HashableVector3i& roomCoords)
+	{
+		if (!parseJsonVector3iKey(roomNode, this->roomDataPath, FOERR_JSON_KEY_COORDS, roomCoords))
+			return false;
+
+		// rooms which were already loaded might have been unloaded right after
+		if (this->rooms.get(roomCoords) != nullptr || colliders.find(roomCoords) != colliders.end())
+		{
+			Log::e(STR_DUPLICATE_ROOM_IN_SAME_COORDS, this->roomDataPath.c_str(), roomCoords.x, roomCoords.y,
+				   roomCoords.z);
+			return false;
+		}
+
+		bool thisStart = false;
+		parseJsonKey<bool>(roomNode, this->roomDataPath, FOERR_JSON_KEY_IS_START, thisStart, true);
+
+		// check if exactly one room is marked as start room
+		if (thisStart)
+		{
+			if (foundStart)
+			{
+				Log::e(STR_DUPLICATE_START_ROOM, this->roomDataPath.c_str(), roomCoords.x, roomCoords.y, roomCoords.z);
+				return false;
+			}
+
+			startRoomCoords = roomCoords;
+			foundStart = true;
+		}
+
+		return true;
+	};
+
+	auto onRoomParsed = [this, &batchSize, &batchNodes, &batchCoords, &batchHashes, &batchRooms, &batchMessages,
+						 &checkRoom, &loadBatch](nlohmann::json& roomNode)
+	{
+		HashableVector3i roomCoords;
+		std::vector<struct log_message> checkMessages;
+
+		Log::startCapture(checkMessages);
+		bool valid = checkRoom(roomNode, roomCoords);
+		Log::stopCapture();
+
+		if (!valid)
+		{
+			// rooms earlier in the file are still waiting in the batch, they need to be loaded first, so that their
+			// errors are logged before this one
+			if (loadBatch())
+				Log::replay(checkMessages);
+
+			return false;
+		}
+
+		std::shared_ptr<Room> room =
+			std::make_shared<Room>(this->player, RoomBackCache::getCacheId(this->roomDataPath, roomCoords));
+
+		// the room might not be loaded yet, but it's fine to put it in the grid already, as nothing will use it until
+		// all rooms are loaded. this way the grid also serves as a duplicate coords check.
+		this->rooms.set(roomCoords, room);
+		batchCoords.push_back(roomCoords);
+		batchHashes.push_back(RoomTemplate::getJsonHash(roomNode));
+		batchNodes.push_back(std::move(roomNode));
+		batchRooms.push_back(room);
+		batchMessages.push_back(std::move(checkMessages));
+
+		if (batchRooms.size() < batchSize)
+			return true;
+
+		return loadBatch();
+	};
+
+	RoomsSaxHandler handler(this->roomDataPath, onRoomParsed);
+	bool parsed = archived ? nlohmann::json::sax_parse(archivedData, archivedData + archivedSize, &handler,
+													   nlohmann::json::input_format_t::json, true, true) :
+							 nlohmann::json::sax_parse(reader, &handler, nlohmann::json::input_format_t::json, true,
+													   true);
+	if (!parsed || !loadBatch())
+	{
+		this->unloadContent();
+		return false;
+	}
+
+	reader.close();
+
+	std::error_code err;
+	std::uintmax_t fileSize = archived ? archivedSize : std::filesystem::file_size(this->roomDataPath, err);
+	if (!err)
+		LoadProgress::getCurrent()->addBytesRead(fileSize);
+
+	Log::v(STR_LOADED_FILE, this->roomDataPath.c_str());
+
+	// root contains everything except room nodes, which were already processed
+	const nlohmann::json& root = handler.getRoot();
+	checkJsonApiVersion(root, this->roomDataPath);
+
 	auto roomsSearch = root.find(FOERR_JSON_KEY_ROOMS);
 	if (roomsSearch == root.end())
 	{
 		Log::e(STR_MISSING_KEY, this->roomDataPath.c_str(), FOERR_JSON_KEY_ROOMS.c_str());
+		this->unloadContent();
 		return false;
 	}
 
 	if (!roomsSearch->is_array())
 	{
 		Log::e(STR_INVALID_TYPE, this->roomDataPath.c_str(), FOERR_JSON_KEY_ROOMS.c_str());
+		this->unloadContent();
 		return false;
 	}
 
-	// TODO this is a prime candidate for parallelization - run N threads, each gets a few rooms
-	bool foundStart = false;
-	HashableVector3i startRoomCoords;
-	for (const auto& roomNode : (*roomsSearch))
+	if (!foundStart)
 	{
-		HashableVector3i roomCoords;
-		if (!parseJsonVector3iKey(roomNode, this->roomDataPath, FOERR_JSON_KEY_COORDS, roomCoords))
+		// also covers the case where we have zero rooms
+		Log::e(STR_MISSING_START_ROOM, this->roomDataPath.c_str());
+		this->unloadContent();
+		return false;
+	}
+
+	// not present -> black background
+	if (parseJsonKey<std::string>(root, this->roomDataPath, FOERR_JSON_KEY_BACKGROUND_FULL, this->backgroundFullPath,
+								  true))
+	{
+		this->backgroundFullPath = pathCombine(PATH_BACKGROUNDS_FULL, this->backgroundFullPath + ".png");
+		this->setupBackgroundFull(resMgr);
+	}
+
+	// note: we only validate geometry for unique (non-grind) locations
+	if (!this->grind)
+	{
+		// all rooms are loaded at this point, so colliders are only read from
+		bool valid = parallelFor(roomTable.size(), [&roomTable, &colliders](std::size_t idx)
+								 { return validateRoomGeometry(roomTable[idx].first, colliders); });
+
+		if (!valid)
 		{
 			this->unloadContent();
 			return false;
 		}
+	}
 
-		if (this->rooms.get(roomCoords) != nullptr)
+	return true;
+}
+
+/**
+ * Reloads Rooms after the rooms json file was edited. Rooms are compared with the loaded ones by coordinates and
+ * content hash (see RoomTemplate::getJsonHash()), and only Rooms which were added or changed are loaded again. Rooms
+ * which were removed from the file are removed from the Location.
+ *
+ * If the current Room still exists, the Player stays where they are (the Room is set up again if it changed).
+ * Otherwise, the Player is moved to the start Room.
+ *
+ * If Rooms were streamed from the compiled rooms file, streaming is stopped, as the compiled file is now out of date.
+ * All Rooms are then kept loaded, until the Location is loaded again (which also regenerates the compiled file).
+ *
+ * If reloading fails, the Location is left unchanged.
+ *
+ * @returns true if reload succeeded
+ * @returns false if reload failed
+ */
+bool Location::reloadChangedRooms(ResourceManager& resMgr, const MaterialManager& matMgr, const ObjectManager& objMgr,
+								  RoomTemplateCache& roomTemplates)
+{
+	if (this->currentRoom == nullptr)
+		return false;
+
+	std::ifstream reader(this->roomDataPath);
+	if (!reader.is_open())
+	{
+		Log::e(STR_FILE_OPEN_ERROR, this->roomDataPath.c_str());
+		return false;
+	}
+
+	// streaming has to be stopped before looking at which Rooms are loaded, otherwise more could appear in the meantime
+	if (this->roomStreamer.isRunning())
+	{
+		this->collectStreamedRooms();
+		this->roomStreamer.stop();
+		this->closeCompiledRooms();
+	}
+
+	std::unordered_set<HashableVector3i, Vector3Hasher<int>> fileCoords;
+	std::vector<nlohmann::json> changedNodes;
+	std::vector<HashableVector3i> changedCoords;
+	std::vector<std::uint64_t> changedHashes;
+	HashableVector3i startRoomCoords;
+	bool foundStart = false;
+
+	auto onRoomParsed = [this, &fileCoords, &changedNodes, &changedCoords, &changedHashes, &startRoomCoords,
+						 &foundStart](nlohmann::json& roomNode)
+	{
+		HashableVector3i roomCoords;
+		if (!parseJsonVector3iKey(roomNode, this->roomDataPath, FOERR_JSON_KEY_COORDS, roomCoords))
+			return false;
+
+		if (!fileCoords.insert(roomCoords).second)
 		{
 			Log::e(STR_DUPLICATE_ROOM_IN_SAME_COORDS, this->roomDataPath.c_str(), roomCoords.x, roomCoords.y,
 				   roomCoords.z);
-			this->unloadContent();
 			return false;
 		}
 
 		bool thisStart = false;
 		parseJsonKey<bool>(roomNode, this->roomDataPath, FOERR_JSON_KEY_IS_START, thisStart, true);
-
-		// check if exactly one room is marked as start room
 		if (thisStart)
 		{
 			if (foundStart)
 			{
 				Log::e(STR_DUPLICATE_START_ROOM, this->roomDataPath.c_str(), roomCoords.x, roomCoords.y, roomCoords.z);
-				this->unloadContent();
 				return false;
 			}
 
@@ -201,65 +684,566 @@ bool Location::loadContent(ResourceManager& resMgr, const MaterialManager& matMg
 			foundStart = true;
 		}
 
-		std::shared_ptr<Room> room = std::make_shared<Room>(this->player);
+		std::uint64_t hash = RoomTemplate::getJsonHash(roomNode);
+		const std::shared_ptr<Room> oldRoom = this->rooms.get(roomCoords);
+		if (oldRoom != nullptr && oldRoom->getTemplate()->getHash() == hash)
+			return true; // unchanged, no need to keep the node
+
+		changedCoords.push_back(roomCoords);
+		changedHashes.push_back(hash);
+		changedNodes.push_back(std::move(roomNode));
+		return true;
+	};
+
+	RoomsSaxHandler handler(this->roomDataPath, onRoomParsed);
+	if (!nlohmann::json::sax_parse(reader, &handler, nlohmann::json::input_format_t::json, true, true))
+		return false;
+
+	if (!foundStart)
+	{
+		Log::e(STR_MISSING_START_ROOM, this->roomDataPath.c_str());
+		return false;
+	}
+
+	// rooms with a template already in use are only instantiated, same as in ::loadJsonRooms()
+	std::vector<std::shared_ptr<Room>> changedRooms;
+	std::vector<std::size_t> toLoad;
+	std::vector<std::size_t> toInstantiate;
+	std::unordered_set<std::uint64_t> loadedHashes;
+	for (std::size_t i = 0; i < changedNodes.size(); i++)
+	{
+		changedRooms.push_back(
+			std::make_shared<Room>(this->player, RoomBackCache::getCacheId(this->roomDataPath, changedCoords[i])));
+
+		if (loadedHashes.count(changedHashes[i]) == 0 && roomTemplates.get(changedHashes[i]) == nullptr)
+		{
+			loadedHashes.insert(changedHashes[i]);
+			toLoad.push_back(i);
+		}
+		else
+		{
+			toInstantiate.push_back(i);
+		}
+	}
+
+	bool loaded = parallelFor(toLoad.size(),
+							  [this, &resMgr, &matMgr, &objMgr, &changedNodes, &changedCoords, &changedHashes,
+							   &changedRooms, &toLoad](std::size_t idx)
+							  {
+								  std::size_t i = toLoad[idx];
+								  return changedRooms[i]->load(resMgr, matMgr, objMgr, changedNodes[i],
+															   this->roomDataPath, changedHashes[i],
+															   this->isRoomMirrored(changedCoords[i]));
+							  });
+	if (!loaded)
+		return false;
+
+	for (std::size_t i : toLoad)
+	{
+		roomTemplates.add(changedRooms[i]->getTemplate());
+	}
+
+	loaded = parallelFor(toInstantiate.size(),
+						 [this, &resMgr, &matMgr, &objMgr, &roomTemplates, &changedCoords, &changedHashes,
+						  &changedRooms, &toInstantiate](std::size_t idx)
+						 {
+							 std::size_t i = toInstantiate[idx];
+							 std::shared_ptr<const RoomTemplate> roomTemplate = roomTemplates.get(changedHashes[i]);
+							 return roomTemplate != nullptr &&
+									changedRooms[i]->instantiate(roomTemplate, resMgr, matMgr, objMgr,
+																 this->isRoomMirrored(changedCoords[i]));
+						 });
+	if (!loaded)
+		return false;
+
+	// apply changes to the grid, remembering replaced Rooms, so that changes can be reverted if validation fails
+	std::vector<std::pair<HashableVector3i, std::shared_ptr<Room>>> replaced;
+	for (const auto& entry : this->rooms)
+	{
+		if (fileCoords.find(entry.first) == fileCoords.end())
+			replaced.emplace_back(entry.first, entry.second);
+	}
+
+	std::size_t removedCnt = replaced.size();
+	for (const auto& entry : replaced)
+	{
+		this->rooms.remove(entry.first);
+	}
+
+	for (std::size_t i = 0; i < changedRooms.size(); i++)
+	{
+		replaced.emplace_back(changedCoords[i], this->rooms.get(changedCoords[i]));
+		this->rooms.set(changedCoords[i], changedRooms[i]);
+	}
+
+	// note: we only validate geometry for unique (non-grind) locations.
+	// Rooms are validated against their left and upper neighbors, so right and lower neighbors of changed Rooms need to
+	// be validated again as well
+	room_colliders_map colliders;
+	for (const auto& entry : this->rooms)
+	{
+		if (!this->grind)
+			colliders.emplace(entry.first, entry.second->getColliders());
+	}
+
+	bool valid = true;
+	for (std::size_t i = 0; i < changedCoords.size() && valid && !this->grind; i++)
+	{
+		HashableVector3i coordsRight = RoomGrid::getNearCoords(changedCoords[i], DIR_RIGHT);
+		HashableVector3i coordsDown = RoomGrid::getNearCoords(changedCoords[i], DIR_DOWN);
 
-		// TODO currently we keep all Rooms of the Location loaded in memory, which seems fine, because we want to do
-		// all the complicated setup when loading the Location, not when moving between Rooms. but this approach
-		// consumes a lot of memory, keeping track of all Rooms, while we really only need one. a solution might be to
-		// only keep the current and nearby Rooms loaded. nearby Rooms could be loaded (along with the resources they
-		// need) in a background thread. we'd only need to keep some light-weight version of Location data, e.g. a json
-		// object, or some kind of meta-location, with some of the data preliminarily parsed.
-		if (!room->load(resMgr, matMgr, objMgr, roomNode, this->roomDataPath))
+		valid = validateRoomGeometry(changedCoords[i], colliders) &&
+				(colliders.find(coordsRight) == colliders.end() || validateRoomGeometry(coordsRight, colliders)) &&
+				(colliders.find(coordsDown) == colliders.end() || validateRoomGeometry(coordsDown, colliders));
+	}
+
+	if (!valid)
+	{
+		for (const auto& [coords, oldRoom] : replaced)
 		{
-			this->unloadContent();
-			return false;
+			if (oldRoom == nullptr)
+				this->rooms.remove(coords);
+			else
+				this->rooms.set(coords, oldRoom);
 		}
 
-		// note: we only validate geometry for unique (non-grind) locations
-		if (!this->grind && !this->validateRoomGeometry(room, roomCoords))
+		return false;
+	}
+
+	// not present -> black background
+	const nlohmann::json& root = handler.getRoot();
+	std::string newBackgroundFullPath;
+	if (parseJsonKey<std::string>(root, this->roomDataPath, FOERR_JSON_KEY_BACKGROUND_FULL, newBackgroundFullPath,
+								  true))
+		newBackgroundFullPath = pathCombine(PATH_BACKGROUNDS_FULL, newBackgroundFullPath + ".png");
+
+	if (newBackgroundFullPath != this->backgroundFullPath)
+	{
+		this->backgroundFullPath = newBackgroundFullPath;
+		if (this->backgroundFullPath.empty())
+			this->backgroundFull = nullptr;
+		else
+			this->setupBackgroundFull(resMgr);
+	}
+
+	// stay in the current Room if it still exists
+	HashableVector3i currentCoords = this->rooms.getCurrentCoords();
+	if (this->rooms.get(currentCoords) == nullptr)
+	{
+		this->currentRoom = this->rooms.moveTo(startRoomCoords);
+		sf::Vector2u spawnCoordsPx = this->currentRoom->getSpawnCoords() * CELL_SIDE_LEN;
+		this->player.setPosition(spawnCoordsPx.x, spawnCoordsPx.y);
+	}
+	else if (this->rooms.get(currentCoords) != this->currentRoom)
+	{
+		this->currentRoom = this->rooms.moveTo(currentCoords);
+	}
+
+	// caches of replaced or removed Rooms are dropped
+	this->bakeCurrentRoom();
+
+	resMgr.reportMissingTextures(this->roomDataPath);
+	resMgr.cleanUnused();
+	roomTemplates.cleanUnused();
+
+	Log::i(STR_ROOMS_RELOADED, this->roomDataPath.c_str(), changedRooms.size(), removedCnt);
+	return true;
+}
+
+/**
+ * Calculates the key identifying the current version of rooms file. The key changes whenever the rooms file, or any
+ * file the rooms depend on (materials, objects) changes.
+ *
+ * @param key the calculated key will be stored here
+ * @return true if the key was calculated
+ * @return false if any of the files could not be read
+ */
+bool Location::getCompiledRoomsKey(std::uint64_t& key) const
+{
+	std::uint64_t hash = hashBytes(reinterpret_cast<const char*>(&COMPILED_ROOMS_VERSION),
+								   sizeof(COMPILED_ROOMS_VERSION));
+
+	if (!AssetArchive::hashFile(this->roomDataPath, hash, hash) ||
+		!AssetArchive::hashFile(PATH_MATERIALS, hash, hash) || !AssetArchive::hashFile(PATH_OBJS, hash, hash))
+		return false;
+
+	key = hash;
+	return true;
+}
+
+std::string Location::getCompiledRoomsPath() const
+{
+	std::string filename = this->roomDataPath;
+	std::replace(filename.begin(), filename.end(), PATH_DELIM, '_');
+	return pathCombine(SettingsManager::getCacheDir(), filename + ".bin");
+}
+
+/**
+ * Opens the compiled rooms file, previously written by ::writeCompiledRooms(), and reads its header and room table.
+ * Rooms themselves are loaded separately, via ::loadCompiledRoom(), which completely skips parsing the rooms json file.
+ * The compiled file is memory-mapped, so it's never copied as a whole. It stays mapped until ::closeCompiledRooms() is
+ * called.
+ *
+ * Compiled rooms file structure (native byte order):
+ *   - magic (COMPILED_ROOMS_MAGIC) and version (COMPILED_ROOMS_VERSION)
+ *   - key (see ::getCompiledRoomsKey())
+ *   - background full path, start room coordinates
+ *   - room count, followed by room table: coordinates, template hash, offset and size of template data (relative to
+ *     start of file)
+ *   - template data (see RoomTemplate::writeCompiled()). Identical Rooms point to the same template data, which is
+ *     only stored once
+ *
+ * Rooms stored in the file were already validated, so validation is not repeated.
+ *
+ * @param key expected key. if the file has a different key, it is considered stale
+ * @param startRoomCoords coordinates of the start room will be stored here
+ * @returns true if the file was opened
+ * @returns false if the file is missing, stale, or corrupted
+ */
+bool Location::openCompiledRooms(std::uint64_t key, HashableVector3i& startRoomCoords)
+{
+	const std::string compiledPath = this->getCompiledRoomsPath();
+
+	this->closeCompiledRooms();
+
+	if (!this->compiledRoomsFile.open(compiledPath))
+	{
+		Log::v(STR_COMPILED_ROOMS_STALE, compiledPath.c_str());
+		return false;
+	}
+
+	const std::size_t fileSize = this->compiledRoomsFile.getSize();
+	BinaryReader reader(this->compiledRoomsFile.getData(), fileSize);
+
+	std::uint32_t magic;
+	std::uint32_t version;
+	std::uint64_t fileKey;
+	if (!reader.read(magic) || !reader.read(version) || !reader.read(fileKey) || magic != COMPILED_ROOMS_MAGIC ||
+		version != COMPILED_ROOMS_VERSION || fileKey != key)
+	{
+		Log::v(STR_COMPILED_ROOMS_STALE, compiledPath.c_str());
+		this->closeCompiledRooms();
+		return false;
+	}
+
+	std::uint32_t roomCnt;
+	if (!reader.readString(this->backgroundFullPath) || !reader.read(startRoomCoords) || !reader.read(roomCnt))
+	{
+		Log::w(STR_COMPILED_ROOMS_CORRUPT, compiledPath.c_str());
+		this->closeCompiledRooms();
+		return false;
+	}
+
+	for (std::uint32_t i = 0; i < roomCnt; i++)
+	{
+		HashableVector3i roomCoords;
+		struct compiled_room_entry entry;
+		if (!reader.read(roomCoords) || !reader.read(entry.templateHash) || !reader.read(entry.offset) ||
+			!reader.read(entry.size) ||
+			entry.offset > fileSize || entry.size > fileSize - entry.offset)
 		{
-			this->unloadContent();
+			Log::w(STR_COMPILED_ROOMS_CORRUPT, compiledPath.c_str());
+			this->closeCompiledRooms();
 			return false;
 		}
 
-		this->rooms.set(roomCoords, room);
+		this->compiledRoomsIndex.emplace(roomCoords, entry);
 	}
 
-	if (!foundStart)
+	return true;
+}
+
+void Location::closeCompiledRooms()
+{
+	this->compiledRoomsIndex.clear();
+	this->compiledRoomsFile.close();
+}
+
+/**
+ * Gets a room template from the cache, or loads it from the compiled rooms file opened via ::openCompiledRooms() if
+ * it's not in use yet.
+ *
+ * The compiled file is only read, so this can be called from multiple threads at the same time.
+ *
+ * @param entry room table entry pointing to the template
+ * @param roomTemplates reference to cache of room templates
+ * @return the template
+ * @return nullptr if loading failed
+ */
+std::shared_ptr<const RoomTemplate> Location::loadCompiledTemplate(const struct compiled_room_entry& entry,
+																   RoomTemplateCache& roomTemplates) const
+{
+	std::shared_ptr<const RoomTemplate> roomTemplate = roomTemplates.get(entry.templateHash);
+	if (roomTemplate != nullptr)
+		return roomTemplate;
+
+	BinaryReader reader(this->compiledRoomsFile.getData() + entry.offset, entry.size);
+
+	std::shared_ptr<RoomTemplate> newTemplate = std::make_shared<RoomTemplate>(entry.templateHash);
+	if (!newTemplate->loadCompiled(reader))
 	{
-		// also covers the case where we have zero rooms
-		Log::e(STR_MISSING_START_ROOM, this->roomDataPath.c_str());
-		this->unloadContent();
+		Log::w(STR_COMPILED_ROOMS_CORRUPT, this->getCompiledRoomsPath().c_str());
+		return nullptr;
+	}
+
+	return roomTemplates.add(newTemplate);
+}
+
+/**
+ * Checks if the Player can move from a Room to a neighboring Room, i.e. if there's at least one passage (non-collider
+ * cell) in the edge shared by both Rooms.
+ *
+ * Rooms in front/behind each other are assumed to be connected, as moving between them doesn't depend on geometry.
+ *
+ * @param coords coordinates of the Room
+ * @param direction direction of the neighboring Room
+ * @return true if both Rooms exist and are connected
+ */
+bool Location::areRoomsConnected(const HashableVector3i& coords, Direction direction) const
+{
+	const std::shared_ptr<Room> room = this->rooms.get(coords);
+	const std::shared_ptr<Room> nearRoom = this->rooms.get(RoomGrid::getNearCoords(coords, direction));
+	if (room == nullptr || nearRoom == nullptr)
 		return false;
+
+	switch (direction)
+	{
+		case DIR_LEFT:
+		case DIR_RIGHT:
+		{
+			uint edgeX = direction == DIR_LEFT ? ROOM_BORDER_LEFT_X : ROOM_BORDER_RIGHT_X;
+			uint nearEdgeX = direction == DIR_LEFT ? ROOM_BORDER_RIGHT_X : ROOM_BORDER_LEFT_X;
+			for (uint y = 0; y < ROOM_HEIGHT_WITH_BORDER; y++)
+			{
+				if (!room->isCellCollider(edgeX, y) && !nearRoom->isCellCollider(nearEdgeX, y))
+					return true;
+			}
+
+			return false;
+		}
+		case DIR_UP:
+		case DIR_DOWN:
+		{
+			uint edgeY = direction == DIR_UP ? ROOM_BORDER_TOP_Y : ROOM_BORDER_BOTTOM_Y;
+			uint nearEdgeY = direction == DIR_UP ? ROOM_BORDER_BOTTOM_Y : ROOM_BORDER_TOP_Y;
+			for (uint x = 0; x < ROOM_WIDTH_WITH_BORDER; x++)
+			{
+				if (!room->isCellCollider(x, edgeY) && !nearRoom->isCellCollider(x, nearEdgeY))
+					return true;
+			}
+
+			return false;
+		}
+		default:
+			return true;
 	}
+}
 
-	// enter the starting room
-	this->currentRoom = this->rooms.moveTo(startRoomCoords);
-	if (this->currentRoom == nullptr)
+/**
+ * Walks the Room grid, starting from the start Room and moving only between connected Rooms (see
+ * ::areRoomsConnected()). Checking if every Room has at least one neighbor would not be enough - two Rooms could be
+ * connected only to each other and not to the rest of the Location.
+ *
+ * @param startRoomCoords coordinates of the start Room
+ * @return coordinates of all Rooms which were not reached
+ */
+std::vector<HashableVector3i> Location::findUnreachableRooms(const HashableVector3i& startRoomCoords) const
+{
+	std::unordered_set<HashableVector3i, Vector3Hasher<int>> reached { startRoomCoords };
+	std::vector<HashableVector3i> toVisit { startRoomCoords };
+
+	while (!toVisit.empty())
 	{
-		Log::e(STR_ROOM_MISSING_COORDS, this->roomDataPath.c_str(), startRoomCoords.x, startRoomCoords.y,
-			   startRoomCoords.z);
-		this->unloadContent();
+		HashableVector3i coords = toVisit.back();
+		toVisit.pop_back();
+
+		for (Direction direction : { DIR_LEFT, DIR_RIGHT, DIR_UP, DIR_DOWN, DIR_FRONT, DIR_BACK })
+		{
+			HashableVector3i nearCoords = RoomGrid::getNearCoords(coords, direction);
+			if (reached.find(nearCoords) == reached.end() && this->areRoomsConnected(coords, direction))
+			{
+				reached.insert(nearCoords);
+				toVisit.push_back(nearCoords);
+			}
+		}
+	}
+
+	std::vector<HashableVector3i> unreachable;
+	for (const auto& entry : this->rooms)
+	{
+		if (reached.find(entry.first) == reached.end())
+			unreachable.push_back(entry.first);
+	}
+
+	return unreachable;
+}
+
+/**
+ * Loads a single Room from the compiled rooms file opened via ::openCompiledRooms(). The Room is not added to the
+ * grid.
+ *
+ * The compiled file and its room table are only read, so this can be called from multiple threads at the same time.
+ *
+ * @param coords coordinates of the Room to load
+ * @return the loaded Room
+ * @return nullptr if there's no such Room in the file, or if loading failed
+ */
+std::shared_ptr<Room> Location::loadCompiledRoom(const HashableVector3i& coords, ResourceManager& resMgr,
+												 const MaterialManager& matMgr, const ObjectManager& objMgr,
+												 RoomTemplateCache& roomTemplates) const
+{
+	auto search = this->compiledRoomsIndex.find(coords);
+	if (search == this->compiledRoomsIndex.end())
+		return nullptr;
+
+	std::shared_ptr<const RoomTemplate> roomTemplate = this->loadCompiledTemplate(search->second, roomTemplates);
+	if (roomTemplate == nullptr)
+		return nullptr;
+
+	std::shared_ptr<Room> room =
+		std::make_shared<Room>(this->player, RoomBackCache::getCacheId(this->roomDataPath, coords));
+	if (!room->instantiate(roomTemplate, resMgr, matMgr, objMgr, this->isRoomMirrored(coords)))
+		return nullptr;
+
+	return room;
+}
+
+/**
+ * Loads all Rooms from the compiled rooms file opened via ::openCompiledRooms(), and adds them to the grid.
+ *
+ * @returns true if all Rooms were loaded
+ * @returns false if loading any of the Rooms failed. Location content should be unloaded in that case
+ */
+bool Location::loadAllCompiledRooms(ResourceManager& resMgr, const MaterialManager& matMgr,
+									const ObjectManager& objMgr, RoomTemplateCache& roomTemplates)
+{
+	std::vector<HashableVector3i> coords;
+	std::vector<struct compiled_room_entry> uniqueEntries;
+	std::unordered_set<std::uint64_t> uniqueHashes;
+	for (const auto& [roomCoords, entry] : this->compiledRoomsIndex)
+	{
+		coords.push_back(roomCoords);
+		if (uniqueHashes.insert(entry.templateHash).second)
+			uniqueEntries.push_back(entry);
+	}
+
+	LoadProgress::getCurrent()->addRoomsTotal(coords.size());
+
+	// load each template first, so that templates shared by multiple Rooms are only loaded once. the templates must be
+	// kept alive until all Rooms are loaded, as the cache doesn't hold them by itself
+	std::vector<std::shared_ptr<const RoomTemplate>> templates(uniqueEntries.size());
+	bool loaded = parallelFor(uniqueEntries.size(),
+							  [this, &roomTemplates, &uniqueEntries, &templates](std::size_t idx)
+							  {
+								  if (this->isLoadCancelled())
+									  return false;
+
+								  templates[idx] = this->loadCompiledTemplate(uniqueEntries[idx], roomTemplates);
+								  LoadProgress::getCurrent()->addBytesRead(uniqueEntries[idx].size);
+								  return templates[idx] != nullptr;
+							  });
+
+	if (!loaded)
+		return false;
+
+	std::vector<std::shared_ptr<Room>> newRooms(coords.size());
+	loaded = parallelFor(coords.size(),
+						 [this, &resMgr, &matMgr, &objMgr, &roomTemplates, &coords, &newRooms](std::size_t idx)
+						 {
+							 if (this->isLoadCancelled())
+								 return false;
+
+							 newRooms[idx] = this->loadCompiledRoom(coords[idx], resMgr, matMgr, objMgr,
+																	roomTemplates);
+							 LoadProgress::getCurrent()->addRoomsParsed(1);
+							 return newRooms[idx] != nullptr;
+						 });
+
+	if (!loaded)
 		return false;
+
+	for (std::size_t i = 0; i < coords.size(); i++)
+	{
+		this->rooms.set(coords[i], newRooms[i]);
+	}
+
+	Log::v(STR_COMPILED_ROOMS_LOADED, this->getCompiledRoomsPath().c_str());
+	return true;
+}
+
+/**
+ * Writes all rooms into the compiled rooms file (see ::openCompiledRooms()). Failing to write the file is not an
+ * error - the rooms will simply be loaded from json next time.
+ *
+ * @param key key of the rooms file the rooms were loaded from (see ::getCompiledRoomsKey())
+ * @param startRoomCoords coordinates of the start room
+ */
+void Location::writeCompiledRooms(std::uint64_t key, const HashableVector3i& startRoomCoords,
+								  const room_table& roomTable) const
+{
+	const std::string compiledPath = this->getCompiledRoomsPath();
+
+	// each template is only written once, even if it's used by multiple rooms
+	std::vector<BinaryWriter> templateWriters;
+	std::unordered_map<std::uint64_t, std::size_t> templateIdxs;
+	for (const auto& [coords, roomTemplate] : roomTable)
+	{
+		if (templateIdxs.emplace(roomTemplate->getHash(), templateWriters.size()).second)
+		{
+			templateWriters.emplace_back();
+			roomTemplate->writeCompiled(templateWriters.back());
+		}
 	}
 
-	this->currentRoom->init();
+	BinaryWriter writer;
+	writer.write(COMPILED_ROOMS_MAGIC);
+	writer.write(COMPILED_ROOMS_VERSION);
+	writer.write(key);
+	writer.writeString(this->backgroundFullPath);
+	writer.write(startRoomCoords);
+	writer.write(static_cast<std::uint32_t>(roomTable.size()));
+
+	// template data starts right after the room table
+	constexpr std::size_t tableEntrySize = sizeof(HashableVector3i) + 3 * sizeof(std::uint64_t);
+	std::uint64_t offset = writer.getBuffer().size() + roomTable.size() * tableEntrySize;
+	std::vector<std::uint64_t> templateOffsets;
+	for (const auto& templateWriter : templateWriters)
+	{
+		templateOffsets.push_back(offset);
+		offset += templateWriter.getBuffer().size();
+	}
 
-	// TODO sanity checks:
-	// - at least one MAS terminal
-	// - [grind maps only] at least one exit
-	// - all doors/vents/etc must have a counterpart in another room, so that all passages actually lead to other rooms
+	for (const auto& [coords, roomTemplate] : roomTable)
+	{
+		std::size_t templateIdx = templateIdxs[roomTemplate->getHash()];
+		writer.write(coords);
+		writer.write(roomTemplate->getHash());
+		writer.write(templateOffsets[templateIdx]);
+		writer.write(static_cast<std::uint64_t>(templateWriters[templateIdx].getBuffer().size()));
+	}
 
-	// we could also check if room grid is valid, i.e. are all rooms reachable.
-	// we'd have to implement some kind of DFS. checking if every room has at least one neighbor is not enough - two
-	// rooms could be connected only to each other and not to the rest of the location, which would fool this check.
-	// this would be nice to have, but could potentially limit the ability to create some interesting locations (e.g.
-	// ones using teleportation to travel between different unconnected sections, or ones which can be entered from more
-	// than one side). so for now let's assume that the creator of location will make sure that all required rooms are
-	// reachable.
+	for (const auto& templateWriter : templateWriters)
+	{
+		writer.writeBytes(templateWriter.getBuffer().data(), templateWriter.getBuffer().size());
+	}
+
+	if (!writer.saveToFile(compiledPath))
+		Log::w(STR_COMPILED_ROOMS_WRITE_FAIL, compiledPath.c_str());
+}
+
+/**
+ * Decides if a Room should be mirrored (see Room::instantiate()). Only Rooms in grind Locations are mirrored, about
+ * half of them. The decision only depends on Room coordinates and on a seed randomized when loading Location content,
+ * so it stays the same when a Room is unloaded and loaded again (see ::updateLoadedRooms()).
+ */
+bool Location::isRoomMirrored(const HashableVector3i& coords) const
+{
+	if (!this->grind)
+		return false;
 
-	Log::v(STR_LOADED_LOCATION_CONTENT, this->roomDataPath.c_str());
-	return true;
+	// FNV-1a mixes the lowest bits poorly, so use a higher one
+	std::uint64_t hash = hashBytes(reinterpret_cast<const char*>(&coords), sizeof(coords), this->mirrorSeed);
+	return ((hash >> 32) & 1) != 0;
 }
 
 /**
@@ -269,39 +1253,39 @@ bool Location::loadContent(ResourceManager& resMgr, const MaterialManager& matMg
  *
  * If there's no Room on a given side, the validation also passes.
  *
- * This should be called in the same loop where Rooms are being loaded. This way all connections will be checked exactly
- * once (a given Room will check its given side only when the adjacent Room is present).
+ * This should be called after all Rooms have been loaded. Only the left and top side of a given Room are checked - the
+ * right and bottom sides will be checked by the adjacent Rooms. This way all connections will be checked exactly once.
+ * Only collider Cells of Rooms are needed (see RoomColliders), so the Rooms themselves don't need to stay loaded. As
+ * colliders are only read, this can be called for multiple Rooms at the same time.
  *
  * Connections in the Z axis are not checked, as walls don't matter in that case.
  *
+ * @param roomCoords coordinates of the Room to validate
+ * @param colliders collider Cells of all Rooms of the Location
  * @return true if validation passed, false otherwise
  */
-bool Location::validateRoomGeometry(const std::shared_ptr<Room>& room, const HashableVector3i& roomCoords) const
+bool Location::validateRoomGeometry(const HashableVector3i& roomCoords, const room_colliders_map& colliders)
 {
 	HashableVector3i coordsLeft = roomCoords;
-	HashableVector3i coordsRight = roomCoords;
 	HashableVector3i coordsUp = roomCoords;
-	HashableVector3i coordsDown = roomCoords;
 
-	coordsLeft.x -= 1;
-	const std::shared_ptr<Room> roomLeft = this->rooms.get(coordsLeft);
+	const RoomColliders& room = colliders.at(roomCoords);
 
-	coordsRight.x += 1;
-	const std::shared_ptr<Room> roomRight = this->rooms.get(coordsRight);
+	coordsLeft.x -= 1;
+	auto roomLeftSearch = colliders.find(coordsLeft);
 
 	coordsUp.y -= 1;
-	const std::shared_ptr<Room> roomUp = this->rooms.get(coordsUp);
+	auto roomUpSearch = colliders.find(coordsUp);
 
-	coordsDown.y += 1;
-	const std::shared_ptr<Room> roomDown = this->rooms.get(coordsDown);
-
-	if (roomLeft != nullptr)
+	if (roomLeftSearch != colliders.end())
 	{
+		const RoomColliders& roomLeft = roomLeftSearch->second;
+
 		for (uint y = 0; y < ROOM_HEIGHT_WITH_BORDER; y++)
 		{
-			bool isThisCellCollider = room->isCellCollider(ROOM_BORDER_LEFT_X, y);
+			bool isThisCellCollider = room.isCellCollider(ROOM_BORDER_LEFT_X, y);
 
-			if (isThisCellCollider != roomLeft->isCellCollider(ROOM_BORDER_RIGHT_X, y))
+			if (isThisCellCollider != roomLeft.isCellCollider(ROOM_BORDER_RIGHT_X, y))
 			{
 				Log::e(STR_ROOM_GEOMETRY_VAL_FAIL, roomCoords.x, roomCoords.y, roomCoords.z, ROOM_BORDER_LEFT_X, y);
 				return false;
@@ -311,14 +1295,14 @@ bool Location::validateRoomGeometry(const std::shared_ptr<Room>& room, const Has
 			{
 				// edge Cell is a passage - check if both sides have enough space for the Player character
 
-				if (room->isCellCollider(ROOM_BORDER_LEFT_INNER_X, y))
+				if (room.isCellCollider(ROOM_BORDER_LEFT_INNER_X, y))
 				{
 					Log::e(STR_ROOM_GEOMETRY_VAL_FAIL_INSUF, roomCoords.x, roomCoords.y, roomCoords.z,
 						   ROOM_BORDER_LEFT_INNER_X, y);
 					return false;
 				}
 
-				if (roomLeft->isCellCollider(ROOM_BORDER_RIGHT_INNER_X, y))
+				if (roomLeft.isCellCollider(ROOM_BORDER_RIGHT_INNER_X, y))
 				{
 					Log::e(STR_ROOM_GEOMETRY_VAL_FAIL_INSUF, coordsLeft.x, coordsLeft.y, coordsLeft.z,
 						   ROOM_BORDER_RIGHT_INNER_X, y);
@@ -328,46 +1312,15 @@ bool Location::validateRoomGeometry(const std::shared_ptr<Room>& room, const Has
 		}
 	}
 
-	if (roomRight != nullptr)
+	if (roomUpSearch != colliders.end())
 	{
-		for (uint y = 0; y < ROOM_HEIGHT_WITH_BORDER; y++)
-		{
-			bool isThisCellCollider = room->isCellCollider(ROOM_BORDER_RIGHT_X, y);
-
-			if (isThisCellCollider != roomRight->isCellCollider(ROOM_BORDER_LEFT_X, y))
-			{
-				Log::e(STR_ROOM_GEOMETRY_VAL_FAIL, roomCoords.x, roomCoords.y, roomCoords.z, ROOM_BORDER_RIGHT_X, y);
-				return false;
-			}
-
-			if (!isThisCellCollider)
-			{
-				// edge Cell is a passage - check if both sides have enough space for the Player character
-
-				if (room->isCellCollider(ROOM_BORDER_RIGHT_INNER_X, y))
-				{
-					Log::e(STR_ROOM_GEOMETRY_VAL_FAIL_INSUF, roomCoords.x, roomCoords.y, roomCoords.z,
-						   ROOM_BORDER_RIGHT_INNER_X, y);
-					return false;
-				}
-
-				if (roomRight->isCellCollider(ROOM_BORDER_LEFT_INNER_X, y))
-				{
-					Log::e(STR_ROOM_GEOMETRY_VAL_FAIL_INSUF, coordsRight.x, coordsRight.y, coordsRight.z,
-						   ROOM_BORDER_LEFT_INNER_X, y);
-					return false;
-				}
-			}
-		}
-	}
+		const RoomColliders& roomUp = roomUpSearch->second;
 
-	if (roomUp != nullptr)
-	{
 		for (uint x = 0; x < ROOM_WIDTH_WITH_BORDER; x++)
 		{
-			bool isThisCellCollider = room->isCellCollider(x, ROOM_BORDER_TOP_Y);
+			bool isThisCellCollider = room.isCellCollider(x, ROOM_BORDER_TOP_Y);
 
-			if (isThisCellCollider != roomUp->isCellCollider(x, ROOM_BORDER_BOTTOM_Y))
+			if (isThisCellCollider != roomUp.isCellCollider(x, ROOM_BORDER_BOTTOM_Y))
 			{
 				Log::e(STR_ROOM_GEOMETRY_VAL_FAIL, roomCoords.x, roomCoords.y, roomCoords.z, x, ROOM_BORDER_TOP_Y);
 				return false;
@@ -377,14 +1330,14 @@ bool Location::validateRoomGeometry(const std::shared_ptr<Room>& room, const Has
 			{
 				// edge Cell is a passage - check if both sides have enough space for the Player character
 
-				if (room->isCellCollider(x, ROOM_BORDER_TOP_INNER_Y))
+				if (room.isCellCollider(x, ROOM_BORDER_TOP_INNER_Y))
 				{
 					Log::e(STR_ROOM_GEOMETRY_VAL_FAIL_INSUF, roomCoords.x, roomCoords.y, roomCoords.z, x,
 						   ROOM_BORDER_TOP_INNER_Y);
 					return false;
 				}
 
-				if (roomUp->isCellCollider(x, ROOM_BORDER_BOTTOM_INNER_Y))
+				if (roomUp.isCellCollider(x, ROOM_BORDER_BOTTOM_INNER_Y))
 				{
 					Log::e(STR_ROOM_GEOMETRY_VAL_FAIL_INSUF, coordsUp.x, coordsUp.y, coordsUp.z, x,
 						   ROOM_BORDER_BOTTOM_INNER_Y);
@@ -394,46 +1347,46 @@ bool Location::validateRoomGeometry(const std::shared_ptr<Room>& room, const Has
 		}
 	}
 
-	if (roomDown != nullptr)
-	{
-		for (uint x = 0; x < ROOM_WIDTH_WITH_BORDER; x++)
-		{
-			bool isThisCellCollider = room->isCellCollider(x, ROOM_BORDER_BOTTOM_Y);
-
-			if (isThisCellCollider != roomDown->isCellCollider(x, ROOM_BORDER_TOP_Y))
-			{
-				Log::e(STR_ROOM_GEOMETRY_VAL_FAIL, roomCoords.x, roomCoords.y, roomCoords.z, x, ROOM_BORDER_BOTTOM_Y);
-				return false;
-			}
-
-			if (!isThisCellCollider)
-			{
-				// edge Cell is a passage - check if both sides have enough space for the Player character
-
-				if (room->isCellCollider(x, ROOM_BORDER_BOTTOM_INNER_Y))
-				{
-					Log::e(STR_ROOM_GEOMETRY_VAL_FAIL_INSUF, roomCoords.x, roomCoords.y, roomCoords.z, x,
-						   ROOM_BORDER_BOTTOM_INNER_Y);
-					return false;
-				}
-
-				if (roomDown->isCellCollider(x, ROOM_BORDER_TOP_INNER_Y))
-				{
-					Log::e(STR_ROOM_GEOMETRY_VAL_FAIL_INSUF, coordsDown.x, coordsDown.y, coordsDown.z, x,
-						   ROOM_BORDER_TOP_INNER_Y);
-					return false;
-				}
-			}
-		}
-	}
-
 	return true;
 }
 
 void Location::unloadContent()
 {
-	this->backgroundFullSprite.clearPtr();
+	this->roomStreamer.stop();
+	this->closeCompiledRooms();
+	this->roomStates.clear();
+	this->roomChangePending = false;
+	this->roomBakeRequested = false;
+	this->resMgr = nullptr;
+	this->backgroundFullPath.clear();
+	this->backgroundFull = nullptr;
+
+	for (const auto& entry : this->bakedRooms)
+	{
+		entry.second->deinit(this->roomCachePool);
+	}
+
+	this->bakedRooms.clear();
 	this->rooms.clear();
+	this->roomCachePool.clear();
+	this->roomTransitionRender = nullptr;
+}
+
+/**
+ * @return true if content was loaded (see ::loadContent()) and not unloaded since
+ */
+bool Location::isContentLoaded() const
+{
+	return this->rooms.size() > 0;
+}
+
+/**
+ * @return true if the load in progress should be cancelled (see ::loadContent()). Can be called from any thread taking
+ *         part in the load
+ */
+bool Location::isLoadCancelled() const
+{
+	return LoadProgress::getCurrent()->isCancelled();
 }
 
 std::string Location::getId() const
@@ -441,6 +1394,11 @@ std::string Location::getId() const
 	return this->id;
 }
 
+std::string Location::getRoomDataPath() const
+{
+	return this->roomDataPath;
+}
+
 std::string Location::getTitle() const
 {
 	return this->title;
@@ -478,7 +1436,10 @@ std::string Location::getWorldMapIconId() const
 
 /**
  * Changes the current Room to a nearest Room in the specified direction.
- * If such Room does not exist, nothing will happen.
+ * If such Room does not exist, nothing will happen. If it's still being loaded in the background (see
+ * ::isRoomReady()), or it's not baked yet, nothing will happen as well, but the Room will be entered once it's loaded
+ * and baked, and this is called again (the Player is held at the edge of the current Room in the meantime, see
+ * ::tick()). The Room is baked before other Rooms in the meantime (see ::bakeNearRoom()).
  * Moves the Player to a new position, specified by newPlayerCoords. Moving the Player needs to happen in this function
  * in order to display them correctly during Room transition.
  *
@@ -490,6 +1451,19 @@ std::string Location::getWorldMapIconId() const
  */
 bool Location::gotoRoom(Direction direction, sf::Vector2f newPlayerCoords)
 {
+	const HashableVector3i nearCoords = RoomGrid::getNearCoords(this->rooms.getCurrentCoords(), direction);
+	if (!this->isRoomReady(nearCoords))
+		return false;
+
+	// baking takes too long to be done right away, so the Room is only entered once it's baked in the background
+	const std::shared_ptr<Room> nearRoom = this->rooms.get(nearCoords);
+	if (nearRoom != nullptr && !nearRoom->isBaked())
+	{
+		this->requestedBakeCoords = nearCoords;
+		this->roomBakeRequested = true;
+		return false;
+	}
+
 	std::shared_ptr<Room> newRoom = this->rooms.moveToNear(direction);
 	if (newRoom == nullptr)
 		return false;
@@ -498,28 +1472,31 @@ bool Location::gotoRoom(Direction direction, sf::Vector2f newPlayerCoords)
 	{
 		// no transition when transition duration is 0, or when changing the Z coordinate
 
-		// old room no longer needed
-		this->currentRoom->deinit();
-
+		// old room caches are kept, in case the player goes back
 		this->player.setPosition(newPlayerCoords);
 
 		this->currentRoom = newRoom;
-		this->currentRoom->init();
+		this->bakeCurrentRoom();
 
 		this->roomTransitionInProgress = false;
 
+		this->updateLoadedRooms();
 		return true;
 	}
 
 	this->roomTransitionDirection = direction;
 
-	sf::RenderTexture tmpTxt;
-
-	// TODO? not sure why, but if we create (W * 2, H), then on *next call* (W, H * 2), the size will change, but it
-	// will work as if the actual size was *still* the one we set on first call. maybe this has something to do with
-	// NonCopyable. for now let's just use 2x as much memory for nothing :|
-	tmpTxt.create(GAME_AREA_WIDTH * 2, GAME_AREA_HEIGHT * 2);
+	// the render texture is created once and reused for all transitions, the transition sprite displays it directly.
+	// TODO? it only needs to be (W * 2, H) or (W, H * 2), depending on direction, but resizing the render texture
+	// misbehaves (the old size still applies), so let's just use 2x as much memory for nothing :|
+	if (this->roomTransitionRender == nullptr)
+	{
+		this->roomTransitionRender = std::make_unique<sf::RenderTexture>();
+		this->roomTransitionRender->create(GAME_AREA_WIDTH * 2, GAME_AREA_HEIGHT * 2);
+		this->roomTransitionSprite.setTexture(this->roomTransitionRender->getTexture(), true);
+	}
 
+	sf::RenderTexture& tmpTxt = *this->roomTransitionRender;
 	tmpTxt.clear(sf::Color::Transparent);
 
 	// render old room to transition texture
@@ -540,14 +1517,12 @@ bool Location::gotoRoom(Direction direction, sf::Vector2f newPlayerCoords)
 
 	tmpTxt.draw(*this->currentRoom);
 
-	// old room no longer needed
-	this->currentRoom->deinit();
-
-	// reset old room position
+	// reset old room position. its caches are kept, in case the player goes back
 	this->currentRoom->setPosition(0, 0);
 
+	// the new room is already baked (see ::bakeNearRoom())
 	this->currentRoom = newRoom;
-	this->currentRoom->init();
+	this->bakeCurrentRoom();
 
 	// render new room to the transition texture (same as old room, but in different position
 
@@ -565,8 +1540,6 @@ bool Location::gotoRoom(Direction direction, sf::Vector2f newPlayerCoords)
 	this->currentRoom->setPosition(0, 0);
 
 	tmpTxt.display();
-	this->roomTransitionTxt = tmpTxt.getTexture();
-	this->roomTransitionSprite.setTexture(this->roomTransitionTxt);
 
 	// set initial transition sprite position
 	if (direction == DIR_RIGHT || direction == DIR_DOWN)
@@ -579,27 +1552,377 @@ bool Location::gotoRoom(Direction direction, sf::Vector2f newPlayerCoords)
 	this->roomTransitionTimer.restart();
 	this->roomTransitionInProgress = true;
 
+	this->updateLoadedRooms();
 	return true;
 }
 
+/**
+ * Changes the current Room to the Room at given coordinates, and moves the Player to its spawn coordinates. If the Room
+ * is still being loaded in the background (see ::isRoomReady()), or it's not baked yet, it will be entered once it's
+ * loaded and baked (see ::tick()).
+ *
+ * @param coords coordinates of the Room to enter
+ * @return true if Room was changed, or will be changed once it's loaded
+ * @return false if such Room does not exist
+ */
 bool Location::gotoRoom(HashableVector3i coords)
 {
+	if (!this->isRoomReady(coords))
+	{
+		this->pendingRoomCoords = coords;
+		this->roomChangePending = true;
+		return true;
+	}
+
+	// the Room doesn't exist, or failed to load in the background, so there's nothing to wait for anymore
+	this->roomChangePending = false;
+
+	const std::shared_ptr<Room> targetRoom = this->rooms.get(coords);
+	if (targetRoom != nullptr && !targetRoom->isBaked())
+	{
+		this->pendingRoomCoords = coords;
+		this->roomChangePending = true;
+		this->requestedBakeCoords = coords;
+		this->roomBakeRequested = true;
+		return true;
+	}
+
 	std::shared_ptr<Room> newRoom = this->rooms.moveTo(coords);
 	if (newRoom == nullptr)
 		return false;
 
-	this->currentRoom->deinit();
 	this->currentRoom = newRoom;
-	this->currentRoom->init();
+	this->bakeCurrentRoom();
 
 	this->player.setPosition(static_cast<sf::Vector2f>(this->currentRoom->getSpawnCoords() * CELL_SIDE_LEN));
 
+	this->updateLoadedRooms();
 	return true;
 }
 
+/**
+ * Moves Rooms which were loaded in the background to the grid.
+ */
+void Location::collectStreamedRooms()
+{
+	for (const auto& [coords, room] : this->roomStreamer.takeLoaded())
+	{
+		// the Room might have been already loaded in the meantime (e.g. by ::reloadChangedRooms())
+		if (this->rooms.get(coords) == nullptr)
+			this->rooms.set(coords, room);
+	}
+
+	if (this->resMgr != nullptr)
+		this->resMgr->reportMissingTextures(this->roomDataPath);
+}
+
+/**
+ * Checks if the Room at given coordinates can be entered right away, i.e. if it's loaded or it doesn't exist at all.
+ * If the Room is not loaded yet, it's requested to be loaded in the background before any other Room. This never
+ * blocks, so the caller should just try again on one of the next frames. A Room which failed to load (see
+ * RoomStreamer::hasFailed()) is treated as if it didn't exist, so entering it is refused instead of waiting forever.
+ *
+ * Always true when all Rooms are kept loaded.
+ */
+bool Location::isRoomReady(const HashableVector3i& coords)
+{
+	if (!this->roomStreamer.isRunning())
+		return true;
+
+	this->collectStreamedRooms();
+
+	if (this->rooms.get(coords) != nullptr || this->compiledRoomsIndex.find(coords) == this->compiledRoomsIndex.end() ||
+		this->roomStreamer.hasFailed(coords))
+		return true;
+
+	this->roomStreamer.request(coords, true);
+	return false;
+}
+
+/**
+ * Should be called after entering a Room. Requests all Rooms adjacent to the current Room to be loaded in the
+ * background, and unloads Rooms which are the farthest away from the current Room, so that no more than
+ * SettingsManager::maxLoadedRooms are kept loaded. The current Room and its neighbors are never unloaded.
+ *
+ * State of unloaded Rooms which was changed while playing is kept, and restored after the Room is loaded again (see
+ * ::restoreRoomState()).
+ *
+ * Has no effect when all Rooms are kept loaded.
+ */
+void Location::updateLoadedRooms()
+{
+	if (!this->roomStreamer.isRunning())
+		return;
+
+	this->collectStreamedRooms();
+
+	// rooms requested for the previous room are not needed that much anymore
+	this->roomStreamer.cancelQueued();
+
+	const HashableVector3i currentCoords = this->rooms.getCurrentCoords();
+	for (Direction direction : { DIR_LEFT, DIR_RIGHT, DIR_UP, DIR_DOWN, DIR_FRONT, DIR_BACK })
+	{
+		HashableVector3i nearCoords = RoomGrid::getNearCoords(currentCoords, direction);
+		if (this->rooms.get(nearCoords) == nullptr &&
+			this->compiledRoomsIndex.find(nearCoords) != this->compiledRoomsIndex.end())
+			this->roomStreamer.request(nearCoords);
+	}
+
+	if (this->rooms.size() <= SettingsManager::maxLoadedRooms)
+		return;
+
+	std::vector<std::pair<int, HashableVector3i>> unloadCandidates;
+	for (const auto& entry : this->rooms)
+	{
+		const HashableVector3i& coords = entry.first;
+		int distance = std::abs(coords.x - currentCoords.x) + std::abs(coords.y - currentCoords.y) +
+					   std::abs(coords.z - currentCoords.z);
+
+		if (distance > 1)
+			unloadCandidates.emplace_back(distance, coords);
+	}
+
+	// farthest first
+	std::sort(unloadCandidates.begin(), unloadCandidates.end(),
+			  [](const auto& lhs, const auto& rhs) { return lhs.first > rhs.first; });
+
+	for (const auto& candidate : unloadCandidates)
+	{
+		if (this->rooms.size() <= SettingsManager::maxLoadedRooms)
+			break;
+
+		const std::shared_ptr<Room> room = this->rooms.get(candidate.second);
+		if (room->hasStateChanged())
+		{
+			const std::lock_guard<std::mutex> lock(this->roomStatesMutex);
+			this->roomStates[candidate.second] = room->getState();
+		}
+
+		this->rooms.remove(candidate.second);
+	}
+
+	// free caches and textures which were only used by unloaded Rooms
+	this->trimRoomCaches();
+	this->resMgr->cleanUnused();
+}
+
+/**
+ * Restores state of a Room which was changed before the Room was unloaded (see ::updateLoadedRooms()). Called on the
+ * streamer thread, right after the Room is loaded.
+ */
+void Location::restoreRoomState(const HashableVector3i& coords, Room& room, ResourceManager& resMgr,
+								const ObjectManager& objMgr)
+{
+	struct room_state state;
+
+	{
+		const std::lock_guard<std::mutex> lock(this->roomStatesMutex);
+		auto search = this->roomStates.find(coords);
+		if (search == this->roomStates.end())
+			return;
+
+		state = search->second;
+	}
+
+	room.restoreState(state, resMgr, objMgr);
+}
+
+/**
+ * @return how many Rooms can keep their render caches, see SettingsManager::roomCacheBudgetMb. Always at least one
+ */
+std::size_t Location::getMaxBakedRooms() const
+{
+	const std::size_t budget = static_cast<std::size_t>(SettingsManager::roomCacheBudgetMb) * 1024 * 1024;
+	return std::max(budget / ROOM_CACHES_SIZE, static_cast<std::size_t>(1));
+}
+
+/**
+ * Should be called after entering a Room. Bakes the current Room if it's not baked yet, and marks it as the most
+ * recently entered, so that its caches are the last to be dropped. Rooms entered via ::gotoRoom() are already baked,
+ * so the whole Room is only baked here right after loading content.
+ *
+ * Render caches can only be used on the main thread, so this is not done when loading content (see ::loadContent()),
+ * which can happen on another thread. The Campaign calls this after the load is finished instead (see
+ * Campaign::handleLoadFinished()). Must be called on the main thread.
+ *
+ * Rooms can be loaded on other threads, where textures are not uploaded right away, so pending textures are uploaded
+ * first (see ResourceManager::finishPendingTextures()).
+ */
+void Location::bakeCurrentRoom()
+{
+	const HashableVector3i currentCoords = this->rooms.getCurrentCoords();
+
+	if (this->resMgr != nullptr && !this->currentRoom->isBaked())
+		this->resMgr->finishPendingTextures();
+
+	this->bakedRooms.remove_if([this](const auto& entry) { return entry.second == this->currentRoom; });
+	this->bakedRooms.emplace_front(currentCoords, this->currentRoom);
+
+	if (!this->currentRoom->isBaked())
+		this->currentRoom->init(this->roomCachePool, this->roomBackCacheWriter);
+
+	// a Room was entered, so the Player isn't waiting for any other Room to be baked anymore
+	this->roomBakeRequested = false;
+
+	this->trimRoomCaches();
+}
+
+/**
+ * Bakes Rooms adjacent to the current Room, if there are ones which aren't baked yet. Meant to be called once per frame
+ * while the game is idle (i.e. not during Room transition), so that Rooms are already baked when the player enters
+ * them. Rooms are baked in stages (see Room::bakeStep()), until ROOM_BAKE_BUDGET_US is used up, so baking is spread
+ * over multiple frames instead of stalling a single one. At least one stage is done per call. A Room which the Player
+ * is waiting for (see ::gotoRoom()) is baked first.
+ *
+ * If SettingsManager::roomCacheBudgetMb is already used up, caches of the least recently entered Room are dropped to
+ * make room. Caches of the current Room, of Rooms adjacent to it, and of the Room which the Player is waiting for are
+ * never dropped for this, as these are the most likely to be displayed next. The Room which the Player is waiting for
+ * is baked even if the budget is too small for it, its caches are dropped after it's entered (see ::trimRoomCaches()).
+ *
+ * Nothing is baked while some textures are not uploaded yet (see ResourceManager::uploadPendingTextures()), as they
+ * might be used by the Room.
+ */
+void Location::bakeNearRoom()
+{
+	if (this->resMgr != nullptr && this->resMgr->hasPendingTextures())
+		return;
+
+	if (this->roomStreamer.isRunning())
+		this->collectStreamedRooms();
+
+	const HashableVector3i currentCoords = this->rooms.getCurrentCoords();
+	std::vector<HashableVector3i> candidates;
+	if (this->roomBakeRequested)
+		candidates.push_back(this->requestedBakeCoords);
+
+	for (Direction direction : { DIR_LEFT, DIR_RIGHT, DIR_UP, DIR_DOWN, DIR_FRONT, DIR_BACK })
+	{
+		candidates.push_back(RoomGrid::getNearCoords(currentCoords, direction));
+	}
+
+	sf::Clock bakeTimer;
+	for (const HashableVector3i& coords : candidates)
+	{
+		std::shared_ptr<Room> room = this->rooms.get(coords);
+		if (room == nullptr || room->isBaked())
+			continue;
+
+		// a Room which is partially baked already holds its caches, see Room::bakeStep()
+		if (!room->hasCaches())
+		{
+			if (this->bakedRooms.size() >= this->getMaxBakedRooms())
+			{
+				// iterate from the least recently entered Room
+				auto dropped = std::find_if(this->bakedRooms.rbegin(), this->bakedRooms.rend(),
+											[this, &currentCoords](const auto& entry)
+											{
+												return entry.second != this->currentRoom &&
+													   !RoomGrid::areCoordsNear(entry.first, currentCoords) &&
+													   !(this->roomBakeRequested &&
+														 entry.first == this->requestedBakeCoords);
+											});
+
+				if (dropped != this->bakedRooms.rend())
+				{
+					dropped->second->deinit(this->roomCachePool);
+					this->bakedRooms.erase(std::next(dropped).base());
+				}
+				else if (!this->roomBakeRequested || coords != this->requestedBakeCoords)
+				{
+					// budget is too small to fit all adjacent Rooms
+					return;
+				}
+			}
+
+			this->bakedRooms.emplace_back(coords, room);
+		}
+
+		while (!room->bakeStep(this->roomCachePool, this->roomBackCacheWriter))
+		{
+			if (bakeTimer.getElapsedTime().asMicroseconds() >= ROOM_BAKE_BUDGET_US)
+				return;
+		}
+
+		if (bakeTimer.getElapsedTime().asMicroseconds() >= ROOM_BAKE_BUDGET_US)
+			return;
+	}
+}
+
+/**
+ * Drops caches of Rooms which were unloaded or replaced, and of least recently entered Rooms exceeding
+ * SettingsManager::roomCacheBudgetMb. The current Room always keeps its caches. Caches which are not used by any Room
+ * are freed as well, except ones which fit in the budget, so that they can be reused without creating new ones.
+ */
+void Location::trimRoomCaches()
+{
+	const std::size_t maxBakedRooms = this->getMaxBakedRooms();
+
+	// iterate from the least recently entered Room
+	for (auto it = this->bakedRooms.end(); it != this->bakedRooms.begin();)
+	{
+		it--;
+
+		if (it->second == this->currentRoom)
+			continue;
+
+		// the Player is waiting for this Room to be baked, see ::bakeNearRoom()
+		if (this->roomBakeRequested && it->first == this->requestedBakeCoords &&
+			this->rooms.get(it->first) == it->second)
+			continue;
+
+		if (this->rooms.get(it->first) != it->second || this->bakedRooms.size() > maxBakedRooms)
+		{
+			it->second->deinit(this->roomCachePool);
+			it = this->bakedRooms.erase(it);
+		}
+	}
+
+	this->roomCachePool.shrink(maxBakedRooms - std::min(this->bakedRooms.size(), maxBakedRooms));
+}
+
+/**
+ * Redraws the current Room. Caches of other baked Rooms are dropped, they will be baked again when needed.
+ */
 void Location::redraw()
 {
-	this->currentRoom->init();
+	for (auto it = this->bakedRooms.begin(); it != this->bakedRooms.end();)
+	{
+		if (it->second == this->currentRoom)
+		{
+			it->second->init(this->roomCachePool, this->roomBackCacheWriter);
+			it++;
+		}
+		else
+		{
+			it->second->deinit(this->roomCachePool);
+			it = this->bakedRooms.erase(it);
+		}
+	}
+}
+
+/**
+ * Redraws the current Room if it uses any of the textures. Caches of other baked Rooms which use any of the textures
+ * are dropped, they will be baked again when needed.
+ */
+void Location::redrawIfUsesTexture(const std::unordered_set<const sf::Texture*>& textures)
+{
+	for (auto it = this->bakedRooms.begin(); it != this->bakedRooms.end();)
+	{
+		if (!it->second->usesTexture(textures))
+		{
+			it++;
+		}
+		else if (it->second == this->currentRoom)
+		{
+			it->second->init(this->roomCachePool, this->roomBackCacheWriter);
+			it++;
+		}
+		else
+		{
+			it->second->deinit(this->roomCachePool);
+			it = this->bakedRooms.erase(it);
+		}
+	}
 }
 
 sf::Vector2u Location::getSpawnCoords() const
@@ -617,6 +1940,22 @@ void Location::tick(uint lastFrameDurationUs)
 {
 	if (!this->roomTransitionInProgress)
 	{
+		// content was loaded, but the current Room is not baked yet (see ::bakeCurrentRoom())
+		if (!this->currentRoom->isBaked())
+			this->bakeCurrentRoom();
+
+		this->bakeNearRoom();
+
+		// Room requested via ::gotoRoom() was loaded in the background. it's only entered once it's baked as well,
+		// until then it stays pending
+		if (this->roomChangePending && this->isRoomReady(this->pendingRoomCoords))
+		{
+			const HashableVector3i pendingCoords = this->pendingRoomCoords;
+			this->gotoRoom(pendingCoords);
+			if (!this->roomChangePending)
+				return;
+		}
+
 		this->currentRoom->tick(lastFrameDurationUs);
 
 		// check if the player has walked into screen edge.
@@ -714,10 +2053,40 @@ void Location::setRoomLightsState(enum LightObjectsState state)
 	this->currentRoom->setLightsState(state);
 }
 
+/**
+ * Sets up the full background, using a variant of the texture downscaled to match current size of the game world
+ * viewport (see ResourceManager::getWorldDownscale()). The background is uploaded tile by tile over the next frames
+ * (see ResourceManager::getTiledTexture()).
+ *
+ * @param resMgr reference to Resource Manager
+ */
+void Location::setupBackgroundFull(ResourceManager& resMgr)
+{
+	this->backgroundFullDownscale = resMgr.getWorldDownscale();
+	this->backgroundFull = resMgr.getTiledTexture(this->backgroundFullPath, this->backgroundFullDownscale);
+}
+
+/**
+ * Switches the full background to a variant matching current size of the game world viewport, if it has changed
+ * since the background was set up.
+ *
+ * @param resMgr reference to Resource Manager
+ * @return true if the background was switched
+ */
+bool Location::updateBackgroundFull(ResourceManager& resMgr)
+{
+	if (this->backgroundFullPath.empty() || this->backgroundFullDownscale == resMgr.getWorldDownscale())
+		return false;
+
+	this->setupBackgroundFull(resMgr);
+	return true;
+}
+
 void Location::draw(sf::RenderTarget& target, sf::RenderStates states) const
 {
 	// background full is drawn the same during transition and regular gameplay - it's "far away" so it shouldn't move
-	target.draw(this->backgroundFullSprite, states); // note: can be empty
+	if (this->backgroundFull != nullptr)
+		target.draw(*this->backgroundFull, states); // note: can be empty
 
 	if (!this->roomTransitionInProgress)
 	{
@@ -4,11 +4,19 @@
 
 #pragma once
 
+#include <cstdint>
+
+#include <list>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include <SFML/Graphics/Drawable.hpp>
+#include <SFML/Graphics/RenderTexture.hpp>
 #include <SFML/Graphics/Sprite.hpp>
 #include <SFML/Graphics/Texture.hpp>
 #include <SFML/System/Clock.hpp>
@@ -19,11 +27,38 @@
 #include "../materials/material_manager.hpp"
 #include "../objects/object_manager.hpp"
 #include "../resources/resource_manager.hpp"
-#include "../resources/sprite_resource.hpp"
+#include "../resources/tiled_texture.hpp"
+#include "../util/mapped_file.hpp"
+#include "room_cache_pool.hpp"
+#include "room_colliders.hpp"
 #include "room_grid.hpp"
+#include "room_streamer.hpp"
+#include "room_template.hpp"
+#include "room_template_cache.hpp"
 
 constexpr uint REC_LVL_EMPTY = -1;
 
+// location of a single Room's template data inside the compiled rooms file
+struct compiled_room_entry
+{
+		std::uint64_t templateHash;
+		std::uint64_t offset;
+		std::uint64_t size;
+};
+
+// coordinates and templates of all Rooms of a Location, see Location::writeCompiledRooms()
+using room_table = std::vector<std::pair<HashableVector3i, std::shared_ptr<const RoomTemplate>>>;
+
+using room_colliders_map = std::unordered_map<HashableVector3i, RoomColliders, Vector3Hasher<int>>;
+
+// result of validating Location content, see Location::validateContent()
+struct location_validation
+{
+		bool valid = false;
+		std::size_t roomCnt = 0;
+		std::vector<HashableVector3i> unreachableRooms;
+};
+
 /**
  * Location represents a collection of Rooms connected to each other. Player is able to move between Rooms belonging to
  * the same Location.
@@ -45,22 +80,29 @@ constexpr uint REC_LVL_EMPTY = -1;
  * to textures needed to draw the Room. This means that all required textures are being loaded when loading the
  * Location, NOT when switching to a particular Room, to minimize the delay when switching Rooms.
  *
- * Second, result of drawing static Room elements (cells and big static elements) is cached in a texture
- * (::roomStaticTxt). Location keeps this texture, on which the current Room is rendered via ::draw(). The whole Room is
- * rendered only once, when entering the Room, and then the cached texture is displayed on each frame. We can do that,
- * because static elements rarely change appearance, so on each frame most of them would have been drawn exactly the
- * same. When a cell (or other static element) is damaged/destroyed/etc, Room's ::redrawCell() is called and only
- * redraws the cell that changed on the cached texture.
+ * Second, result of drawing static Room elements (cells and big static elements) is cached in render textures. Location
+ * keeps a pool of these textures (::roomCachePool), which Rooms borrow when they're baked (see Room::init()). The whole
+ * Room is rendered only once, and then the cached textures are displayed on each frame. We can do that, because static
+ * elements rarely change appearance, so on each frame most of them would have been drawn exactly the same. When a cell
+ * (or other static element) is damaged/destroyed/etc, Room's ::redrawCell() is called and only redraws the cell that
+ * changed on the cached texture. Caches of recently entered Rooms are kept (::bakedRooms), up to
+ * SettingsManager::roomCacheBudgetMb, so going back to a Room doesn't need to render it again. Rooms adjacent to the
+ * current Room are also baked ahead of time, a few stages per frame (see ::bakeNearRoom()), so that entering them is
+ * usually instant. A Room which is not baked yet is never entered, the Player waits at the edge of the current Room
+ * until it's baked instead.
  *
  * Location is responsible for animating room transition. For this purpose, it uses the internal state flag
  * ::roomTransitionInProgress (separate from global GameState). When room change is initiated (via ::gotoRoom()),
- * the old room, along with new room, are both rendered into a caching texture (::roomTransitionTxt), which is displayed
- * instead of room during the transition. The caching texture is moved during the animation to create a linear
+ * the old room, along with new room, are both rendered into a caching texture (::roomTransitionRender), which is
+ * displayed instead of room during the transition. The caching texture is moved during the animation to create a linear
  * transition effect. When the animation finishes, Location returns to displaying the current room. During the
  * animation, the simulation state is not being updated.
  *
- * TODO? the current concept of loading resources could potentially be optimized memory-wise, i.e. we could preload
- * resources only for nearby Rooms, instead of all Rooms in the Location. This would have to be done in the background.
+ * Keeping all Rooms loaded (along with their textures) can consume a lot of memory in large Locations, while we really
+ * only need one. Because of this, when SettingsManager::maxLoadedRooms is set, only the current Room and Rooms near it
+ * are kept loaded. Rooms adjacent to the current Room are loaded in the background (see ::updateLoadedRooms()), so
+ * moving between Rooms is usually still instant. Only the light-weight room table of the compiled rooms file (see
+ * ::openCompiledRooms()) is kept in memory for the whole Location.
  *
  * TODO inherit UniqueLocation and GeneratedLocation
  */
@@ -75,12 +117,31 @@ class Location : public sf::Drawable
 		std::string worldMapIconId;
 		bool worldMapIconBig = false;
 		bool grind;
+		std::uint64_t mirrorSeed = 0;
 		bool basecamp;
 		uint recommendedLevel = REC_LVL_EMPTY;
-		SpriteResource backgroundFullSprite;
+		std::string backgroundFullPath;
+		std::shared_ptr<TiledTexture> backgroundFull = nullptr;
+		uint backgroundFullDownscale = 1; // world downscale the background was set up for, see ::setupBackgroundFull()
 		RoomGrid rooms;
+		RoomCachePool roomCachePool;
+		RoomBackCacheWriter roomBackCacheWriter;
+		std::list<std::pair<HashableVector3i, std::shared_ptr<Room>>> bakedRooms; // most recently entered first
 		std::shared_ptr<Room> currentRoom = nullptr;
 		Player& player;
+		ResourceManager* resMgr = nullptr; // set while content is loaded
+
+		// only used when not all Rooms are kept loaded. the streamer must be declared after the compiled rooms file,
+		// so that it's destroyed (and its thread stopped) before the file is unmapped
+		MappedFile compiledRoomsFile;
+		std::unordered_map<HashableVector3i, struct compiled_room_entry, Vector3Hasher<int>> compiledRoomsIndex;
+		std::mutex roomStatesMutex; // states are restored on the streamer thread
+		std::unordered_map<HashableVector3i, struct room_state, Vector3Hasher<int>> roomStates; // of unloaded Rooms
+		RoomStreamer roomStreamer;
+		bool roomChangePending = false; // see ::gotoRoom()
+		HashableVector3i pendingRoomCoords;
+		bool roomBakeRequested = false; // the Player is waiting for a Room to be baked, see ::gotoRoom()
+		HashableVector3i requestedBakeCoords;
 
 		// room transition is *not* another GameState (see ::gameState in main), but rather an internal state of
 		// Location. from main's perspective, the state could be still STATE_PLAYING, but the Location, instead of
@@ -90,16 +151,52 @@ class Location : public sf::Drawable
 		enum Direction roomTransitionDirection;
 		uint roomTransitionOffset = 0;
 		sf::Clock roomTransitionTimer;
-		sf::Texture roomTransitionTxt;
+		std::unique_ptr<sf::RenderTexture> roomTransitionRender = nullptr; // created on first transition
 		sf::Sprite roomTransitionSprite;
 
-		bool validateRoomGeometry(const std::shared_ptr<Room>& room, const HashableVector3i& roomCoords) const;
+		bool loadJsonRooms(ResourceManager& resMgr, const MaterialManager& matMgr, const ObjectManager& objMgr,
+						   RoomTemplateCache& roomTemplates, HashableVector3i& startRoomCoords, room_table& roomTable,
+						   bool keepAllRooms);
+		bool getCompiledRoomsKey(std::uint64_t& key) const;
+		std::string getCompiledRoomsPath() const;
+		bool openCompiledRooms(std::uint64_t key, HashableVector3i& startRoomCoords);
+		void closeCompiledRooms();
+		std::shared_ptr<const RoomTemplate> loadCompiledTemplate(const struct compiled_room_entry& entry,
+																 RoomTemplateCache& roomTemplates) const;
+		std::shared_ptr<Room> loadCompiledRoom(const HashableVector3i& coords, ResourceManager& resMgr,
+											   const MaterialManager& matMgr, const ObjectManager& objMgr,
+											   RoomTemplateCache& roomTemplates) const;
+		bool loadAllCompiledRooms(ResourceManager& resMgr, const MaterialManager& matMgr, const ObjectManager& objMgr,
+								  RoomTemplateCache& roomTemplates);
+		void writeCompiledRooms(std::uint64_t key, const HashableVector3i& startRoomCoords,
+								const room_table& roomTable) const;
+		bool isRoomMirrored(const HashableVector3i& coords) const;
+		static bool validateRoomGeometry(const HashableVector3i& roomCoords, const room_colliders_map& colliders);
+		bool areRoomsConnected(const HashableVector3i& coords, Direction direction) const;
+		std::vector<HashableVector3i> findUnreachableRooms(const HashableVector3i& startRoomCoords) const;
+		void collectStreamedRooms();
+		void setupBackgroundFull(ResourceManager& resMgr);
+		bool isRoomReady(const HashableVector3i& coords);
+		void restoreRoomState(const HashableVector3i& coords, Room& room, ResourceManager& resMgr,
+							  const ObjectManager& objMgr);
+		void updateLoadedRooms();
+		std::size_t getMaxBakedRooms() const;
+		void bakeNearRoom();
+		void trimRoomCaches();
+		bool isLoadCancelled() const;
 
 	public:
 		Location(const std::string& id, Player& player);
 		bool loadMeta(const nlohmann::json& locMetaNode, const std::string& campaignDir);
-		bool loadContent(ResourceManager& resMgr, const MaterialManager& matMgr, const ObjectManager& objMgr);
+		bool loadContent(ResourceManager& resMgr, const MaterialManager& matMgr, const ObjectManager& objMgr,
+						 RoomTemplateCache& roomTemplates);
+		bool reloadChangedRooms(ResourceManager& resMgr, const MaterialManager& matMgr, const ObjectManager& objMgr,
+								RoomTemplateCache& roomTemplates);
+		bool validateContent(ResourceManager& resMgr, const MaterialManager& matMgr, const ObjectManager& objMgr,
+							 RoomTemplateCache& roomTemplates, struct location_validation& result);
 		void unloadContent();
+		bool isContentLoaded() const;
+		std::string getRoomDataPath() const;
 		std::string getId() const;
 		std::string getTitle() const;
 		std::string getDescription() const;
@@ -110,7 +207,10 @@ class Location : public sf::Drawable
 		std::string getWorldMapIconId() const;
 		bool gotoRoom(Direction direction, sf::Vector2f newPlayerCoords);
 		bool gotoRoom(HashableVector3i coords);
+		void bakeCurrentRoom();
 		void redraw();
+		bool updateBackgroundFull(ResourceManager& resMgr);
+		void redrawIfUsesTexture(const std::unordered_set<const sf::Texture*>& textures);
 		sf::Vector3i getPlayerRoomCoords() const;
 		sf::Vector2u getSpawnCoords() const;
 		void tick(uint lastFrameDurationUs);
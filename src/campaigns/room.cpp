@@ -4,11 +4,21 @@
 
 #include "room.hpp"
 
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+
+#include <initializer_list>
 #include <memory>
 #include <string>
+#include <unordered_set>
+#include <utility>
 
+#include <SFML/Graphics/Image.hpp>
 #include <SFML/Graphics/Rect.hpp>
 #include <SFML/Graphics/RenderTexture.hpp>
+#include <SFML/Graphics/Sprite.hpp>
+#include <SFML/Graphics/Texture.hpp>
 
 #include "../consts.hpp"
 #include "../hud/log.hpp"
@@ -16,18 +26,19 @@
 #include "../settings/settings_manager.hpp"
 #include "../util/i18n.hpp"
 #include "../util/json.hpp"
+#include "../util/random.hpp"
+#include "../util/util.hpp"
+#include "cell_row_tokenizer.hpp"
+#include "room_back_cache.hpp"
 
-constexpr char ROOM_SYMBOL_SEPARATOR = '|';
-constexpr char ROOM_SYMBOL_EMPTY = '_';
-constexpr char ROOM_SYMBOL_UNKNOWN = '?';
-
-Room::Room(Player& player) : player(player)
+Room::Room(Player& player, std::uint64_t backCacheId) : backCacheId(backCacheId), player(player)
 {
 	// "The box is there for a reason. I like thinking inside of it. I feel safe in there."
 }
 
 /**
- * Loads the room data and stores it in this object.
+ * Loads the room data and sets up the Room. A new template (see RoomTemplate) is created from the data, so that other
+ * Rooms with identical data can be set up via ::instantiate(), without parsing the data again.
  *
  * Room node structure:
  * {
@@ -41,7 +52,7 @@ Room::Room(Player& player) : player(player)
  *	]
  * }
  *
- * The cell data is separated by ROOM_SYMBOL_SEPARATOR ('_'). Each cell is of 1 or more characters in length.
+ * The cell data is separated by ROOM_SYMBOL_SEPARATOR ('|'). Each cell is of 1 or more characters in length.
  * First character in a cell corresponds to a solid, and can be empty ('_').
  * Rest of the symbols define various elements, such as background, stairs, ladder, water.
  * The dimensions of cell grid are always 48x25 cells (including border cells).
@@ -53,80 +64,35 @@ Room::Room(Player& player) : player(player)
  * modifying rooms using only a text editor. It also makes it much easier to develop and debug the game, or tools used
  * for creating levels. Secondly, it makes it possible to track changes in data using version control, which is useful
  * for keeping file history, blaming, etc. This applies to all data files, but rooms are the most obvious candidate for
- * binarization as they are the largest in volume.
+ * binarization as they are the largest in volume. To get the best of both worlds, the json stays the source of truth,
+ * but a compiled (binary) version of all rooms in a location is generated automatically and used on subsequent loads
+ * (see RoomTemplate::loadCompiled() and Location::loadContent()).
  *
  * @param resMgr reference to Resource Manager
  * @param matMgr reference to Material Manager
  * @param objMgr reference to Object Manager
  * @param root reference to json node containing room data
  * @param filePath location file path, just for printing
+ * @param templateHash hash of room data (see RoomTemplate::getJsonHash())
+ * @param mirrored true if the Room should be mirrored (see ::instantiate()). The template is never mirrored
  * @returns true on load success
  * @returns false on load fail
  */
 bool Room::load(ResourceManager& resMgr, const MaterialManager& matMgr, const ObjectManager& objMgr,
-				const nlohmann::json& root, const std::string& filePath)
+				const nlohmann::json& root, const std::string& filePath, std::uint64_t templateHash, bool mirrored)
 {
-	///// room-wide backwall /////
-
-	// backwall can be empty
-	std::string backwallTxtPath;
-	parseJsonKey<std::string>(root, filePath, FOERR_JSON_KEY_BACKWALL, backwallTxtPath, true);
-	if (!backwallTxtPath.empty())
-	{
-		backwallTxtPath = pathCombine(PATH_TEXT_CELLS, backwallTxtPath + ".png");
-		std::shared_ptr<sf::Texture> backwallTxt = resMgr.getTexture(backwallTxtPath);
-		backwallTxt->setRepeated(true);
-		this->backwall.setTexture(backwallTxt);
-		this->backwall.setTextureRect({ 0, 0, static_cast<int>(GAME_AREA_WIDTH), static_cast<int>(GAME_AREA_HEIGHT) });
-		this->backwall.setColor(BACKWALL_COLOR);
-	}
-
-	///// room-wide liquid level /////
-
-	// if liquid level is defined and > 0, room is fully submerged to that level (counting from bottom, in cells).
-	// solids are also submerged
-	this->liquidLevelHeight = 0;
-	parseJsonKey<uint>(root, filePath, FOERR_JSON_KEY_LIQUID_LEVEL, this->liquidLevelHeight, true);
-	if (this->liquidLevelHeight > 0)
-	{
-		std::string liquidSymbolStr;
-		if (!parseJsonKey<std::string>(root, filePath, FOERR_JSON_KEY_LIQUID_SYMBOL, liquidSymbolStr))
-			return false;
-
-		if (liquidSymbolStr.length() != 1)
-		{
-			Log::e(STR_MAT_LOAD_KEY_NOT_1CHAR, liquidSymbolStr.c_str());
-			return false;
-		}
-
-		char liquidSymbol = liquidSymbolStr[0];
-
-		const struct material* liquidMat = matMgr.getOther(liquidSymbol);
-		if (liquidMat == nullptr || liquidMat->type != MAT_LIQUID)
-		{
-			Log::e(STR_MAT_MISSING_OR_WRONG_TYPE, liquidSymbol);
-			return false;
-		}
-
-		uint liquidLevelPx = CELL_SIDE_LEN * this->liquidLevelHeight;
-		this->liquid.setSize(sf::Vector2f(GAME_AREA_WIDTH, liquidLevelPx));
-		this->liquid.setPosition(0, GAME_AREA_HEIGHT - liquidLevelPx);
-		this->liquid.setFillColor(liquidMat->color);
-		this->liquidDelim.setTexture(resMgr.getTexture(liquidMat->textureDelimPath));
-		this->liquidDelim.setColor(RoomCell::liquidSpriteColor);
-	}
-
-	///// spawn coords /////
-
-	// spawn coords are usually only defined for the first room
-	parseJsonVector2Key<uint>(root, filePath, FOERR_JSON_KEY_SPAWN_COORDS, this->spawnCoords, true);
+	// the template can only be modified here, before it's shared with other Rooms
+	std::shared_ptr<RoomTemplate> newTemplate = std::make_shared<RoomTemplate>(templateHash);
+	if (!newTemplate->loadJson(root, filePath))
+		return false;
 
-	///// lights state override /////
+	this->roomTemplate = newTemplate;
+	this->lightsState = newTemplate->getLightsState();
+	this->mirrored = false;
+	this->cellMaterials.clear();
 
-	int lightsOn;
-	this->lightsState = LIGHTS_DEFAULT;
-	if (parseJsonKey<int>(root, filePath, FOERR_JSON_KEY_LIGHTS_ON, lightsOn, true))
-		this->lightsState = lonToLightObjectsState(lightsOn);
+	if (!this->setupRoomWide(resMgr, matMgr))
+		return false;
 
 	///// cells /////
 
@@ -150,13 +116,14 @@ bool Room::load(ResourceManager& resMgr, const MaterialManager& matMgr, const Ob
 		return false;
 	}
 
+	struct cell_row_tokens tokens;
 	for (auto it = cellsSearch->begin(); it != cellsSearch->end(); it++)
 	{
-		std::string line;
+		const std::string* line;
 
 		try
 		{
-			line = (*it);
+			line = &it->get_ref<const std::string&>();
 		}
 		catch (const nlohmann::json::type_error& ex)
 		{
@@ -165,64 +132,140 @@ bool Room::load(ResourceManager& resMgr, const MaterialManager& matMgr, const Ob
 		}
 
 		uint y = static_cast<uint>(std::distance(cellsSearch->begin(), it));
-		uint x = 0;
 
-		bool firstCellSymbol = true;
-		for (const auto symbol : line)
+		// separators are found for the whole row first, so each cell can be processed as a whole
+		tokenizeCellRow(line->data(), line->size(), tokens);
+
+		if (tokens.cellCnt > ROOM_WIDTH_WITH_BORDER)
 		{
-			if (symbol == ROOM_SYMBOL_SEPARATOR)
-			{
-				x++;
-				firstCellSymbol = true;
+			Log::e(STR_ROOM_ROW_TOO_LONG, filePath.c_str(), FOERR_JSON_KEY_CELLS.c_str(), y, ROOM_WIDTH_WITH_BORDER);
+			return false;
+		}
+
+		if (tokens.cellCnt < ROOM_WIDTH_WITH_BORDER)
+		{
+			Log::e(STR_ROOM_ROW_TOO_SHORT, filePath.c_str(), FOERR_JSON_KEY_CELLS.c_str(), y);
+			return false;
+		}
+
+		for (uint x = 0; x < ROOM_WIDTH_WITH_BORDER; x++)
+		{
+			const std::size_t cellBegin = tokens.cellBegins[x];
+			const std::size_t cellEnd = tokens.cellEnds[x];
+			if (cellBegin == cellEnd)
 				continue;
-			}
 
-			if (x >= ROOM_WIDTH_WITH_BORDER)
+			// first symbol (solid)
+			char symbol = (*line)[cellBegin];
+			enum CellSymbolClass symbolClass = getCellSymbolClass(symbol);
+			if (symbolClass == CELL_SYMBOL_UNKNOWN)
 			{
-				Log::w(STR_ROOM_LINE_TOO_LONG, filePath.c_str(), FOERR_JSON_KEY_CELLS.c_str(), ROOM_WIDTH_WITH_BORDER);
-				break;
+				Log::w(STR_UNKNOWN_SYMBOL_AT_POS, filePath.c_str(), FOERR_JSON_KEY_CELLS.c_str(), x, y);
 			}
-
-			if (firstCellSymbol)
+			else if (symbolClass != CELL_SYMBOL_EMPTY)
 			{
-				// first symbol (solid)
-				firstCellSymbol = false;
+				if (!this->cells[y][x].addSolidSymbol(symbol, this->cellMaterials, resMgr, matMgr))
+					return false;
+			}
 
-				// the cell needs to know its position to properly set texture rect, and to draw itself in correct place
-				this->cells[y][x].setPosition(x * CELL_SIDE_LEN, y * CELL_SIDE_LEN);
+			if (cellEnd - cellBegin == 1)
+				continue;
 
-				if (symbol == ROOM_SYMBOL_UNKNOWN)
-				{
-					Log::w(STR_UNKNOWN_SYMBOL_AT_POS, filePath.c_str(), FOERR_JSON_KEY_CELLS.c_str(), x, y);
-				}
-				else if (symbol != ROOM_SYMBOL_EMPTY)
-				{
-					if (!this->cells[y][x].addSolidSymbol(symbol, resMgr, matMgr))
-						return false;
-				}
-			}
-			else if (symbol != ROOM_SYMBOL_EMPTY)
-			{
-				// 2nd, 3rd, etc. symbol, not empty
+			// 2nd, 3rd, etc. symbol
 
-				// because we load cells Frgt/10 style (from the top to the bottom), we already know if a particular
-				// cell needs to draw ladder or liquid delim based on the cell above it.
-				// if y = 0 we don't want to draw delim
-				bool topBlocksLadderDelim = y == 0 || this->cells[y - 1][x].blocksBottomCellLadderDelim();
-				bool topBlocksLiquidDelim = y == 0 || this->cells[y - 1][x].blocksBottomCellLiquidDelim();
+			// because we load cells Frgt/10 style (from the top to the bottom), we already know if a particular
+			// cell needs to draw ladder or liquid delim based on the cell above it.
+			// if y = 0 we don't want to draw delim
+			bool topBlocksLadderDelim = y == 0 || this->cells[y - 1][x].blocksBottomCellLadderDelim();
+			bool topBlocksLiquidDelim = y == 0 || this->cells[y - 1][x].blocksBottomCellLiquidDelim();
 
-				if (symbol == ROOM_SYMBOL_UNKNOWN)
+			for (std::size_t i = cellBegin + 1; i < cellEnd; i++)
+			{
+				symbol = (*line)[i];
+				symbolClass = getCellSymbolClass(symbol);
+				if (symbolClass == CELL_SYMBOL_EMPTY)
+					continue;
+
+				if (symbolClass == CELL_SYMBOL_UNKNOWN)
 					Log::w(STR_UNKNOWN_SYMBOL_AT_POS, filePath.c_str(), FOERR_JSON_KEY_CELLS.c_str(), x, y);
-				else if (!this->cells[y][x].addOtherSymbol(symbol, topBlocksLadderDelim, topBlocksLiquidDelim, resMgr,
-														   matMgr))
+				else if (!this->cells[y][x].addOtherSymbol(symbol, topBlocksLadderDelim, topBlocksLiquidDelim,
+														   this->cellMaterials, resMgr, matMgr))
 					return false;
 			}
 		}
 
-		if (x != ROOM_WIDTH_WITH_BORDER - 1)
+		for (uint x = 0; x < ROOM_WIDTH_WITH_BORDER; x++)
 		{
-			Log::e(STR_ROOM_ROW_TOO_SHORT, filePath.c_str(), FOERR_JSON_KEY_CELLS.c_str(), y);
-			return false;
+			if (!this->cells[y][x].finishSetup())
+				return false;
+
+			newTemplate->setCellSymbols(x, y, this->cells[y][x].getSymbols(this->cellMaterials));
+		}
+	}
+
+	if (mirrored)
+	{
+		// cells had to be parsed in the original order to create the template, so now set them up again, mirrored.
+		// this only happens for the first Room using a template, any other Rooms are instantiated right away
+		for (auto& row : this->cells)
+		{
+			for (auto& cell : row)
+			{
+				cell = RoomCell();
+			}
+		}
+
+		return this->instantiate(newTemplate, resMgr, matMgr, objMgr, true);
+	}
+
+	this->setupCachedBackObjects(resMgr, objMgr);
+
+	return true;
+}
+
+/**
+ * Sets up the Room based on a template of an already loaded Room. This is much quicker than loading the Room via
+ * ::load(), as room data doesn't need to be parsed again.
+ *
+ * The template is expected to have been validated when it was created, so the only checks performed are the ones
+ * needed to safely set up the room (e.g. materials still exist).
+ *
+ * The Room can also be mirrored horizontally, which is a cheap way to add variety to grind Locations. Cells are then
+ * read from the template right to left, stairs and ladders are flipped (see RoomCell::mirror()), and so are spawn
+ * coordinates and background objects. Render caches are drawn from the mirrored elements, so drawing a mirrored Room
+ * costs exactly the same.
+ *
+ * @param roomTemplate template to use
+ * @param resMgr reference to Resource Manager
+ * @param matMgr reference to Material Manager
+ * @param objMgr reference to Object Manager
+ * @param mirrored true if the Room should be mirrored horizontally
+ * @returns true on setup success
+ * @returns false on setup fail
+ */
+bool Room::instantiate(const std::shared_ptr<const RoomTemplate>& roomTemplate, ResourceManager& resMgr,
+					   const MaterialManager& matMgr, const ObjectManager& objMgr, bool mirrored)
+{
+	this->roomTemplate = roomTemplate;
+	this->lightsState = roomTemplate->getLightsState();
+	this->mirrored = mirrored;
+	this->cellMaterials.clear();
+
+	if (!this->setupRoomWide(resMgr, matMgr))
+		return false;
+
+	for (uint y = 0; y < ROOM_HEIGHT_WITH_BORDER; y++)
+	{
+		for (uint x = 0; x < ROOM_WIDTH_WITH_BORDER; x++)
+		{
+			const uint templateX = mirrored ? ROOM_WIDTH_WITH_BORDER - 1 - x : x;
+
+			if (!this->cells[y][x].loadSymbols(roomTemplate->getCellSymbols(templateX, y), this->cellMaterials, resMgr,
+											   matMgr))
+				return false;
+
+			if (mirrored)
+				this->cells[y][x].mirror();
 		}
 
 		for (auto& cell : this->cells[y])
@@ -232,76 +275,214 @@ bool Room::load(ResourceManager& resMgr, const MaterialManager& matMgr, const Ob
 		}
 	}
 
-	///// background objects /////
+	this->setupCachedBackObjects(resMgr, objMgr);
 
-	if (!Room::parseBackObjsNode(root, filePath, FOERR_JSON_KEY_BACK_OBJS, this->backObjectsData))
-		return false;
+	return true;
+}
 
-	if (!Room::parseBackObjsNode(root, filePath, FOERR_JSON_KEY_FAR_BACK_OBJS, this->backObjectsDataFar))
-		return false;
+bool Room::isMirrored() const
+{
+	return this->mirrored;
+}
 
-	if (!Room::parseBackObjsNode(root, filePath, FOERR_JSON_KEY_BACK_HOLES, this->backHoleObjectsData))
-		return false;
+/**
+ * Used to check if the Room needs to be redrawn after some textures were changed (see
+ * ResourceManager::reloadChangedTextures()).
+ *
+ * @param textures set of textures to look for
+ * @return true if any element of the Room uses any of the textures
+ */
+bool Room::usesTexture(const std::unordered_set<const sf::Texture*>& textures) const
+{
+	auto uses = [&textures](const sf::Sprite& sprite) { return textures.find(sprite.getTexture()) != textures.end(); };
+
+	if (uses(this->backwall) || uses(this->liquidDelim))
+		return true;
+
+	for (const std::vector<SpriteResource>* sprites :
+		 { &this->backObjectsMain, &this->farBackObjectsMain, &this->backHoleObjectsHoles })
+	{
+		for (const SpriteResource& sprite : *sprites)
+		{
+			if (uses(sprite))
+				return true;
+		}
+	}
+
+	for (const struct blend_sprite& sprite : this->backHoleObjectsMain)
+	{
+		if (uses(sprite.spriteRes))
+			return true;
+	}
+
+	return this->cellMaterials.usesTexture(textures);
+}
+
+/**
+ * @return template the Room was set up from
+ */
+const std::shared_ptr<const RoomTemplate>& Room::getTemplate() const
+{
+	return this->roomTemplate;
+}
+
+/**
+ * Sets up room-wide elements (backwall and liquid level) based on already loaded room data.
+ */
+bool Room::setupRoomWide(ResourceManager& resMgr, const MaterialManager& matMgr)
+{
+	const asset_id backwall = this->roomTemplate->getBackwall();
+	if (backwall != ASSET_ID_NONE)
+	{
+		this->backwall.setTexture(resMgr.getRepeatedTexture(backwall));
+		this->backwall.setTextureRect({ 0, 0, static_cast<int>(GAME_AREA_WIDTH), static_cast<int>(GAME_AREA_HEIGHT) });
+		this->backwall.setColor(BACKWALL_COLOR);
+	}
+
+	const uint liquidLevelHeight = this->roomTemplate->getLiquidLevelHeight();
+	if (liquidLevelHeight > 0)
+	{
+		const struct material* liquidMat = matMgr.getOther(this->roomTemplate->getLiquidSymbol());
+		if (liquidMat == nullptr || liquidMat->type != MAT_LIQUID)
+		{
+			Log::e(STR_MAT_MISSING_OR_WRONG_TYPE, this->roomTemplate->getLiquidSymbol());
+			return false;
+		}
 
-	this->setupAllBackObjects(resMgr, objMgr);
+		uint liquidLevelPx = CELL_SIDE_LEN * liquidLevelHeight;
+		this->liquid.setSize(sf::Vector2f(GAME_AREA_WIDTH, liquidLevelPx));
+		this->liquid.setPosition(0, GAME_AREA_HEIGHT - liquidLevelPx);
+		this->liquid.setFillColor(liquidMat->color);
+		this->liquidDelim.setTexture(resMgr.getTexture(liquidMat->textureDelim));
+		this->liquidDelim.setColor(RoomCell::liquidSpriteColor);
+	}
 
 	return true;
 }
 
+/**
+ * Sets up all background objects again, with newly randomized texture variants. Render caches need to be redrawn
+ * afterwards.
+ */
 void Room::setupAllBackObjects(ResourceManager& resMgr, const ObjectManager& objMgr)
 {
-	this->setupBackObjects(resMgr, objMgr, this->backObjectsData, this->backObjectsMain);
-	this->setupBackObjects(resMgr, objMgr, this->backObjectsDataFar, this->farBackObjectsMain);
-	this->setupBackHoleObjects(resMgr, objMgr);
+	this->variantSeed = static_cast<std::uint64_t>(Randomizer::getRandomBetween(0, INT_MAX));
+	this->stateChanged = true;
+	this->setupBackObjectVariants(resMgr, objMgr);
+}
+
+/**
+ * @return true if Room state was changed since the Room was loaded, i.e. it needs to be kept if the Room is unloaded
+ */
+bool Room::hasStateChanged() const
+{
+	return this->stateChanged;
+}
+
+struct room_state Room::getState() const
+{
+	return { this->lightsState, this->variantSeed };
+}
+
+/**
+ * Restores Room state saved before the Room was unloaded (see ::getState()). Should be called right after the Room is
+ * loaded, before it's baked.
+ */
+void Room::restoreState(const struct room_state& state, ResourceManager& resMgr, const ObjectManager& objMgr)
+{
+	this->lightsState = state.lightsState;
+	this->variantSeed = state.variantSeed;
+	this->stateChanged = true;
+	this->setupBackObjectVariants(resMgr, objMgr);
 }
 
 /**
- * Parses a json node containing a list of background objects and adds their data into ::dataVector.
- * @return true if parsing was successful
- * @return false if parsing resulted in an error
+ * Sets up all background objects, with texture variants picked the same way as when the cached background was drawn
+ * (see RoomBackCache), so that the cached background can be used. If the background is not cached, texture variants
+ * are randomized.
  */
-bool Room::parseBackObjsNode(const nlohmann::json& root, const std::string& filePath, const std::string& key,
-							 std::vector<struct back_obj_data>& dataVector)
+void Room::setupCachedBackObjects(ResourceManager& resMgr, const ObjectManager& objMgr)
 {
-	dataVector.clear();
+	if (!SettingsManager::roomBackCache ||
+		!RoomBackCache::loadSeed(this->backCacheId, this->variantSeed))
+		this->variantSeed = static_cast<std::uint64_t>(Randomizer::getRandomBetween(0, INT_MAX));
+
+	this->setupBackObjectVariants(resMgr, objMgr);
+}
 
-	auto bgObjsSearch = root.find(key);
-	if (bgObjsSearch == root.end())
+/**
+ * Sets up all background objects, with texture variants picked based on ::variantSeed.
+ */
+void Room::setupBackObjectVariants(ResourceManager& resMgr, const ObjectManager& objMgr)
+{
+	this->setupBackObjects(resMgr, objMgr, this->roomTemplate->getBackObjectsData(), this->backObjectsMain);
+	this->setupBackObjects(resMgr, objMgr, this->roomTemplate->getBackObjectsDataFar(), this->farBackObjectsMain);
+	this->setupBackHoleObjects(resMgr, objMgr);
+
+	// remember which textures are drawn on the background, so that the cached background is invalidated when any of
+	// them changes
+	std::unordered_set<const sf::Texture*> backTextures;
+	backTextures.insert(this->backwall.getTexture());
+	this->cellMaterials.collectBackgroundTextures(backTextures);
+
+	for (const std::vector<SpriteResource>* sprites :
+		 { &this->backObjectsMain, &this->farBackObjectsMain, &this->backHoleObjectsHoles })
 	{
-		// the room doesn't have to define any background objects under any key (this is not an error)
-		return true;
+		for (const SpriteResource& sprite : *sprites)
+		{
+			backTextures.insert(sprite.getTexture());
+		}
 	}
 
-	if (!bgObjsSearch->is_array())
+	for (const struct blend_sprite& sprite : this->backHoleObjectsMain)
 	{
-		Log::e(STR_INVALID_TYPE, filePath.c_str(), key.c_str());
-		return false;
+		backTextures.insert(sprite.spriteRes.getTexture());
 	}
 
-	for (const auto& backObjNode : *bgObjsSearch)
-	{
-		struct back_obj_data parsedNode;
+	this->backTexturePathIds = resMgr.getTexturePathIds(backTextures);
 
-		if (!parseJsonKey<std::string>(backObjNode, filePath, FOERR_JSON_KEY_ID, parsedNode.id))
-			return false;
+	if (!this->mirrored)
+		return;
 
-		if (!parseJsonVector2Key<uint>(backObjNode, filePath, FOERR_JSON_KEY_COORDS, parsedNode.coordinates))
-			return false;
+	for (auto& backObj : this->backObjectsMain)
+	{
+		mirrorHorizontally(backObj, GAME_AREA_WIDTH);
+	}
 
-		if (!parseJsonKey<int>(backObjNode, filePath, FOERR_JSON_KEY_VARIANT, parsedNode.variantIdx, true))
-			parsedNode.variantIdx = -1; // negative -> use random variant
+	for (auto& backObj : this->farBackObjectsMain)
+	{
+		mirrorHorizontally(backObj, GAME_AREA_WIDTH);
+	}
 
-		parsedNode.coordinates *= CELL_SIDE_LEN;
+	for (auto& backObj : this->backHoleObjectsMain)
+	{
+		mirrorHorizontally(backObj.spriteRes, GAME_AREA_WIDTH);
+	}
 
-		dataVector.push_back(parsedNode);
+	for (auto& backObj : this->backHoleObjectsHoles)
+	{
+		mirrorHorizontally(backObj, GAME_AREA_WIDTH);
 	}
+}
 
-	return true;
+/**
+ * Picks a texture variant for a background object. The same object (at the same position) always gets the same variant
+ * for the same seed, regardless of the order in which objects are set up.
+ *
+ * @return random number to pick the variant with
+ */
+static uint getVariantRoll(const struct back_obj_data& objData, std::uint64_t seed)
+{
+	std::uint64_t hash = hashBytes(reinterpret_cast<const char*>(&objData.id), sizeof(objData.id), seed);
+	hash = hashBytes(reinterpret_cast<const char*>(&objData.coordinates), sizeof(objData.coordinates), hash);
+
+	// FNV-1a mixes the lowest bits poorly, so use the higher ones
+	return static_cast<uint>(hash >> 32);
 }
 
 /**
- * Iterates over object data previously loaded via Room::parseBackObjsNode() and creates SpriteResources to draw.
- * Texture variants are randomized on every call.
+ * Iterates over object data previously loaded via RoomTemplate::loadJson() and creates SpriteResources to draw.
+ * Texture variants are picked based on ::variantSeed.
  */
 void Room::setupBackObjects(ResourceManager& resMgr, const ObjectManager& objMgr,
 							const std::vector<struct back_obj_data>& dataVector,
@@ -313,9 +494,10 @@ void Room::setupBackObjects(ResourceManager& resMgr, const ObjectManager& objMgr
 	{
 		SpriteResource backObjMain;
 		SpriteResource backObjLight;
-		if (!objMgr.setupBgSprites(backObjMain, backObjLight, resMgr, objData, this->lightsState))
+		if (!objMgr.setupBgSprites(backObjMain, backObjLight, resMgr, objData, this->lightsState,
+								   getVariantRoll(objData, this->variantSeed)))
 		{
-			Log::w(STR_BACK_OBJ_SETUP_FAIL, objData.id.c_str());
+			Log::w(STR_BACK_OBJ_SETUP_FAIL, AssetInterner::getString(objData.id).c_str());
 			continue;
 		}
 
@@ -334,23 +516,24 @@ void Room::setupBackObjects(ResourceManager& resMgr, const ObjectManager& objMgr
 }
 
 /**
- * Iterates over object data previously loaded via Room::parseBackObjsNode() and creates SpriteResources to draw.
- * Texture variants are randomized on every call.
+ * Iterates over object data previously loaded via RoomTemplate::loadJson() and creates SpriteResources to draw.
+ * Texture variants are picked based on ::variantSeed.
  */
 void Room::setupBackHoleObjects(ResourceManager& resMgr, const ObjectManager& objMgr)
 {
 	this->backHoleObjectsMain.clear();
 	this->backHoleObjectsHoles.clear();
 
-	for (const auto& objData : this->backHoleObjectsData)
+	for (const auto& objData : this->roomTemplate->getBackHoleObjectsData())
 	{
 		SpriteResource backObjMain;
 		SpriteResource backObjHole;
 		bool blend;
 
-		if (!objMgr.setupBgHoleSprites(backObjMain, backObjHole, blend, resMgr, objData))
+		if (!objMgr.setupBgHoleSprites(backObjMain, backObjHole, blend, resMgr, objData,
+									   getVariantRoll(objData, this->variantSeed)))
 		{
-			Log::w(STR_BACK_OBJ_SETUP_FAIL, objData.id.c_str());
+			Log::w(STR_BACK_OBJ_SETUP_FAIL, AssetInterner::getString(objData.id).c_str());
 			continue;
 		}
 
@@ -361,29 +544,20 @@ void Room::setupBackHoleObjects(ResourceManager& resMgr, const ObjectManager& ob
 }
 
 /**
- * Prepares the Room to be drawn.
- * Should be called *only once* per entering the Room. After that, use ::redrawCell() to update cells.
+ * Draws the background of the Room - backwall, cell backgrounds, and background objects.
+ *
+ * @param target render target to draw on
  */
-void Room::init()
+void Room::drawBack(sf::RenderTarget& target) const
 {
-	// TODO? calling the same nested loop multiple times is pretty lame, maybe find some better way to handle this.
-	// one possible improvement might be to draw on all three textures (i.e. back, front1, front2) simultaneously.
-	// this way we would only need two nested for loops. however, this approach would require having three
-	// RenderTextures, and would make the code much harder to understand, so let's skip it for now.
-
+	CellLayerMesh cellMesh;
 	sf::RenderStates states;
-	sf::RenderTexture tmpRender;
-	tmpRender.create(GAME_AREA_WIDTH, GAME_AREA_HEIGHT);
-
-	///// background cache /////
-
-	tmpRender.clear(sf::Color::Transparent);
 
 	// we could draw far back objects on another texture, along with background full, so that far back objects won't
 	// move during room transition. the current approach looks visually ok though, so let's keep it. as a bonus we don't
 	// have to add another caching texture.
 
-	tmpRender.draw(this->backwall); // can be empty
+	target.draw(this->backwall); // can be empty
 
 	// note: in Remains far back object drawing seems to work a bit differently: they seem to be drawn over cell
 	// backgrounds, but it makes little sense. in that case just use a regular, non-far back object. because of this,
@@ -391,17 +565,19 @@ void Room::init()
 	for (const auto& backObj : this->farBackObjectsMain)
 	{
 		// blend mode not supported for far back objects
-		tmpRender.draw(backObj);
+		target.draw(backObj);
 	}
 
 	for (uint y = 0; y < ROOM_HEIGHT_WITH_BORDER; y++)
 	{
 		for (uint x = 0; x < ROOM_WIDTH_WITH_BORDER; x++)
 		{
-			this->cells[y][x].drawBackground(tmpRender);
+			this->cells[y][x].addBackground(cellMesh, x, y, this->cellMaterials);
 		}
 	}
 
+	target.draw(cellMesh);
+
 	for (const auto& backObj : this->backHoleObjectsMain)
 	{
 		if (backObj.blend)
@@ -409,73 +585,205 @@ void Room::init()
 		else
 			states.blendMode = sf::BlendAlpha;
 
-		tmpRender.draw(backObj.spriteRes, states);
+		target.draw(backObj.spriteRes, states);
 	}
 
 	states.blendMode = BLEND_SUBTRACT_OR_SOMETHING;
 	for (const auto& backObj : this->backHoleObjectsHoles)
 	{
-		tmpRender.draw(backObj, states);
+		target.draw(backObj, states);
 	}
 
 	for (const auto& backObj : this->backObjectsMain)
 	{
-		tmpRender.draw(backObj);
+		target.draw(backObj);
+	}
+}
+
+/**
+ * Sets texture rects of all sprites to cover their whole textures. Sprites are set up when the Room is loaded, which
+ * can happen on another thread, where textures are not uploaded yet (see ResourceManager::getTexture()), so their
+ * rects would be empty. The backwall is skipped, as its rect doesn't depend on the texture size.
+ */
+void Room::resetTextureRects()
+{
+	this->liquidDelim.resetTextureRect();
+
+	for (std::vector<SpriteResource>* sprites :
+		 { &this->backObjectsMain, &this->farBackObjectsMain, &this->backHoleObjectsHoles })
+	{
+		for (SpriteResource& sprite : *sprites)
+		{
+			sprite.resetTextureRect();
+		}
+	}
+
+	for (struct blend_sprite& sprite : this->backHoleObjectsMain)
+	{
+		sprite.spriteRes.resetTextureRect();
+	}
+}
+
+/**
+ * @return true if any sprite of the Room has a texture, but an empty texture rect, i.e. it wouldn't be drawn at all
+ */
+bool Room::hasEmptySprites() const
+{
+	auto isEmpty = [](const sf::Sprite& sprite)
+	{
+		const sf::IntRect& rect = sprite.getTextureRect();
+		return sprite.getTexture() != nullptr && (rect.width == 0 || rect.height == 0);
+	};
+
+	if (isEmpty(this->liquidDelim))
+		return true;
+
+	for (const std::vector<SpriteResource>* sprites :
+		 { &this->backObjectsMain, &this->farBackObjectsMain, &this->backHoleObjectsHoles })
+	{
+		for (const SpriteResource& sprite : *sprites)
+		{
+			if (isEmpty(sprite))
+				return true;
+		}
+	}
+
+	for (const struct blend_sprite& sprite : this->backHoleObjectsMain)
+	{
+		if (isEmpty(sprite.spriteRes))
+			return true;
+	}
+
+	return false;
+}
+
+/**
+ * Draws the background cache - backwall, cell backgrounds, and background objects.
+ */
+void Room::bakeBack(RoomBackCacheWriter& backCacheWriter)
+{
+	sf::RenderTexture& backRender = this->caches->back;
+
+	// the background doesn't depend on Room state (e.g. destroyed cells), so once drawn, it's stored on disk and loaded
+	// as a single image next time, also in later game runs (see RoomBackCache)
+	const std::uint64_t backKey = RoomBackCache::getKey(this->roomTemplate->getHash(), this->mirrored,
+														this->lightsState, this->variantSeed,
+														this->backTexturePathIds);
+	sf::Image backImage;
+	sf::Texture backTexture;
+
+	backRender.clear(sf::Color::Transparent);
+
+	if (SettingsManager::roomBackCache &&
+		RoomBackCache::load(this->backCacheId, backKey, backImage) &&
+		backTexture.loadFromImage(backImage))
+	{
+		// copy the pixels as they are, the background was already blended when it was drawn
+		backRender.draw(sf::Sprite(backTexture), sf::RenderStates(sf::BlendNone));
+		backRender.display();
+	}
+	else
+	{
+		this->drawBack(backRender);
+		backRender.display();
+
+		// only reading the pixels back needs to be done here, they're encoded and written on another thread
+		if (SettingsManager::roomBackCache)
+			backCacheWriter.save(this->backCacheId, backKey, this->variantSeed,
+								 std::make_unique<sf::Image>(backRender.getTexture().copyToImage()));
 	}
 
-	tmpRender.display();
+	this->backCache.setTexture(backRender.getTexture());
+}
+
+/**
+ * Draws the front cache 1 - mutable elements behind the Player.
+ */
+void Room::bakeFront1()
+{
+	sf::RenderTexture& front1Render = this->caches->front1;
 
-	// sf::RenderTexture can't be a private member because it inherits NonCopyable.
-	// because of this we need to store the result in a standard sf::Texture
-	this->backCacheTxt = tmpRender.getTexture();
-	this->backCache.setTexture(this->backCacheTxt);
+	// TODO? calling the same nested loop multiple times is pretty lame, maybe find some better way to handle this.
+	// one possible improvement might be to draw on all three textures (i.e. back, front1, front2) simultaneously.
+	// this way we would only need two nested for loops. however, this approach would make the code much harder to
+	// understand, so let's skip it for now.
 
-	///// front cache 1 - behind the Player /////
+	// cells are not drawn one by one, each stage of all cells is batched into a single mesh instead, which takes only a
+	// few draw calls (one per texture). this matters a lot on slow (e.g. software) renderers
+	CellLayerMesh cellMesh;
 
-	tmpRender.clear(sf::Color::Transparent);
+	front1Render.clear(sf::Color::Transparent);
 
+	cellMesh.clear();
 	for (uint y = 0; y < ROOM_HEIGHT_WITH_BORDER; y++)
 	{
 		for (uint x = 0; x < ROOM_WIDTH_WITH_BORDER; x++)
 		{
-			this->cells[y][x].drawPlatform(tmpRender);
+			this->cells[y][x].addPlatform(cellMesh, x, y, this->cellMaterials);
 		}
 	}
 
+	front1Render.draw(cellMesh);
+
+	cellMesh.clear();
 	for (uint y = 0; y < ROOM_HEIGHT_WITH_BORDER; y++)
 	{
 		for (uint x = 0; x < ROOM_WIDTH_WITH_BORDER; x++)
 		{
-			this->cells[y][x].drawStairs(tmpRender);
+			this->cells[y][x].addStairs(cellMesh, x, y, this->cellMaterials);
 		}
 	}
 
-	tmpRender.display();
+	front1Render.draw(cellMesh);
+
+	front1Render.display();
+
+	this->frontCache1.setTexture(front1Render.getTexture());
+}
+
+/**
+ * Draws the front cache 2 - mutable elements before the Player.
+ */
+void Room::bakeFront2()
+{
+	sf::RenderTexture& front2Render = this->caches->front2;
+	CellLayerMesh cellMesh;
 
-	// again, can't keep sf::RenderTexture as a member (see above)
-	this->frontCache1Txt = tmpRender.getTexture();
-	this->frontCache1.setTexture(this->frontCache1Txt);
+	front2Render.clear(sf::Color::Transparent);
 
-	///// front cache 2 - before the Player /////
+	cellMesh.clear();
+	for (uint y = 0; y < ROOM_HEIGHT_WITH_BORDER; y++)
+	{
+		for (uint x = 0; x < ROOM_WIDTH_WITH_BORDER; x++)
+		{
+			this->cells[y][x].addLadder(cellMesh, x, y, this->cellMaterials);
+		}
+	}
 
-	tmpRender.clear(sf::Color::Transparent);
+	front2Render.draw(cellMesh);
 
+	cellMesh.clear();
 	for (uint y = 0; y < ROOM_HEIGHT_WITH_BORDER; y++)
 	{
 		for (uint x = 0; x < ROOM_WIDTH_WITH_BORDER; x++)
 		{
-			this->cells[y][x].drawLadder(tmpRender);
+			this->cells[y][x].addLiquid(cellMesh, x, y, this->cellMaterials);
 		}
 	}
 
+	front2Render.draw(cellMesh);
+
+	cellMesh.clear();
 	for (uint y = 0; y < ROOM_HEIGHT_WITH_BORDER; y++)
 	{
 		for (uint x = 0; x < ROOM_WIDTH_WITH_BORDER; x++)
 		{
-			this->cells[y][x].drawLiquidAndSolid(tmpRender);
+			this->cells[y][x].addSolid(cellMesh, x, y, this->cellMaterials);
 		}
 	}
 
+	front2Render.draw(cellMesh);
+
 	if (SettingsManager::debugBoundingBoxes)
 	{
 		// we draw this debug overlay on front cache, because we don't want it covered with front cache elements.
@@ -490,7 +798,7 @@ void Room::init()
 		{
 			debugBox.setPosition(backObj.getPosition());
 			debugBox.setSize({ backObj.getLocalBounds().width, backObj.getLocalBounds().height });
-			tmpRender.draw(debugBox);
+			front2Render.draw(debugBox);
 		}
 
 		debugBox.setOutlineColor(sf::Color::Red);
@@ -498,7 +806,7 @@ void Room::init()
 		{
 			debugBox.setPosition(backObj.spriteRes.getPosition());
 			debugBox.setSize({ backObj.spriteRes.getLocalBounds().width, backObj.spriteRes.getLocalBounds().height });
-			tmpRender.draw(debugBox);
+			front2Render.draw(debugBox);
 		}
 
 		debugBox.setOutlineColor(sf::Color::Cyan);
@@ -506,57 +814,151 @@ void Room::init()
 		{
 			debugBox.setPosition(backObj.getPosition());
 			debugBox.setSize({ backObj.getLocalBounds().width, backObj.getLocalBounds().height });
-			tmpRender.draw(debugBox);
+			front2Render.draw(debugBox);
 		}
 	}
 
-	tmpRender.display();
+	front2Render.display();
 
-	// again, can't keep sf::RenderTexture as a member (see above)
-	this->frontCache2Txt = tmpRender.getTexture();
-	this->frontCache2.setTexture(this->frontCache2Txt);
+	this->frontCache2.setTexture(front2Render.getTexture());
+}
 
-	///// room-wide liquid level /////
+/**
+ * Draws the room-wide liquid level.
+ */
+void Room::bakeLiquidLevel()
+{
+	sf::RenderTexture& liquidLevelRender = this->caches->liquidLevel;
+	sf::RenderStates states;
 
 	// we also need to pre-render liquid level. because of transparency and a sprite used for surface, the alpha will
 	// get messed up if we simply draw it on top of liquid level rectangle. to counter this, we use sf::BlendNone.
 	// but it would be difficult to use it along other elements (cells, backwall, etc.), therefore RenderTexture.
-	tmpRender.clear(sf::Color::Transparent);
+	liquidLevelRender.clear(sf::Color::Transparent);
 	states.blendMode = sf::BlendNone;
 
 	// liquid level rectangle
-	tmpRender.draw(this->liquid, states);
+	liquidLevelRender.draw(this->liquid, states);
 
 	// delims (surface)
-	if (this->liquidLevelHeight > 0 && this->liquidLevelHeight < ROOM_HEIGHT_WITH_BORDER)
+	const uint liquidLevelHeight = this->roomTemplate->getLiquidLevelHeight();
+	if (liquidLevelHeight > 0 && liquidLevelHeight < ROOM_HEIGHT_WITH_BORDER)
 	{
 		// we only need to check the row above room-wide water level
-		uint y = ROOM_HEIGHT_WITH_BORDER - this->liquidLevelHeight;
+		uint y = ROOM_HEIGHT_WITH_BORDER - liquidLevelHeight;
 		for (uint x = 0; x < ROOM_WIDTH_WITH_BORDER; x++)
 		{
 			if (!this->cells[y - 1][x].blocksBottomCellLiquidDelim() && !this->cells[y][x].getHasSolid())
 			{
 				this->liquidDelim.setPosition(x * CELL_SIDE_LEN, y * CELL_SIDE_LEN);
-				tmpRender.draw(this->liquidDelim, states);
+				liquidLevelRender.draw(this->liquidDelim, states);
 			}
 		}
 	}
 
-	// again, can't keep sf::RenderTexture as a member (see above)
-	this->cachedLiquidLevelTxt = tmpRender.getTexture();
-	this->cachedLiquidLevel.setTexture(this->cachedLiquidLevelTxt);
+	liquidLevelRender.display();
+	this->cachedLiquidLevel.setTexture(liquidLevelRender.getTexture());
+}
+
+/**
+ * Does the next stage of baking the Room, i.e. draws one of its render caches. Textures for the caches are borrowed
+ * from the pool in the first stage, and are kept until ::deinit() is called. Baking in stages allows spreading it over
+ * multiple frames (see Location::bakeNearRoom()). Has no effect if the Room is already baked.
+ *
+ * Must be called on the main thread, after textures used by the Room are uploaded (see
+ * ResourceManager::finishPendingTextures()).
+ *
+ * @param cachePool pool to borrow textures for render caches from
+ * @return true if the Room is baked now
+ */
+bool Room::bakeStep(RoomCachePool& cachePool, RoomBackCacheWriter& backCacheWriter)
+{
+	if (this->caches == nullptr)
+	{
+		// caches are drawn directly to render textures borrowed from the pool, so they don't need to be created or
+		// copied
+		this->caches = cachePool.acquire();
+		this->bakeStage = BAKE_STAGE_BACK;
+
+		// textures are uploaded by now, so sprites can finally get their proper size
+		this->resetTextureRects();
+	}
+
+	switch (this->bakeStage)
+	{
+		case BAKE_STAGE_BACK:
+			this->bakeBack(backCacheWriter);
+			this->bakeStage = BAKE_STAGE_FRONT1;
+			break;
+		case BAKE_STAGE_FRONT1:
+			this->bakeFront1();
+			this->bakeStage = BAKE_STAGE_FRONT2;
+			break;
+		case BAKE_STAGE_FRONT2:
+			this->bakeFront2();
+			this->bakeStage = BAKE_STAGE_LIQUID_LEVEL;
+			break;
+		case BAKE_STAGE_LIQUID_LEVEL:
+			this->bakeLiquidLevel();
+			this->bakeStage = BAKE_STAGE_DONE;
+			break;
+		case BAKE_STAGE_DONE:
+			break;
+	}
+
+	return this->bakeStage == BAKE_STAGE_DONE;
+}
+
+/**
+ * Prepares the Room to be drawn, by drawing all its render caches at once (see ::bakeStep()). Caches which were already
+ * drawn are drawn again.
+ * Should be called *only once* per entering the Room. After that, use ::redrawCell() to update cells.
+ *
+ * Must be called on the main thread, after textures used by the Room are uploaded (see
+ * ResourceManager::finishPendingTextures()).
+ *
+ * @param cachePool pool to borrow textures for render caches from
+ */
+void Room::init(RoomCachePool& cachePool, RoomBackCacheWriter& backCacheWriter)
+{
+	if (this->caches != nullptr)
+	{
+		this->bakeStage = BAKE_STAGE_BACK;
+		this->resetTextureRects();
+	}
+
+	while (!this->bakeStep(cachePool, backCacheWriter))
+	{
+	}
+}
+
+/**
+ * Gives back textures used for rendering the Room to the pool.
+ * Should be called when the Room's render caches are no longer needed (see Location::trimRoomCaches()).
+ *
+ * @param cachePool pool the textures were borrowed from in ::bakeStep()
+ */
+void Room::deinit(RoomCachePool& cachePool)
+{
+	cachePool.release(std::move(this->caches));
+	this->caches = nullptr;
+	this->bakeStage = BAKE_STAGE_BACK;
+}
+
+/**
+ * @return true if the Room holds render caches, i.e. it was initialized and can be drawn right away
+ */
+bool Room::isBaked() const
+{
+	return this->caches != nullptr && this->bakeStage == BAKE_STAGE_DONE;
 }
 
 /**
- * Clears cached textures used for rendering the Room.
- * Should be called when the Room is no longer displayed.
+ * @return true if the Room holds render caches, even if baking is not finished yet (see ::bakeStep())
  */
-void Room::deinit()
+bool Room::hasCaches() const
 {
-	this->backCacheTxt = sf::Texture();
-	this->frontCache1Txt = sf::Texture();
-	this->frontCache2Txt = sf::Texture();
-	this->cachedLiquidLevelTxt = sf::Texture();
+	return this->caches != nullptr;
 }
 
 /**
@@ -616,7 +1018,7 @@ void Room::tick(uint lastFrameDurationUs)
 				if (!cell.getIsCollider())
 					continue;
 
-				const sf::FloatRect& cellCollider = cell.getSolidCollider();
+				const sf::FloatRect cellCollider = cell.getSolidCollider(x, y);
 				sf::FloatRect intersection;
 
 				// TODO other types of colliders (stairs, platform)
@@ -655,7 +1057,7 @@ void Room::tick(uint lastFrameDurationUs)
 				if (!cell.getIsCollider())
 					continue;
 
-				const sf::FloatRect& cellCollider = cell.getSolidCollider();
+				const sf::FloatRect cellCollider = cell.getSolidCollider(x, y);
 				sf::FloatRect intersection;
 
 				// TODO other types of colliders (stairs, platform)
@@ -691,7 +1093,11 @@ void Room::tick(uint lastFrameDurationUs)
  */
 sf::Vector2u Room::getSpawnCoords() const
 {
-	return this->spawnCoords;
+	sf::Vector2u spawnCoords = this->roomTemplate->getSpawnCoords();
+	if (this->mirrored)
+		spawnCoords.x = ROOM_WIDTH_WITH_BORDER - 1 - spawnCoords.x;
+
+	return spawnCoords;
 }
 
 /**
@@ -715,9 +1121,25 @@ bool Room::isCellCollider(uint x, uint y) const
 	return this->cells[y][x].getHasSolid();
 }
 
+RoomColliders Room::getColliders() const
+{
+	RoomColliders colliders;
+
+	for (uint y = 0; y < ROOM_HEIGHT_WITH_BORDER; y++)
+	{
+		for (uint x = 0; x < ROOM_WIDTH_WITH_BORDER; x++)
+		{
+			colliders.setCellCollider(x, y, this->cells[y][x].getHasSolid());
+		}
+	}
+
+	return colliders;
+}
+
 void Room::setLightsState(enum LightObjectsState state)
 {
 	this->lightsState = state;
+	this->stateChanged = true;
 }
 
 /**
@@ -738,14 +1160,24 @@ void Room::redrawCell(uint x, uint y, sf::RenderTarget& target, sf::RenderStates
 		return;
 
 	const RoomCell* cell = &this->cells[y][x];
-	cell->drawPlatform(target);
-	cell->drawStairs(target);
-	cell->drawLadder(target);
-	cell->drawLiquidAndSolid(target);
+	CellLayerMesh cellMesh;
+
+	// stages are still drawn separately, so that they overlap in the right order
+	for (auto addStage : { &RoomCell::addPlatform, &RoomCell::addStairs, &RoomCell::addLadder, &RoomCell::addLiquid,
+						   &RoomCell::addSolid })
+	{
+		cellMesh.clear();
+		(cell->*addStage)(cellMesh, x, y, this->cellMaterials);
+		target.draw(cellMesh);
+	}
 }
 
 void Room::draw(sf::RenderTarget& target, sf::RenderStates states) const
 {
+	// sprites would point to textures which were given back to the pool
+	if (this->caches == nullptr)
+		return;
+
 	states.transform *= this->getTransform();
 
 	// because we render stuff first to RenderTexture, and then the texture to target, alpha gets blended two times,
@@ -764,7 +1196,7 @@ void Room::draw(sf::RenderTarget& target, sf::RenderStates states) const
 	// liquid is drawn over all cell elements, including solids
 	// liquids were also rendered to RenderTexture, but using sf::BlendNone, therefore the default blending mode works
 	// correctly here.
-	if (this->liquidLevelHeight > 0)
+	if (this->roomTemplate->getLiquidLevelHeight() > 0)
 	{
 		states.blendMode = sf::BlendAlpha;
 		target.draw(this->cachedLiquidLevel, states);
@@ -4,7 +4,11 @@
 
 #pragma once
 
+#include <cstdint>
+
+#include <memory>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 #include <SFML/Graphics/Drawable.hpp>
@@ -18,10 +22,11 @@
 #include "../objects/object_manager.hpp"
 #include "../resources/resource_manager.hpp"
 #include "../resources/sprite_resource.hpp"
+#include "room_back_cache.hpp"
+#include "room_cache_pool.hpp"
+#include "room_colliders.hpp"
 #include "room_cell.hpp"
-
-constexpr uint ROOM_WIDTH_WITH_BORDER = 48;
-constexpr uint ROOM_HEIGHT_WITH_BORDER = 25;
+#include "room_template.hpp"
 
 // that's the worst name ever for a struct
 struct blend_sprite
@@ -30,35 +35,59 @@ struct blend_sprite
 		bool blend;
 };
 
+/**
+ * Part of Room state which can be changed while playing. It's kept when the Room is unloaded, so that it can be
+ * restored after the Room is loaded again (see Location::updateLoadedRooms()).
+ *
+ * TODO cells, once they can be changed (e.g. destroyed)
+ */
+struct room_state
+{
+		enum LightObjectsState lightsState;
+		std::uint64_t variantSeed;
+};
+
+/**
+ * Render caches of a Room are drawn one by one, so that baking can be spread over multiple frames (see
+ * Room::bakeStep()).
+ */
+enum RoomBakeStage
+{
+	BAKE_STAGE_BACK,
+	BAKE_STAGE_FRONT1,
+	BAKE_STAGE_FRONT2,
+	BAKE_STAGE_LIQUID_LEVEL,
+	BAKE_STAGE_DONE,
+};
+
 /**
  * Room is a representation of a part of a location that fits on a single screen.
  *
- * TODO rooms CAN and WILL appear multiple times per location in grind locations, so it would be good to clone the
- * already loaded rooms when loading duplicate rooms, to avoid repeating the complicated loading process. Of course
- * the clone will need to go through rest of the setup separately (e.g. spawning objects).
+ * Rooms CAN and WILL appear multiple times per location in grind locations. To avoid repeating the complicated loading
+ * process, the immutable part of the Room is kept in a RoomTemplate, which is shared between all identical Rooms. The
+ * Room itself only holds its own state (cells, lights state, object variants).
  */
 class Room : public sf::Drawable, public sf::Transformable
 {
 	private:
+		std::shared_ptr<const RoomTemplate> roomTemplate = nullptr;
+		RoomCellMaterials cellMaterials;
 		RoomCell cells[ROOM_HEIGHT_WITH_BORDER][ROOM_WIDTH_WITH_BORDER];
 		SpriteResource backwall;
 		SpriteResource liquidDelim;
 		sf::RectangleShape liquid;
-		sf::Texture backCacheTxt;
-		sf::Texture frontCache1Txt;
-		sf::Texture frontCache2Txt;
-		sf::Sprite backCache; // immutable elements - background, room backwall, background objects
-		sf::Sprite frontCache1; // mutable elements behind the Player - stairs, platforms
-		sf::Sprite frontCache2; // mutable elements before the Player - solids, ladders, liquids
-		uint liquidLevelHeight;
-		sf::Texture cachedLiquidLevelTxt;
+		std::unique_ptr<struct room_caches> caches = nullptr; // borrowed from pool, see ::bakeStep()
+		enum RoomBakeStage bakeStage = BAKE_STAGE_BACK; // next cache to draw, only valid if caches are borrowed
+		sf::Sprite backCache;
+		sf::Sprite frontCache1;
+		sf::Sprite frontCache2;
 		sf::Sprite cachedLiquidLevel;
-		sf::Vector2u spawnCoords { ROOM_WIDTH_WITH_BORDER / 2, ROOM_HEIGHT_WITH_BORDER / 2 }; // Room center by default
 		enum LightObjectsState lightsState;
-
-		std::vector<struct back_obj_data> backObjectsData;
-		std::vector<struct back_obj_data> backObjectsDataFar;
-		std::vector<struct back_obj_data> backHoleObjectsData;
+		bool mirrored = false; // horizontally, see ::instantiate()
+		std::uint64_t variantSeed = 0; // background object variants are picked based on it, see ::setupBackObjects()
+		std::uint64_t backCacheId; // see RoomBackCache::getCacheId()
+		bool stateChanged = false; // since the Room was loaded, see ::getState()
+		std::vector<asset_id> backTexturePathIds; // textures drawn on background cache, see RoomBackCache::getKey()
 
 		std::vector<SpriteResource> backObjectsMain;
 		std::vector<SpriteResource> farBackObjectsMain;
@@ -67,25 +96,45 @@ class Room : public sf::Drawable, public sf::Transformable
 
 		Player& player;
 
-		// TODO void flip(); // for mirroring room vertically, only for grind maps. here "is_right" will become useful
-		static bool parseBackObjsNode(const nlohmann::json& root, const std::string& filePath, const std::string& key,
-									  std::vector<struct back_obj_data>& dataVector);
+		bool setupRoomWide(ResourceManager& resMgr, const MaterialManager& matMgr);
 		void setupBackObjects(ResourceManager& resMgr, const ObjectManager& objMgr,
 							  const std::vector<struct back_obj_data>& dataVector,
 							  std::vector<SpriteResource>& spriteVector);
 		void setupBackHoleObjects(ResourceManager& resMgr, const ObjectManager& objMgr);
+		void setupBackObjectVariants(ResourceManager& resMgr, const ObjectManager& objMgr);
+		void setupCachedBackObjects(ResourceManager& resMgr, const ObjectManager& objMgr);
+		void resetTextureRects();
+		void drawBack(sf::RenderTarget& target) const;
+		void bakeBack(RoomBackCacheWriter& backCacheWriter);
+		void bakeFront1();
+		void bakeFront2();
+		void bakeLiquidLevel();
 
 	public:
-		explicit Room(Player& player);
+		Room(Player& player, std::uint64_t backCacheId);
 		bool load(ResourceManager& resMgr, const MaterialManager& matMgr, const ObjectManager& objMgr,
-				  const nlohmann::json& root, const std::string& filePath);
-		void init();
-		void deinit();
+				  const nlohmann::json& root, const std::string& filePath, std::uint64_t templateHash,
+				  bool mirrored);
+		bool instantiate(const std::shared_ptr<const RoomTemplate>& roomTemplate, ResourceManager& resMgr,
+						 const MaterialManager& matMgr, const ObjectManager& objMgr, bool mirrored);
+		const std::shared_ptr<const RoomTemplate>& getTemplate() const;
+		bool isMirrored() const;
+		bool usesTexture(const std::unordered_set<const sf::Texture*>& textures) const;
+		bool hasEmptySprites() const;
+		bool bakeStep(RoomCachePool& cachePool, RoomBackCacheWriter& backCacheWriter);
+		void init(RoomCachePool& cachePool, RoomBackCacheWriter& backCacheWriter);
+		void deinit(RoomCachePool& cachePool);
+		bool isBaked() const;
+		bool hasCaches() const;
 		void tick(uint lastFrameDurationUs);
 		sf::Vector2u getSpawnCoords() const;
 		bool isCellCollider(uint x, uint y) const;
+		RoomColliders getColliders() const;
 		void setLightsState(enum LightObjectsState state);
 		void redrawCell(uint x, uint y, sf::RenderTarget& target, sf::RenderStates states) const; // TODO use me
 		void setupAllBackObjects(ResourceManager& resMgr, const ObjectManager& objMgr);
+		bool hasStateChanged() const;
+		struct room_state getState() const;
+		void restoreState(const struct room_state& state, ResourceManager& resMgr, const ObjectManager& objMgr);
 		void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
 };
@@ -0,0 +1,213 @@
+// SPDX-License-Identifier: GPL-3.0-only
+//
+// (c) 2024 h67ma <szycikm@gmail.com>
+
+#include "room_back_cache.hpp"
+
+#include <cstring>
+
+#include <utility>
+
+#include "../hud/log.hpp"
+#include "../resources/asset_archive.hpp"
+#include "../settings/settings_manager.hpp"
+#include "../util/binary_stream.hpp"
+#include "../util/i18n.hpp"
+#include "../util/mapped_file.hpp"
+#include "../util/qoi.hpp"
+#include "../util/util.hpp"
+#include "git_version.h"
+
+std::string RoomBackCache::getCachePath(std::uint64_t cacheId)
+{
+	return pathCombine(SettingsManager::getCacheDir(), "room_" + std::to_string(cacheId) + ".qoi");
+}
+
+/**
+ * Calculates the id of a Room's cache file. Rooms are identified by their position, not by their data, as identical
+ * Rooms need separate files to have different background object variants.
+ *
+ * @param roomDataPath path to the rooms file of the Location (see Location::getRoomDataPath())
+ * @param coords coordinates of the Room in the Location
+ * @return the id
+ */
+std::uint64_t RoomBackCache::getCacheId(const std::string& roomDataPath, HashableVector3i coords)
+{
+	const int coordsArr[] = { coords.x, coords.y, coords.z };
+
+	std::uint64_t hash = hashBytes(roomDataPath.c_str(), roomDataPath.size());
+	return hashBytes(reinterpret_cast<const char*>(coordsArr), sizeof(coordsArr), hash);
+}
+
+/**
+ * Calculates the key identifying the current version of a Room's background. The key changes whenever room data,
+ * background object variants, any of the textures, or the game itself changes.
+ *
+ * @param templateHash hash of room data (see RoomTemplate::getHash())
+ * @param mirrored true if the Room is mirrored
+ * @param lightsState current lights state of the Room, it affects background object variants
+ * @param variantSeed seed used to pick background object variants
+ * @param texturePathIds interned paths of all textures drawn on the background
+ * @return the key
+ */
+std::uint64_t RoomBackCache::getKey(std::uint64_t templateHash, bool mirrored, enum LightObjectsState lightsState,
+									std::uint64_t variantSeed, const std::vector<asset_id>& texturePathIds)
+{
+	std::uint64_t hash = hashBytes(reinterpret_cast<const char*>(&ROOM_BACK_CACHE_VERSION),
+								   sizeof(ROOM_BACK_CACHE_VERSION));
+	hash = hashBytes(GIT_VERSION, std::strlen(GIT_VERSION), hash);
+	hash = hashBytes(reinterpret_cast<const char*>(&templateHash), sizeof(templateHash), hash);
+	hash = hashBytes(reinterpret_cast<const char*>(&mirrored), sizeof(mirrored), hash);
+	hash = hashBytes(reinterpret_cast<const char*>(&lightsState), sizeof(lightsState), hash);
+	hash = hashBytes(reinterpret_cast<const char*>(&variantSeed), sizeof(variantSeed), hash);
+
+	// hashing contents of all textures would take longer than drawing the background, so just use size and
+	// modification time of their files, same as TextureCache does
+	for (asset_id pathId : texturePathIds)
+	{
+		const std::string& path = AssetInterner::getString(pathId);
+		std::uint64_t size = 0;
+		std::int64_t mtime = 0;
+		AssetArchive::getFileStamp(path, size, mtime);
+
+		hash = hashBytes(path.c_str(), path.size() + 1, hash);
+		hash = hashBytes(reinterpret_cast<const char*>(&size), sizeof(size), hash);
+		hash = hashBytes(reinterpret_cast<const char*>(&mtime), sizeof(mtime), hash);
+	}
+
+	return hash;
+}
+
+/**
+ * Reads the seed used to pick background object variants when the cached background was drawn. Can be called from
+ * multiple threads at the same time.
+ *
+ * @param cacheId id of the Room's cache file (see ::getCacheId())
+ * @param variantSeed the seed will be stored here
+ * @return true if the seed was read
+ * @return false if the background is not cached. Background object variants should be picked with a new seed then
+ */
+bool RoomBackCache::loadSeed(std::uint64_t cacheId, std::uint64_t& variantSeed)
+{
+	MappedFile cacheFile;
+	if (!cacheFile.open(RoomBackCache::getCachePath(cacheId)))
+		return false;
+
+	BinaryReader reader(cacheFile.getData(), cacheFile.getSize());
+	struct room_back_cache_header header;
+	if (!reader.read(header) || header.magic != ROOM_BACK_CACHE_MAGIC || header.version != ROOM_BACK_CACHE_VERSION)
+		return false;
+
+	variantSeed = header.variantSeed;
+	return true;
+}
+
+/**
+ * Loads a cached background, previously written with ::save().
+ *
+ * @param cacheId id of the Room's cache file (see ::getCacheId())
+ * @param key expected key (see ::getKey())
+ * @param image loaded image will be stored here
+ * @return true if the background was loaded from cache
+ * @return false if the background is not cached, or the cached version is outdated. It should be drawn then
+ */
+bool RoomBackCache::load(std::uint64_t cacheId, std::uint64_t key, sf::Image& image)
+{
+	MappedFile cacheFile;
+	if (!cacheFile.open(RoomBackCache::getCachePath(cacheId)))
+		return false;
+
+	BinaryReader reader(cacheFile.getData(), cacheFile.getSize());
+	struct room_back_cache_header header;
+	if (!reader.read(header) || header.magic != ROOM_BACK_CACHE_MAGIC || header.version != ROOM_BACK_CACHE_VERSION ||
+		header.key != key)
+		return false;
+
+	std::uint32_t width;
+	std::uint32_t height;
+	std::vector<std::uint8_t> pixels;
+	if (!qoiDecode(cacheFile.getData() + sizeof(header), cacheFile.getSize() - sizeof(header), width, height, pixels))
+		return false;
+
+	image.create(width, height, pixels.data());
+	return true;
+}
+
+/**
+ * Writes a drawn background to cache. Failing to write is not critical, the background will just be drawn again next
+ * time.
+ *
+ * @param cacheId id of the Room's cache file (see ::getCacheId())
+ * @param key key of the background (see ::getKey())
+ * @param variantSeed seed used to pick background object variants
+ * @param image drawn background
+ */
+void RoomBackCache::save(std::uint64_t cacheId, std::uint64_t key, std::uint64_t variantSeed, const sf::Image& image)
+{
+	struct room_back_cache_header header = { ROOM_BACK_CACHE_MAGIC, ROOM_BACK_CACHE_VERSION, key, variantSeed };
+
+	BinaryWriter writer;
+	writer.write(header);
+	qoiEncode(image.getPixelsPtr(), image.getSize().x, image.getSize().y, writer);
+
+	const std::string cachePath = RoomBackCache::getCachePath(cacheId);
+	if (!writer.saveToFile(cachePath))
+		Log::w(STR_ROOM_BACK_CACHE_WRITE_FAIL, cachePath.c_str());
+}
+
+RoomBackCacheWriter::~RoomBackCacheWriter()
+{
+	{
+		const std::lock_guard<std::mutex> lock(this->mutex);
+		this->stopRequested = true;
+	}
+
+	this->cond.notify_all();
+
+	if (this->worker.joinable())
+		this->worker.join();
+}
+
+/**
+ * Queues a drawn background to be written to cache (see RoomBackCache::save()).
+ *
+ * @param cacheId id of the Room's cache file (see RoomBackCache::getCacheId())
+ * @param key key of the background (see RoomBackCache::getKey())
+ * @param variantSeed seed used to pick background object variants
+ * @param image drawn background
+ */
+void RoomBackCacheWriter::save(std::uint64_t cacheId, std::uint64_t key, std::uint64_t variantSeed,
+							   std::unique_ptr<sf::Image> image)
+{
+	{
+		const std::lock_guard<std::mutex> lock(this->mutex);
+		this->queue.push_back({ cacheId, key, variantSeed, std::move(image) });
+	}
+
+	if (!this->worker.joinable())
+		this->worker = std::thread(&RoomBackCacheWriter::work, this);
+
+	this->cond.notify_one();
+}
+
+void RoomBackCacheWriter::work()
+{
+	while (true)
+	{
+		struct room_back_cache_write write;
+
+		{
+			std::unique_lock<std::mutex> lock(this->mutex);
+			this->cond.wait(lock, [this]() { return this->stopRequested || !this->queue.empty(); });
+
+			// queued backgrounds are written even if stop was requested, so that they're not drawn again next time
+			if (this->queue.empty())
+				return;
+
+			write = std::move(this->queue.front());
+			this->queue.pop_front();
+		}
+
+		RoomBackCache::save(write.cacheId, write.key, write.variantSeed, *write.image);
+	}
+}
@@ -0,0 +1,98 @@
+// SPDX-License-Identifier: GPL-3.0-only
+//
+// (c) 2024 h67ma <szycikm@gmail.com>
+
+#pragma once
+
+#include <cstdint>
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <SFML/Graphics/Image.hpp>
+
+#include "../objects/light_objects_state.hpp"
+#include "../resources/asset_interner.hpp"
+#include "../util/hashable_vector3.hpp"
+
+// cache files with a different magic or version are ignored (and overwritten)
+constexpr std::uint32_t ROOM_BACK_CACHE_MAGIC = 0x42524F46; // "FORB"
+constexpr std::uint32_t ROOM_BACK_CACHE_VERSION = 1;
+
+struct room_back_cache_header
+{
+		std::uint32_t magic;
+		std::uint32_t version;
+		std::uint64_t key; // see RoomBackCache::getKey()
+		std::uint64_t variantSeed;
+};
+
+// background waiting to be written, see RoomBackCacheWriter
+struct room_back_cache_write
+{
+		std::uint64_t cacheId;
+		std::uint64_t key;
+		std::uint64_t variantSeed;
+		std::unique_ptr<sf::Image> image; // sf::Image can't be moved, only copied
+};
+
+/**
+ * RoomBackCache stores baked background caches of Rooms (see Room::init()) in the cache dir, so that next time the Room
+ * is entered (also in another game run), the background can be loaded as a single image, instead of being drawn from
+ * all its elements again.
+ *
+ * The background only depends on room data, textures, and variants of background objects. Variants are picked based on
+ * a seed, which is stored along with the image, so that the Room can use the same seed when it's set up again (see
+ * Room::setupCachedBackObjects()). Cached images are validated against a key calculated from all of those, and from the
+ * game version, so changing any of them automatically invalidates the cached version.
+ *
+ * Each Room has its own cache file, identified by the Location and the Room coordinates (see ::getCacheId()), so
+ * identical Rooms (e.g. in grind Locations) can still have different background object variants.
+ *
+ * Cache file structure (native byte order):
+ *   - header (see struct room_back_cache_header)
+ *   - the image, encoded as QOI
+ *
+ * Can be disabled via SettingsManager::roomBackCache.
+ */
+class RoomBackCache
+{
+	private:
+		static std::string getCachePath(std::uint64_t cacheId);
+
+	public:
+		static std::uint64_t getCacheId(const std::string& roomDataPath, HashableVector3i coords);
+		static std::uint64_t getKey(std::uint64_t templateHash, bool mirrored, enum LightObjectsState lightsState,
+									std::uint64_t variantSeed, const std::vector<asset_id>& texturePathIds);
+		static bool loadSeed(std::uint64_t cacheId, std::uint64_t& variantSeed);
+		static bool load(std::uint64_t cacheId, std::uint64_t key, sf::Image& image);
+		static void save(std::uint64_t cacheId, std::uint64_t key, std::uint64_t variantSeed, const sf::Image& image);
+};
+
+/**
+ * RoomBackCacheWriter writes drawn backgrounds to RoomBackCache on a background thread, so that encoding and writing
+ * them doesn't stall the main thread. Only reading the background back from the render texture (see
+ * sf::Texture::copyToImage()) needs to be done on the main thread.
+ *
+ * The thread is started with the first write. Queued backgrounds are still written when the writer is destroyed.
+ */
+class RoomBackCacheWriter
+{
+	private:
+		std::thread worker;
+		std::mutex mutex;
+		std::condition_variable cond;
+		bool stopRequested = false;
+		std::deque<struct room_back_cache_write> queue;
+		void work();
+
+	public:
+		~RoomBackCacheWriter();
+		void save(std::uint64_t cacheId, std::uint64_t key, std::uint64_t variantSeed,
+				  std::unique_ptr<sf::Image> image);
+};
@@ -0,0 +1,59 @@
+// SPDX-License-Identifier: GPL-3.0-only
+//
+// (c) 2024 h67ma <szycikm@gmail.com>
+
+#include "room_cache_pool.hpp"
+
+#include <initializer_list>
+#include <utility>
+
+/**
+ * Borrows a set of render caches from the pool. If there are no free caches, a new set is created.
+ *
+ * Contents of the caches are undefined, they need to be cleared before drawing.
+ *
+ * @return render caches, should be given back via ::release() when not needed anymore
+ */
+std::unique_ptr<struct room_caches> RoomCachePool::acquire()
+{
+	if (!this->freeCaches.empty())
+	{
+		std::unique_ptr<struct room_caches> caches = std::move(this->freeCaches.back());
+		this->freeCaches.pop_back();
+		return caches;
+	}
+
+	std::unique_ptr<struct room_caches> caches = std::make_unique<struct room_caches>();
+	for (sf::RenderTexture* cache : { &caches->back, &caches->front1, &caches->front2, &caches->liquidLevel })
+	{
+		cache->create(GAME_AREA_WIDTH, GAME_AREA_HEIGHT);
+	}
+
+	return caches;
+}
+
+/**
+ * Gives back render caches borrowed via ::acquire(), so that they can be reused by another Room.
+ */
+void RoomCachePool::release(std::unique_ptr<struct room_caches> caches)
+{
+	if (caches != nullptr)
+		this->freeCaches.push_back(std::move(caches));
+}
+
+/**
+ * Frees render caches which are not borrowed by any Room, so that no more than maxFree sets are kept.
+ */
+void RoomCachePool::shrink(std::size_t maxFree)
+{
+	if (this->freeCaches.size() > maxFree)
+		this->freeCaches.resize(maxFree);
+}
+
+/**
+ * Frees all render caches which are not borrowed by any Room.
+ */
+void RoomCachePool::clear()
+{
+	this->freeCaches.clear();
+}
@@ -0,0 +1,49 @@
+// SPDX-License-Identifier: GPL-3.0-only
+//
+// (c) 2024 h67ma <szycikm@gmail.com>
+
+#pragma once
+
+#include <cstddef>
+
+#include <memory>
+#include <vector>
+
+#include <SFML/Graphics/RenderTexture.hpp>
+
+#include "../consts.hpp"
+
+// approximate GPU memory used by a single set of room caches (4 RGBA render textures)
+constexpr std::size_t ROOM_CACHES_SIZE =
+	4 * static_cast<std::size_t>(GAME_AREA_WIDTH) * static_cast<std::size_t>(GAME_AREA_HEIGHT) * 4;
+
+/**
+ * Render textures holding render caches of a single Room (see Room::init()).
+ */
+struct room_caches
+{
+		sf::RenderTexture back; // immutable elements - background, room backwall, background objects
+		sf::RenderTexture front1; // mutable elements behind the Player - stairs, platforms
+		sf::RenderTexture front2; // mutable elements before the Player - solids, ladders, liquids
+		sf::RenderTexture liquidLevel; // room-wide liquid level
+};
+
+/**
+ * Pool of Room render caches. Creating a render texture is expensive (it allocates GPU memory and a framebuffer), so
+ * instead of creating new render textures every time a Room is entered, Rooms borrow them from the pool, and give them
+ * back when they're not displayed anymore. Rooms draw directly to the borrowed render textures, so no texture copies
+ * are needed either.
+ *
+ * Render textures can only be created on the thread owning the window, so the pool must only be used there.
+ */
+class RoomCachePool
+{
+	private:
+		std::vector<std::unique_ptr<struct room_caches>> freeCaches;
+
+	public:
+		std::unique_ptr<struct room_caches> acquire();
+		void release(std::unique_ptr<struct room_caches> caches);
+		void shrink(std::size_t maxFree);
+		void clear();
+};
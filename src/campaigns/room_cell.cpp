@@ -4,22 +4,152 @@
 
 #include "room_cell.hpp"
 
-#include <memory>
+#include <initializer_list>
+#include <utility>
 
-#include <SFML/Graphics/RenderStates.hpp>
-#include <SFML/Graphics/Sprite.hpp>
+#include <SFML/Graphics/Texture.hpp>
 
 #include "../hud/log.hpp"
 #include "../util/i18n.hpp"
+#include "../util/util.hpp"
+#include "cell_row_tokenizer.hpp"
 
 const std::unordered_map<char, int> HEIGHT_FLAGS {
-	{ ',', CELL_SIDE_LEN * 0.25 }, // 3/4 height
-	{ ';', CELL_SIDE_LEN * 0.5 }, // 1/2 height
-	{ ':', CELL_SIDE_LEN * 0.75 } // 1/4 height
+	{ ROOM_SYMBOL_HEIGHT_3_4, CELL_SIDE_LEN * 0.25 },
+	{ ROOM_SYMBOL_HEIGHT_1_2, CELL_SIDE_LEN * 0.5 },
+	{ ROOM_SYMBOL_HEIGHT_1_4, CELL_SIDE_LEN * 0.75 }
 };
 
 const sf::Color RoomCell::liquidSpriteColor = sf::Color(255, 255, 255, LIQUID_OPACITY);
 
+RoomCellMaterials::RoomCellMaterials()
+{
+	this->clear();
+}
+
+/**
+ * Finds a solid material, and sets it up if it wasn't used in the Room yet.
+ *
+ * @param symbol material symbol
+ * @param resMgr reference to resource manager
+ * @param matMgr reference to material manager
+ * @return index of the material, or CELL_MATERIAL_NONE if the material doesn't exist or is not a solid
+ */
+uchar RoomCellMaterials::addSolid(char symbol, ResourceManager& resMgr, const MaterialManager& matMgr)
+{
+	uchar& idx = this->solidIndexes[static_cast<uchar>(symbol)];
+	if (idx != CELL_MATERIAL_NONE)
+		return idx;
+
+	const struct material* mat = matMgr.getSolid(symbol);
+	if (mat == nullptr || mat->type != MAT_SOLID)
+		return CELL_MATERIAL_NONE;
+
+	struct cell_material cellMat;
+	cellMat.symbol = symbol;
+	cellMat.type = mat->type;
+	cellMat.texture = resMgr.getRepeatedTexture(mat->texture);
+
+	// TODO mask will probably be handled elsewhere
+	if (mat->maskTexture != ASSET_ID_NONE)
+		cellMat.maskTexture = resMgr.getRepeatedTexture(mat->maskTexture);
+
+	idx = static_cast<uchar>(this->materials.size());
+	this->materials.push_back(cellMat);
+	return idx;
+}
+
+/**
+ * Finds a non-solid material, and sets it up if it wasn't used in the Room yet. Textures are set up depending on
+ * material type: elements contained within cell area use repeated textures, other elements use whole textures.
+ *
+ * @param symbol material symbol
+ * @param resMgr reference to resource manager
+ * @param matMgr reference to material manager
+ * @return index of the material, or CELL_MATERIAL_NONE if the material doesn't exist
+ */
+uchar RoomCellMaterials::addOther(char symbol, ResourceManager& resMgr, const MaterialManager& matMgr)
+{
+	uchar& idx = this->otherIndexes[static_cast<uchar>(symbol)];
+	if (idx != CELL_MATERIAL_NONE)
+		return idx;
+
+	const struct material* mat = matMgr.getOther(symbol);
+	if (mat == nullptr)
+		return CELL_MATERIAL_NONE;
+
+	struct cell_material cellMat;
+	cellMat.symbol = symbol;
+	cellMat.type = mat->type;
+	cellMat.offsetLeft = mat->offsetLeft;
+	cellMat.delimOffset = mat->delimOffset;
+	cellMat.color = mat->color;
+
+	if (mat->type == MAT_BG || mat->type == MAT_PLATFORM)
+	{
+		cellMat.texture = resMgr.getRepeatedTexture(mat->texture);
+	}
+	else if (mat->type == MAT_LADDER)
+	{
+		cellMat.texture = resMgr.getTexture(mat->texture);
+		cellMat.textureDelim = resMgr.getTexture(mat->textureDelim);
+	}
+	else if (mat->type == MAT_STAIRS)
+	{
+		cellMat.texture = resMgr.getTexture(mat->texture);
+	}
+	else if (mat->type == MAT_LIQUID)
+	{
+		cellMat.textureDelim = resMgr.getTexture(mat->textureDelim);
+	}
+
+	idx = static_cast<uchar>(this->materials.size());
+	this->materials.push_back(cellMat);
+	return idx;
+}
+
+const struct cell_material& RoomCellMaterials::get(uchar idx) const
+{
+	return this->materials[idx];
+}
+
+/**
+ * @param textures set of textures to look for
+ * @return true if any of the materials uses any of the textures
+ */
+bool RoomCellMaterials::usesTexture(const std::unordered_set<const sf::Texture*>& textures) const
+{
+	for (const struct cell_material& mat : this->materials)
+	{
+		for (const TextureResource* txt : { &mat.texture, &mat.textureDelim, &mat.maskTexture })
+		{
+			if (*txt != nullptr && textures.find(txt->get()) != textures.end())
+				return true;
+		}
+	}
+
+	return false;
+}
+
+/**
+ * @param textures textures of background materials will be added here
+ */
+void RoomCellMaterials::collectBackgroundTextures(std::unordered_set<const sf::Texture*>& textures) const
+{
+	for (const struct cell_material& mat : this->materials)
+	{
+		if (mat.type == MAT_BG && mat.texture != nullptr)
+			textures.insert(mat.texture.get());
+	}
+}
+
+void RoomCellMaterials::clear()
+{
+	this->materials.clear();
+	this->solidIndexes.fill(CELL_MATERIAL_NONE);
+	this->otherIndexes.fill(CELL_MATERIAL_NONE);
+}
+
 /**
  * @brief Adds a solid symbol to the cell
  * It is expected that the solid will be added to the cell before any other symbols.
@@ -29,45 +159,31 @@ const sf::Color RoomCell::liquidSpriteColor = sf::Color(255, 255, 255, LIQUID_OP
  *   2. Material exists and its type is solid
  *
  * @param symbol symbol character
+ * @param materials materials of the Room the cell belongs to
  * @param resMgr reference to resource manager
  * @param matMgr reference to material manager
  * @return true if the symbol was added successfully
  * @return false if the symbol cannot be added
  */
-bool RoomCell::addSolidSymbol(char symbol, ResourceManager& resMgr, const MaterialManager& matMgr)
+bool RoomCell::addSolidSymbol(char symbol, RoomCellMaterials& materials, ResourceManager& resMgr,
+							  const MaterialManager& matMgr)
 {
 	// check 1
-	if (this->hasSolid)
+	if (this->solid != CELL_MATERIAL_NONE)
 	{
 		Log::e(STR_MAT_SYMBOL_TYPE_ALREADY_PRESENT, symbol);
 		return false;
 	}
 
 	// check 2
-	const struct material* mat = matMgr.getSolid(symbol);
-	if (mat == nullptr || mat->type != MAT_SOLID)
+	const uchar matIdx = materials.addSolid(symbol, resMgr, matMgr);
+	if (matIdx == CELL_MATERIAL_NONE)
 	{
 		Log::e(STR_MAT_MISSING_OR_WRONG_TYPE, symbol);
 		return false;
 	}
 
-	std::shared_ptr<sf::Texture> txt = resMgr.getTexture(mat->texturePath);
-	if (txt != nullptr)
-		txt->setRepeated(true);
-
-	this->solid.setTexture(txt);
-
-	// TODO mask will probably be handled elsewhere
-	if (!mat->maskTexturePath.empty())
-	{
-		txt = resMgr.getTexture(mat->maskTexturePath);
-		if (txt != nullptr)
-			txt->setRepeated(true);
-
-		this->solidMask.setTexture(txt);
-	}
-
-	this->hasSolid = true;
+	this->solid = matIdx;
 	return true;
 }
 
@@ -95,20 +211,20 @@ bool RoomCell::addSolidSymbol(char symbol, ResourceManager& resMgr, const Materi
  * @param symbol symbol character
  * @param topCellBlocksLadderDelim whether the cell at (x, y-1) has blocked this cell from drawing ladder delim
  * @param topCellBlocksLiquidDelim whether the cell at (x, y-1) has blocked this cell from drawing water delim (surface)
+ * @param materials materials of the Room the cell belongs to
  * @param resMgr reference to resource manager
  * @param matMgr reference to material manager
  * @return true if the symbol was added successfully
  * @return false if the symbol cannot be added
  */
 bool RoomCell::addOtherSymbol(char symbol, bool topCellBlocksLadderDelim, bool topCellBlocksLiquidDelim,
-							  ResourceManager& resMgr, const MaterialManager& matMgr)
+							  RoomCellMaterials& materials, ResourceManager& resMgr, const MaterialManager& matMgr)
 {
 	// first check if symbol is a height flag, as it won't be present in mat mgr
-	auto heightFlagSearch = HEIGHT_FLAGS.find(symbol);
-	if (heightFlagSearch != HEIGHT_FLAGS.end())
+	if (getCellSymbolClass(symbol) == CELL_SYMBOL_HEIGHT_FLAG)
 	{
 		// check 1
-		if (!this->hasSolid)
+		if (this->solid == CELL_MATERIAL_NONE)
 		{
 			Log::w(STR_HEIGHT_FLAG_NO_SOLID, symbol);
 			return false;
@@ -117,7 +233,7 @@ bool RoomCell::addOtherSymbol(char symbol, bool topCellBlocksLadderDelim, bool t
 		// check 4 (part-height)
 		if (this->topOffset == 0)
 		{
-			this->topOffset = heightFlagSearch->second;
+			this->topOffset = static_cast<uchar>(HEIGHT_FLAGS.at(symbol));
 			return true;
 		}
 		else
@@ -128,134 +244,109 @@ bool RoomCell::addOtherSymbol(char symbol, bool topCellBlocksLadderDelim, bool t
 	}
 
 	// check 2
-	const struct material* mat = matMgr.getOther(symbol);
-	if (mat == nullptr)
+	const uchar matIdx = materials.addOther(symbol, resMgr, matMgr);
+	if (matIdx == CELL_MATERIAL_NONE)
 	{
 		Log::e(STR_MAT_MISSING_OR_WRONG_TYPE, symbol);
 		return false;
 	}
 
-	if (mat->type == MAT_BG)
+	const enum MaterialType type = materials.get(matIdx).type;
+	if (type == MAT_BG)
 	{
 		// check 4 (background)
-		if (this->hasBackground)
+		if (this->background != CELL_MATERIAL_NONE)
 		{
 			Log::e(STR_MAT_SYMBOL_TYPE_ALREADY_PRESENT, symbol);
 			return false;
 		}
 
-		std::shared_ptr<sf::Texture> txt = resMgr.getTexture(mat->texturePath);
-		if (txt != nullptr)
-			txt->setRepeated(true);
-
-		this->background.setTexture(txt);
-		this->background.setTextureRect({ static_cast<int>(this->getPosition().x),
-										  static_cast<int>(this->getPosition().y), CELL_SIDE_LEN, CELL_SIDE_LEN });
-		this->background.setColor(BACKWALL_COLOR); // darken background
-
-		this->hasBackground = true;
+		this->background = matIdx;
 	}
-	else if (mat->type == MAT_LADDER)
+	else if (type == MAT_LADDER)
 	{
 		// check 4 (ladder)
-		if (this->hasLadder)
+		if (this->ladder != CELL_MATERIAL_NONE)
 		{
 			Log::e(STR_MAT_SYMBOL_TYPE_ALREADY_PRESENT, symbol);
 			return false;
 		}
 
 		// check 5
-		if (this->hasSolid)
+		if (this->solid != CELL_MATERIAL_NONE)
 		{
 			Log::e(STR_SOLID_PRESENT_CANT_ADD, symbol);
 			return false;
 		}
 
-		this->ladder.setTexture(resMgr.getTexture(mat->texturePath));
-		this->ladder.setPosition({ static_cast<float>(mat->offsetLeft), 0 });
+		if (topCellBlocksLadderDelim)
+			this->flags |= CELL_FLAG_TOP_BLOCKS_LADDER_DELIM;
 
-		this->ladderDelim.setTexture(resMgr.getTexture(mat->textureDelimPath));
-		this->ladderDelim.setPosition(static_cast<sf::Vector2f>(mat->delimOffset));
-
-		this->topCellBlocksLadderDelim = topCellBlocksLadderDelim;
-		this->hasLadder = true;
+		this->ladder = matIdx;
 	}
-	else if (mat->type == MAT_PLATFORM)
+	else if (type == MAT_PLATFORM)
 	{
 		// check 4 (platform)
-		if (this->hasPlatform)
+		if (this->platform != CELL_MATERIAL_NONE)
 		{
 			Log::e(STR_MAT_SYMBOL_TYPE_ALREADY_PRESENT, symbol);
 			return false;
 		}
 
 		// check 6
-		if (this->hasSolid)
+		if (this->solid != CELL_MATERIAL_NONE)
 		{
 			Log::e(STR_SOLID_PRESENT_CANT_ADD, symbol);
 			return false;
 		}
 
 		// check 7
-		if (this->hasStairs)
+		if (this->stairs != CELL_MATERIAL_NONE)
 		{
 			Log::e(STR_STAIRS_PRESENT_CANT_ADD, symbol);
 			return false;
 		}
 
-		std::shared_ptr<sf::Texture> txt = resMgr.getTexture(mat->texturePath);
-		if (txt != nullptr)
-			txt->setRepeated(true);
-
-		this->platform.setTexture(txt);
-		this->platform.setTextureRect({ static_cast<int>(this->getPosition().x),
-										static_cast<int>(this->getPosition().y), CELL_SIDE_LEN, CELL_SIDE_LEN });
-
-		this->hasPlatform = true;
+		this->platform = matIdx;
 	}
-	else if (mat->type == MAT_STAIRS)
+	else if (type == MAT_STAIRS)
 	{
 		// check 4 (stairs)
-		if (this->hasStairs)
+		if (this->stairs != CELL_MATERIAL_NONE)
 		{
 			Log::e(STR_MAT_SYMBOL_TYPE_ALREADY_PRESENT, symbol);
 			return false;
 		}
 
 		// check 7
-		if (this->hasPlatform)
+		if (this->platform != CELL_MATERIAL_NONE)
 		{
 			Log::e(STR_PLATFORM_PRESENT_CANT_ADD, symbol);
 			return false;
 		}
 
 		// check 8
-		if (this->hasSolid)
+		if (this->solid != CELL_MATERIAL_NONE)
 		{
 			Log::e(STR_SOLID_PRESENT_CANT_ADD, symbol);
 			return false;
 		}
 
-		this->stairs.setTexture(resMgr.getTexture(mat->texturePath));
-		this->stairs.setPosition({ static_cast<float>(mat->offsetLeft), 0 });
-
-		this->hasStairs = true;
+		this->stairs = matIdx;
 	}
-	else if (mat->type == MAT_LIQUID)
+	else if (type == MAT_LIQUID)
 	{
 		// check 4 (liquid)
-		if (this->hasLiquid)
+		if (this->liquid != CELL_MATERIAL_NONE)
 		{
 			Log::e(STR_MAT_SYMBOL_TYPE_ALREADY_PRESENT, symbol);
 			return false;
 		}
 
-		this->liquidDelim.setTexture(resMgr.getTexture(mat->textureDelimPath));
-		this->liquidDelim.setColor(liquidSpriteColor);
+		if (topCellBlocksLiquidDelim)
+			this->flags |= CELL_FLAG_TOP_BLOCKS_LIQUID_DELIM;
 
-		this->topCellBlocksLiquidDelim = topCellBlocksLiquidDelim;
-		this->liquid.setFillColor(mat->color);
-		this->hasLiquid = true;
+		this->liquid = matIdx;
 	}
 	else
 	{
@@ -272,7 +363,7 @@ bool RoomCell::addOtherSymbol(char symbol, bool topCellBlocksLadderDelim, bool t
  */
 bool RoomCell::blocksBottomCellLadderDelim() const
 {
-	return this->hasLadder || this->hasSolid;
+	return this->ladder != CELL_MATERIAL_NONE || this->solid != CELL_MATERIAL_NONE;
 }
 
 /**
@@ -280,12 +371,12 @@ bool RoomCell::blocksBottomCellLadderDelim() const
  */
 bool RoomCell::blocksBottomCellLiquidDelim() const
 {
-	return this->hasLiquid || this->hasSolid;
+	return this->liquid != CELL_MATERIAL_NONE || this->solid != CELL_MATERIAL_NONE;
 }
 
 bool RoomCell::getHasSolid() const
 {
-	return this->hasSolid;
+	return this->solid != CELL_MATERIAL_NONE;
 }
 
 /**
@@ -294,16 +385,27 @@ bool RoomCell::getHasSolid() const
  */
 bool RoomCell::getIsCollider() const
 {
-	return this->isCollider;
+	// for now only solid collider is supported
+	// TODO stairs, platform
+	return this->solid != CELL_MATERIAL_NONE;
 }
 
-const sf::FloatRect& RoomCell::getSolidCollider() const
+/**
+ * Calculates the collider of a solid, taking part-height flag into account. Only makes sense if the cell is a
+ * collider (see ::getIsCollider()).
+ *
+ * @param x cell x coordinate in the Room
+ * @param y cell y coordinate in the Room
+ * @return collider, in Room coordinates
+ */
+sf::FloatRect RoomCell::getSolidCollider(uint x, uint y) const
 {
-	return this->solidCollider;
+	return sf::FloatRect(static_cast<float>(x * CELL_SIDE_LEN), static_cast<float>(y * CELL_SIDE_LEN + this->topOffset),
+						 CELL_SIDE_LEN, static_cast<float>(CELL_SIDE_LEN - this->topOffset));
 }
 
 /**
- * @brief Finalizes Cell setup after all symbols have been added and performs sanity checks.
+ * @brief Performs sanity checks after all symbols have been added.
  *
  * Checks include:
  *   1. Liquid + solid without height flag is an invalid case
@@ -311,91 +413,164 @@ const sf::FloatRect& RoomCell::getSolidCollider() const
  * @return true if the cell is sane
  * @return false if the cell contains errors
  */
-bool RoomCell::finishSetup()
+bool RoomCell::finishSetup() const
 {
-	if (this->hasLiquid && this->hasSolid && this->topOffset == 0)
+	if (this->liquid != CELL_MATERIAL_NONE && this->solid != CELL_MATERIAL_NONE && this->topOffset == 0)
 	{
 		Log::e(STR_LIQUID_SOLID_NO_HEIGHT_FLAG);
 		return false;
 	}
 
-	// set the correct texture rect for solid. we also want to take part-height flag into account, by moving the sprite
-	// down and decreasing height of the texture rect. we can't do it inside ::addSolidSymbol(), as the height flag (if
-	// any) is not yet added at that point.
-	this->solid.setPosition({ 0, static_cast<float>(this->topOffset) });
-	this->solid.setTextureRect({ static_cast<int>(this->getPosition().x),
-								 static_cast<int>(this->getPosition().y) + this->topOffset, CELL_SIDE_LEN,
-								 static_cast<int>(CELL_SIDE_LEN) - this->topOffset });
+	return true;
+}
 
-	// set the collider flag and calculate the collider (if applicable). the three cases are mutually exclusive,
-	// which should have already been ensured in ::addOtherSymbol().
-	// for now only solid collider is supported
-	if (this->hasSolid)
-	{
-		this->isCollider = true;
+/**
+ * @brief Sets up the cell from symbols previously obtained via ::getSymbols().
+ *
+ * The symbols are added in the same order as they would be when parsing room data, so the same checks apply.
+ * ::finishSetup() still needs to be called afterwards.
+ *
+ * @param newSymbols symbols to add
+ * @param materials materials of the Room the cell belongs to
+ * @param resMgr reference to resource manager
+ * @param matMgr reference to material manager
+ * @return true if all symbols were added successfully
+ * @return false if any of the symbols cannot be added
+ */
+bool RoomCell::loadSymbols(const struct cell_symbols& newSymbols, RoomCellMaterials& materials,
+						   ResourceManager& resMgr, const MaterialManager& matMgr)
+{
+	if (newSymbols.solid != '\0' && !this->addSolidSymbol(newSymbols.solid, materials, resMgr, matMgr))
+		return false;
 
-		this->solidCollider.left = this->getPosition().x;
-		this->solidCollider.top = this->getPosition().y + this->topOffset;
+	bool topBlocksLadderDelim = newSymbols.flags & CELL_FLAG_TOP_BLOCKS_LADDER_DELIM;
+	bool topBlocksLiquidDelim = newSymbols.flags & CELL_FLAG_TOP_BLOCKS_LIQUID_DELIM;
 
-		this->solidCollider.width = CELL_SIDE_LEN;
-		this->solidCollider.height = CELL_SIDE_LEN - this->topOffset;
+	for (const char symbol : { newSymbols.heightFlag, newSymbols.background, newSymbols.platform, newSymbols.stairs,
+							   newSymbols.ladder, newSymbols.liquid })
+	{
+		if (symbol != '\0' &&
+			!this->addOtherSymbol(symbol, topBlocksLadderDelim, topBlocksLiquidDelim, materials, resMgr, matMgr))
+			return false;
 	}
-	// else if (this->hasStairs)
-	//{
-	//	this->isCollider = true;
-	//	TODO
-	// }
-	// else if (this->hasPlatform)
-	//{
-	//	this->isCollider = true;
-	//	TODO
-	// }
 
 	return true;
 }
 
-/*
- * Cell drawing could potentially be optimized.
+/**
+ * Mirrors the cell horizontally, which is used for mirrored Rooms (see Room::instantiate()). Only stairs and ladders
+ * need to be flipped - other elements use seamless textures, positioned based on cell position (which is already
+ * mirrored by the Room). Stairs and ladders are flipped when they're drawn.
  *
- * One way to do this might be to have the sprite in Room::draw(), set it to one of Cell's textures, draw it. Do it in a
- * loop, then use another loop to draw other texture (e.g. background) for each Cell. This could prevent setting the
- * same texture on Sprite multiple times. Note: since it's only setting a pointer (see
- * https://www.sfml-dev.org/documentation/2.5.1/classsf_1_1Sprite.php), this might not actually give us any performance
- * improvement. We could go a step further and e.g. try to group Cells using the same texture into bigger shapes, then
- * set a texture on that single shape and draw it. Or we could have a map translating texture -> list of cells using it,
- * to avoid even more texture swapping. But again - this might not actually give us any performance benefits,
- * additionally complicating the code. For now let's keep all drawing logic inside the Cell. It also avoids duplicated
- * code in drawing a single cell (::redrawCell()), not whole room.
+ * Note: this inverts the orientation of stairs and ladders, so material::isRight should be treated as inverted for
+ * mirrored cells.
  */
+void RoomCell::mirror()
+{
+	this->flags |= CELL_FLAG_MIRRORED;
+}
 
 /**
- * First stage of drawing the cell. Draws background.
+ * @param materials materials of the Room the cell belongs to
+ * @return symbols which were added to the cell
  */
-void RoomCell::drawBackground(sf::RenderTarget& target) const
+struct cell_symbols RoomCell::getSymbols(const RoomCellMaterials& materials) const
 {
-	sf::RenderStates states(this->getTransform());
+	struct cell_symbols symbols;
+
+	for (auto [symbol, matIdx] : { std::make_pair(&symbols.solid, this->solid),
+								   std::make_pair(&symbols.background, this->background),
+								   std::make_pair(&symbols.platform, this->platform),
+								   std::make_pair(&symbols.stairs, this->stairs),
+								   std::make_pair(&symbols.ladder, this->ladder),
+								   std::make_pair(&symbols.liquid, this->liquid) })
+	{
+		if (matIdx != CELL_MATERIAL_NONE)
+			*symbol = materials.get(matIdx).symbol;
+	}
+
+	for (const auto& [heightFlag, offset] : HEIGHT_FLAGS)
+	{
+		if (offset == this->topOffset)
+			symbols.heightFlag = heightFlag;
+	}
 
-	if (this->hasBackground)
-		target.draw(this->background, states);
+	symbols.flags = this->flags & (CELL_FLAG_TOP_BLOCKS_LADDER_DELIM | CELL_FLAG_TOP_BLOCKS_LIQUID_DELIM);
+	return symbols;
+}
+
+/*
+ * Cells are not drawn one by one. Instead, each element of a cell is added to a mesh of the whole layer (e.g. all
+ * backgrounds of a Room), and the layer is then drawn with a single draw call per texture (see Room::init()). Elements
+ * are added in stages, same as they need to be drawn, so that elements sticking out of their cell (stairs, ladders) end
+ * up drawn over and under the right elements of neighbouring cells.
+ */
+
+/**
+ * Adds a quad showing the part of a repeated texture which falls within cell area, as if the texture covered the whole
+ * Room.
+ */
+static void addRepeatedQuad(CellLayerMesh& mesh, const sf::Texture& texture, uint x, uint y, sf::Color color,
+							uint topOffset = 0)
+{
+	const sf::FloatRect area(static_cast<float>(x * CELL_SIDE_LEN), static_cast<float>(y * CELL_SIDE_LEN + topOffset),
+							 CELL_SIDE_LEN, static_cast<float>(CELL_SIDE_LEN - topOffset));
+
+	// texture rect is the same as area, as the texture is repeated
+	mesh.addQuad(&texture, area, area, color);
 }
 
 /**
- * Second stage of drawing the cell. Draws platform.
+ * Adds a quad showing a whole texture, positioned relative to the cell, and flipped if the cell is mirrored (same as
+ * with mirrorHorizontally()).
+ */
+static void addWholeQuad(CellLayerMesh& mesh, const sf::Texture& texture, uint x, uint y, sf::Vector2f offset,
+						 bool mirrored, sf::Color color = sf::Color::White)
+{
+	const sf::Vector2f size(texture.getSize());
+	const sf::Vector2f cellPos(static_cast<float>(x * CELL_SIDE_LEN), static_cast<float>(y * CELL_SIDE_LEN));
+	sf::FloatRect area(cellPos + offset, size);
+	sf::FloatRect textureRect(0, 0, size.x, size.y);
+
+	if (mirrored)
+	{
+		area.left = cellPos.x + CELL_SIDE_LEN - offset.x - size.x;
+		textureRect.left = size.x;
+		textureRect.width = -size.x;
+	}
+
+	mesh.addQuad(&texture, area, textureRect, color);
+}
+
+/**
+ * First stage of drawing the cell. Adds background.
+ */
+void RoomCell::addBackground(CellLayerMesh& mesh, uint x, uint y, const RoomCellMaterials& materials) const
+{
+	if (this->background == CELL_MATERIAL_NONE)
+		return;
+
+	// darken background
+	addRepeatedQuad(mesh, *materials.get(this->background).texture, x, y, BACKWALL_COLOR);
+}
+
+/**
+ * Second stage of drawing the cell. Adds platform.
  *
- * Should be called after ::drawBackground() was already called for this cell.
+ * Should be drawn after backgrounds of all cells.
  */
-void RoomCell::drawPlatform(sf::RenderTarget& target) const
+void RoomCell::addPlatform(CellLayerMesh& mesh, uint x, uint y, const RoomCellMaterials& materials) const
 {
-	sf::RenderStates states(this->getTransform());
+	if (this->platform == CELL_MATERIAL_NONE)
+		return;
 
-	if (this->hasPlatform)
-		target.draw(this->platform, states);
+	addRepeatedQuad(mesh, *materials.get(this->platform).texture, x, y, sf::Color::White);
 }
 
 /**
- * Third stage of drawing the cell. Draws stairs.
+ * Third stage of drawing the cell. Adds stairs.
  *
- * Should be called after ::drawBackground() and ::drawPlatform() were already called for all cells.
+ * Should be drawn after backgrounds and platforms of all cells.
  *
  * Stairs have sprites with parts visible outside of cell area, therefore they need to drawn differently
  * than elements contained within cell area. That is, they don't use texture repeating.
@@ -403,55 +578,71 @@ void RoomCell::drawPlatform(sf::RenderTarget& target) const
  * Stairs need to be drawn separately from previous stages, as the surrounding cells might draw over the parts of stairs
  * outside cell area, which is undesirable.
  */
-void RoomCell::drawStairs(sf::RenderTarget& target) const
+void RoomCell::addStairs(CellLayerMesh& mesh, uint x, uint y, const RoomCellMaterials& materials) const
 {
-	sf::RenderStates states(this->getTransform());
+	if (this->stairs == CELL_MATERIAL_NONE)
+		return;
 
-	if (this->hasStairs)
-		target.draw(this->stairs, states);
+	const struct cell_material& mat = materials.get(this->stairs);
+	addWholeQuad(mesh, *mat.texture, x, y, { static_cast<float>(mat.offsetLeft), 0 }, this->flags & CELL_FLAG_MIRRORED);
 }
 
 /**
- * Fourth stage of drawing the cell. Draws ladder.
+ * Fourth stage of drawing the cell. Adds ladder.
  *
- * Should be called after ::drawBackground(), ::drawPlatform() and ::drawStairs() were already called for all cells.
+ * Should be drawn after backgrounds, platforms and stairs of all cells.
  *
- * Same logic as in ::drawStairs() applies to ladders as well, i.e. ladders have parts that are sticking out of cell
+ * Same logic as in ::addStairs() applies to ladders as well, i.e. ladders have parts that are sticking out of cell
  * area, so they need to be drawn separately.
  */
-void RoomCell::drawLadder(sf::RenderTarget& target) const
+void RoomCell::addLadder(CellLayerMesh& mesh, uint x, uint y, const RoomCellMaterials& materials) const
 {
-	sf::RenderStates states(this->getTransform());
+	if (this->ladder == CELL_MATERIAL_NONE)
+		return;
 
-	if (this->hasPlatform || this->hasStairs || this->topCellBlocksLadderDelim)
-		target.draw(this->ladder, states);
+	const struct cell_material& mat = materials.get(this->ladder);
+	const bool mirrored = this->flags & CELL_FLAG_MIRRORED;
+
+	if (this->platform != CELL_MATERIAL_NONE || this->stairs != CELL_MATERIAL_NONE ||
+		(this->flags & CELL_FLAG_TOP_BLOCKS_LADDER_DELIM))
+		addWholeQuad(mesh, *mat.texture, x, y, { static_cast<float>(mat.offsetLeft), 0 }, mirrored);
 	else
-		target.draw(this->ladderDelim, states);
+		addWholeQuad(mesh, *mat.textureDelim, x, y, static_cast<sf::Vector2f>(mat.delimOffset), mirrored);
 }
 
 /**
- * Fifth stage of drawing a cell. Draws solid and liquid.
+ * Fifth stage of drawing a cell. Adds liquid.
  *
- * Solid Snake and Liquid Snake, what a coincidence.
+ * Should be drawn after all previous stages of all cells. Liquid needs to be drawn over ladders and stairs, which
+ * creates the effect of submerging stuff.
+ */
+void RoomCell::addLiquid(CellLayerMesh& mesh, uint x, uint y, const RoomCellMaterials& materials) const
+{
+	if (this->liquid == CELL_MATERIAL_NONE)
+		return;
+
+	const struct cell_material& mat = materials.get(this->liquid);
+	if (this->flags & CELL_FLAG_TOP_BLOCKS_LIQUID_DELIM)
+		mesh.addQuad(sf::FloatRect(static_cast<float>(x * CELL_SIDE_LEN), static_cast<float>(y * CELL_SIDE_LEN),
+								   CELL_SIDE_LEN, CELL_SIDE_LEN),
+					 mat.color);
+	else
+		addWholeQuad(mesh, *mat.textureDelim, x, y, { 0, 0 }, false, liquidSpriteColor);
+}
+
+/**
+ * Sixth (last) stage of drawing a cell. Adds solid.
  *
- * Should be called after all other draw methods were already called for all cells.
+ * Solid Snake and Liquid Snake, what a coincidence.
  *
- * Liquid and solid need to be drawn over ladders and stairs. In case of liquid, it will create the effect of submerging
- * stuff. In case of solid, it will prevent the parts of stairs/ladders that are sticking out of their cell from being
- * displayed over solids, which would not make sense.
+ * Should be drawn after all other stages of all cells. Solids need to be drawn over liquids (part-height solids can
+ * share a cell with liquid), and over ladders and stairs, to prevent the parts of stairs/ladders that are sticking out
+ * of their cell from being displayed over solids, which would not make sense.
  */
-void RoomCell::drawLiquidAndSolid(sf::RenderTarget& target) const
+void RoomCell::addSolid(CellLayerMesh& mesh, uint x, uint y, const RoomCellMaterials& materials) const
 {
-	sf::RenderStates states(this->getTransform());
-
-	if (this->hasLiquid)
-	{
-		if (this->topCellBlocksLiquidDelim)
-			target.draw(this->liquid, states);
-		else
-			target.draw(this->liquidDelim, states);
-	}
+	if (this->solid == CELL_MATERIAL_NONE)
+		return;
 
-	if (this->hasSolid)
-		target.draw(this->solid, states);
+	addRepeatedQuad(mesh, *materials.get(this->solid).texture, x, y, sf::Color::White, this->topOffset);
 }
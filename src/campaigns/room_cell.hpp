@@ -1,26 +1,92 @@
 // SPDX-License-Identifier: GPL-3.0-only
 //
-// (c) 2022-2023 h67ma <szycikm@gmail.com>
+// (c) 2022-2024 h67ma <szycikm@gmail.com>
 
 #pragma once
 
+#include <array>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
-#include <SFML/Graphics/RectangleShape.hpp>
-#include <SFML/Graphics/RenderTarget.hpp>
-#include <SFML/Graphics/Transformable.hpp>
+#include <SFML/Graphics/Color.hpp>
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/System/Vector2.hpp>
 
 #include "../consts.hpp"
 #include "../materials/material_manager.hpp"
 #include "../resources/resource_manager.hpp"
-#include "../resources/sprite_resource.hpp"
-#include "SFML/Graphics/Rect.hpp"
+#include "../resources/texture_resource.hpp"
+#include "cell_layer_mesh.hpp"
 
 constexpr uint CELL_SIDE_LEN = 40;
 
+constexpr uchar CELL_FLAG_TOP_BLOCKS_LADDER_DELIM = 1 << 0;
+constexpr uchar CELL_FLAG_TOP_BLOCKS_LIQUID_DELIM = 1 << 1;
+constexpr uchar CELL_FLAG_MIRRORED = 1 << 2; // not a symbol flag, only set via RoomCell::mirror()
+
+// index of material in RoomCellMaterials, meaning that the cell doesn't have an element of that type
+constexpr uchar CELL_MATERIAL_NONE = 0xFF;
+
+/**
+ * Symbols which make up a single cell, as they were defined in room data ('\0' means no symbol of that type). This is
+ * enough to recreate the cell without parsing the room data again (see Room::loadCompiled()).
+ */
+struct cell_symbols
+{
+		char solid = '\0';
+		char heightFlag = '\0';
+		char background = '\0';
+		char platform = '\0';
+		char stairs = '\0';
+		char ladder = '\0';
+		char liquid = '\0';
+		uchar flags = 0; // CELL_FLAG_*
+};
+
 // TODO figure out the exact value (but looks about right)
 #define BACKWALL_COLOR COLOR_GRAY(80)
 
+/**
+ * Everything needed to draw elements of a single material - textures and properties copied from struct material.
+ */
+struct cell_material
+{
+		char symbol = '\0';
+		enum MaterialType type = MAT_SOLID;
+		TextureResource texture = nullptr;
+		TextureResource textureDelim = nullptr;
+		TextureResource maskTexture = nullptr;
+		int offsetLeft = 0;
+		sf::Vector2i delimOffset;
+		sf::Color color;
+};
+
+/**
+ * Materials used by cells of a single Room. Each material is set up only once per Room, and is then shared by all
+ * cells using it (flyweight), so that cells only need to store indexes of their materials (see RoomCell).
+ *
+ * Materials are identified by their symbols, which are single characters, and there are two separate sets of symbols
+ * (see MaterialManager). Even if all possible materials were used in a single Room, the number of indexes wouldn't
+ * exceed 255.
+ */
+class RoomCellMaterials
+{
+	private:
+		std::vector<struct cell_material> materials;
+		std::array<uchar, 256> solidIndexes;
+		std::array<uchar, 256> otherIndexes;
+
+	public:
+		RoomCellMaterials();
+		uchar addSolid(char symbol, ResourceManager& resMgr, const MaterialManager& matMgr);
+		uchar addOther(char symbol, ResourceManager& resMgr, const MaterialManager& matMgr);
+		const struct cell_material& get(uchar idx) const;
+		bool usesTexture(const std::unordered_set<const sf::Texture*>& textures) const;
+		void collectBackgroundTextures(std::unordered_set<const sf::Texture*>& textures) const;
+		void clear();
+};
+
 /**
  * RoomCell is the basic building block of all Rooms. It represents a static (unmovable), square area, roughly half the
  * height/width of the player in size. In that area, multiple elements can be present at the same time, including:
@@ -44,49 +110,44 @@ constexpr uint CELL_SIDE_LEN = 40;
  *
  * Each element type can appear only once in a cell (e.g. there can't be two backgrounds defined). There are also other
  * restrictions (see ::addSolidSymbol() and ::addOtherSymbol() for details).
+ *
+ * There are a lot of cells in each Location, so the cell itself is just a compact record of materials (indexes in
+ * RoomCellMaterials of the Room the cell belongs to), height offset and flags. Cell position is not stored either, it's
+ * determined by the Room. Cells are drawn as parts of meshes (see CellLayerMesh), which are only built when the Room
+ * caches are drawn (see Room::init()).
  */
-class RoomCell : public sf::Transformable
+class RoomCell
 {
 	private:
-		SpriteResource solid;
-		SpriteResource solidMask;
-		SpriteResource background;
-		SpriteResource platform;
-		SpriteResource stairs;
-		SpriteResource ladder;
-		SpriteResource ladderDelim;
-		SpriteResource liquidDelim;
-		sf::RectangleShape liquid { sf::Vector2f(CELL_SIDE_LEN, CELL_SIDE_LEN) };
-		sf::FloatRect solidCollider;
-		int topOffset = 0; // offset from top of cell area, used to create part-height cells
-		bool topCellBlocksLadderDelim;
-		bool topCellBlocksLiquidDelim;
-
-		// all these flags could potentially be moved to a single uint to save a bit of memory, but it seems that the
-		// compiler is already doing a similar optimization by itself. it also makes the code less readable, so let's
-		// skip it for now.
-		bool hasSolid = false;
-		bool hasBackground = false;
-		bool hasPlatform = false;
-		bool hasStairs = false;
-		bool hasLadder = false;
-		bool hasLiquid = false;
-		bool isCollider = false;
+		uchar solid = CELL_MATERIAL_NONE;
+		uchar background = CELL_MATERIAL_NONE;
+		uchar platform = CELL_MATERIAL_NONE;
+		uchar stairs = CELL_MATERIAL_NONE;
+		uchar ladder = CELL_MATERIAL_NONE;
+		uchar liquid = CELL_MATERIAL_NONE;
+		uchar topOffset = 0; // offset from top of cell area, used to create part-height cells
+		uchar flags = 0; // CELL_FLAG_*
 
 	public:
 		static const sf::Color liquidSpriteColor;
-		bool addSolidSymbol(char symbol, ResourceManager& resMgr, const MaterialManager& matMgr);
+		bool addSolidSymbol(char symbol, RoomCellMaterials& materials, ResourceManager& resMgr,
+							const MaterialManager& matMgr);
 		bool addOtherSymbol(char symbol, bool topCellBlocksLadderDelim, bool topCellBlocksLiquidDelim,
-							ResourceManager& resMgr, const MaterialManager& matMgr);
-		bool finishSetup();
+							RoomCellMaterials& materials, ResourceManager& resMgr, const MaterialManager& matMgr);
+		bool finishSetup() const;
+		bool loadSymbols(const struct cell_symbols& newSymbols, RoomCellMaterials& materials, ResourceManager& resMgr,
+						 const MaterialManager& matMgr);
+		void mirror();
+		struct cell_symbols getSymbols(const RoomCellMaterials& materials) const;
 		bool blocksBottomCellLadderDelim() const;
 		bool blocksBottomCellLiquidDelim() const;
 		bool getHasSolid() const;
 		bool getIsCollider() const;
-		const sf::FloatRect& getSolidCollider() const;
-		void drawBackground(sf::RenderTarget& target) const;
-		void drawPlatform(sf::RenderTarget& target) const;
-		void drawStairs(sf::RenderTarget& target) const;
-		void drawLadder(sf::RenderTarget& target) const;
-		void drawLiquidAndSolid(sf::RenderTarget& target) const;
+		sf::FloatRect getSolidCollider(uint x, uint y) const;
+		void addBackground(CellLayerMesh& mesh, uint x, uint y, const RoomCellMaterials& materials) const;
+		void addPlatform(CellLayerMesh& mesh, uint x, uint y, const RoomCellMaterials& materials) const;
+		void addStairs(CellLayerMesh& mesh, uint x, uint y, const RoomCellMaterials& materials) const;
+		void addLadder(CellLayerMesh& mesh, uint x, uint y, const RoomCellMaterials& materials) const;
+		void addLiquid(CellLayerMesh& mesh, uint x, uint y, const RoomCellMaterials& materials) const;
+		void addSolid(CellLayerMesh& mesh, uint x, uint y, const RoomCellMaterials& materials) const;
 };
@@ -0,0 +1,18 @@
+// SPDX-License-Identifier: GPL-3.0-only
+//
+// (c) 2024 h67ma <szycikm@gmail.com>
+
+#include "room_colliders.hpp"
+
+void RoomColliders::setCellCollider(uint x, uint y, bool collider)
+{
+	this->colliders[y * ROOM_WIDTH_WITH_BORDER + x] = collider;
+}
+
+/**
+ * @return true if the Cell is a collider. Coordinates must be in range
+ */
+bool RoomColliders::isCellCollider(uint x, uint y) const
+{
+	return this->colliders[y * ROOM_WIDTH_WITH_BORDER + x];
+}
@@ -0,0 +1,23 @@
+// SPDX-License-Identifier: GPL-3.0-only
+//
+// (c) 2024 h67ma <szycikm@gmail.com>
+
+#pragma once
+
+#include <bitset>
+
+#include "room_template.hpp"
+
+/**
+ * Layout of collider Cells of a single Room (see Room::isCellCollider()). This is all that's needed to validate
+ * geometry of Rooms (see Location::validateRoomGeometry()), so it can be kept instead of the whole Room.
+ */
+class RoomColliders
+{
+	private:
+		std::bitset<ROOM_WIDTH_WITH_BORDER * ROOM_HEIGHT_WITH_BORDER> colliders;
+
+	public:
+		void setCellCollider(uint x, uint y, bool collider);
+		bool isCellCollider(uint x, uint y) const;
+};
@@ -1,9 +1,57 @@
 // SPDX-License-Identifier: GPL-3.0-only
 //
-// (c) 2022-2023 h67ma <szycikm@gmail.com>
+// (c) 2022-2024 h67ma <szycikm@gmail.com>
 
 #include "room_grid.hpp"
 
+#include <cstdlib>
+
+/**
+ * Calculates coordinates of the room in the specified direction from given coordinates.
+ *
+ * @param coords coordinates to start from
+ * @param direction direction to move in
+ * @return coordinates of the nearby room (which might not exist)
+ */
+HashableVector3i RoomGrid::getNearCoords(HashableVector3i coords, Direction direction)
+{
+	switch (direction)
+	{
+		case DIR_LEFT:
+			coords.x -= 1;
+			break;
+		case DIR_RIGHT:
+			coords.x += 1;
+			break;
+		case DIR_UP:
+			coords.y -= 1;
+			break;
+		case DIR_DOWN:
+			coords.y += 1;
+			break;
+		case DIR_FRONT:
+			coords.z -= 1;
+			break;
+		case DIR_BACK:
+			coords.z += 1;
+			break;
+		default:
+			break; // a horrible chill goes down your spine...
+	}
+
+	return coords;
+}
+
+/**
+ * @return true if rooms at given coordinates are next to each other, in any direction (see ::getNearCoords())
+ */
+bool RoomGrid::areCoordsNear(HashableVector3i coords, HashableVector3i otherCoords)
+{
+	int distance = std::abs(coords.x - otherCoords.x) + std::abs(coords.y - otherCoords.y) +
+				   std::abs(coords.z - otherCoords.z);
+	return distance == 1;
+}
+
 /**
  * Gets the current room coordinates.
  *
@@ -72,31 +120,7 @@ std::shared_ptr<Room> RoomGrid::moveTo(HashableVector3i coords)
  */
 std::shared_ptr<Room> RoomGrid::moveToNear(Direction direction)
 {
-	HashableVector3i newCoords = this->currentCoords;
-
-	switch (direction)
-	{
-		case DIR_LEFT:
-			newCoords.x -= 1;
-			break;
-		case DIR_RIGHT:
-			newCoords.x += 1;
-			break;
-		case DIR_UP:
-			newCoords.y -= 1;
-			break;
-		case DIR_DOWN:
-			newCoords.y += 1;
-			break;
-		case DIR_FRONT:
-			newCoords.z -= 1;
-			break;
-		case DIR_BACK:
-			newCoords.z += 1;
-			break;
-		default:
-			break; // a horrible chill goes down your spine...
-	}
+	HashableVector3i newCoords = RoomGrid::getNearCoords(this->currentCoords, direction);
 
 	std::shared_ptr<Room> newRoom = this->get(newCoords);
 	if (newRoom == nullptr)
@@ -106,7 +130,36 @@ std::shared_ptr<Room> RoomGrid::moveToNear(Direction direction)
 	return newRoom;
 }
 
+/**
+ * Removes the room at specified coordinates (if it exists). The room is deallocated if nothing else references it.
+ */
+void RoomGrid::remove(HashableVector3i coords)
+{
+	this->grid.erase(coords);
+}
+
+/**
+ * @return number of rooms in the grid
+ */
+std::size_t RoomGrid::size() const
+{
+	return this->grid.size();
+}
+
 void RoomGrid::clear()
 {
 	this->grid.clear();
 }
+
+/**
+ * Allows iterating over all Rooms in the grid (in no particular order).
+ */
+RoomGrid::const_iterator RoomGrid::begin() const
+{
+	return this->grid.begin();
+}
+
+RoomGrid::const_iterator RoomGrid::end() const
+{
+	return this->grid.end();
+}
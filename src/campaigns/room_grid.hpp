@@ -1,6 +1,6 @@
 // SPDX-License-Identifier: GPL-3.0-only
 //
-// (c) 2022-2023 h67ma <szycikm@gmail.com>
+// (c) 2022-2024 h67ma <szycikm@gmail.com>
 
 #pragma once
 
@@ -26,10 +26,19 @@ class RoomGrid
 		std::unordered_map<HashableVector3<int>, std::shared_ptr<Room>, Vector3Hasher<int>> grid;
 
 	public:
+		using const_iterator =
+			std::unordered_map<HashableVector3<int>, std::shared_ptr<Room>, Vector3Hasher<int>>::const_iterator;
+
+		static HashableVector3i getNearCoords(HashableVector3i coords, Direction direction);
+		static bool areCoordsNear(HashableVector3i coords, HashableVector3i otherCoords);
 		HashableVector3i getCurrentCoords() const;
 		void set(HashableVector3i coords, std::shared_ptr<Room> room);
 		std::shared_ptr<Room> get(HashableVector3i coords) const;
 		std::shared_ptr<Room> moveTo(HashableVector3i coords);
 		std::shared_ptr<Room> moveToNear(Direction direction);
+		void remove(HashableVector3i coords);
+		std::size_t size() const;
 		void clear();
+		const_iterator begin() const;
+		const_iterator end() const;
 };
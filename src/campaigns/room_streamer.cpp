@@ -0,0 +1,159 @@
+// SPDX-License-Identifier: GPL-3.0-only
+//
+// (c) 2024 h67ma <szycikm@gmail.com>
+
+#include "room_streamer.hpp"
+
+#include <algorithm>
+
+RoomStreamer::~RoomStreamer()
+{
+	this->stop();
+}
+
+/**
+ * Starts the background thread. If the streamer is already running, it's stopped first.
+ *
+ * @param loadFunc function used to load a single Room. should return nullptr if loading failed
+ */
+void RoomStreamer::start(const room_load_function& loadFunc)
+{
+	this->stop();
+
+	this->loadFunc = loadFunc;
+	this->stopRequested = false;
+	this->worker = std::thread(&RoomStreamer::work, this);
+}
+
+/**
+ * Stops the background thread and discards all queued requests, loaded Rooms which weren't picked up, and the list of
+ * Rooms which failed to load. If a Room is
+ * being loaded right now, this will block until it's finished.
+ */
+void RoomStreamer::stop()
+{
+	if (!this->worker.joinable())
+		return;
+
+	{
+		const std::lock_guard<std::mutex> lock(this->mutex);
+		this->stopRequested = true;
+	}
+
+	this->cond.notify_all();
+	this->worker.join();
+
+	this->queue.clear();
+	this->pending.clear();
+	this->loaded.clear();
+	this->failed.clear();
+	this->loadFunc = nullptr;
+}
+
+bool RoomStreamer::isRunning() const
+{
+	return this->worker.joinable();
+}
+
+/**
+ * Queues a Room to be loaded in the background. Requesting a Room which is already pending has no effect, unless the
+ * request is urgent. Requesting a Room which failed to load before has no effect as well (see ::hasFailed()).
+ *
+ * @param urgent true if the Room should be loaded before all other queued Rooms, e.g. because the Player is waiting to
+ *               enter it
+ */
+void RoomStreamer::request(const HashableVector3i& coords, bool urgent)
+{
+	{
+		const std::lock_guard<std::mutex> lock(this->mutex);
+		if (this->failed.find(coords) != this->failed.end())
+			return;
+
+		if (!this->pending.insert(coords).second)
+		{
+			if (!urgent)
+				return;
+
+			// queued already (or being loaded right now, in which case it's not in the queue anymore)
+			auto queued = std::find(this->queue.begin(), this->queue.end(), coords);
+			if (queued == this->queue.end())
+				return;
+
+			this->queue.erase(queued);
+		}
+
+		if (urgent)
+			this->queue.push_front(coords);
+		else
+			this->queue.push_back(coords);
+	}
+
+	this->cond.notify_all();
+}
+
+/**
+ * Discards all queued requests. The Room which is being loaded right now (if any) is not affected.
+ */
+void RoomStreamer::cancelQueued()
+{
+	{
+		const std::lock_guard<std::mutex> lock(this->mutex);
+		for (const auto& coords : this->queue)
+		{
+			this->pending.erase(coords);
+		}
+
+		this->queue.clear();
+	}
+
+	this->cond.notify_all();
+}
+
+/**
+ * @return true if loading the Room at given coordinates failed. Such Room is not loaded again, even if requested
+ */
+bool RoomStreamer::hasFailed(const HashableVector3i& coords)
+{
+	const std::lock_guard<std::mutex> lock(this->mutex);
+	return this->failed.find(coords) != this->failed.end();
+}
+
+/**
+ * @return Rooms loaded since the last call. Rooms which failed to load are not included
+ */
+std::vector<std::pair<HashableVector3i, std::shared_ptr<Room>>> RoomStreamer::takeLoaded()
+{
+	std::vector<std::pair<HashableVector3i, std::shared_ptr<Room>>> result;
+
+	const std::lock_guard<std::mutex> lock(this->mutex);
+	result.swap(this->loaded);
+	return result;
+}
+
+void RoomStreamer::work()
+{
+	std::unique_lock<std::mutex> lock(this->mutex);
+
+	while (true)
+	{
+		this->cond.wait(lock, [this]() { return this->stopRequested || !this->queue.empty(); });
+		if (this->stopRequested)
+			return;
+
+		HashableVector3i coords = this->queue.front();
+		this->queue.pop_front();
+
+		// don't block the main thread while loading
+		lock.unlock();
+		std::shared_ptr<Room> room = this->loadFunc(coords);
+		lock.lock();
+
+		if (room != nullptr)
+			this->loaded.emplace_back(coords, room);
+		else
+			this->failed.insert(coords);
+
+		this->pending.erase(coords);
+		this->cond.notify_all();
+	}
+}
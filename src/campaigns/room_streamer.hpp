@@ -0,0 +1,55 @@
+// SPDX-License-Identifier: GPL-3.0-only
+//
+// (c) 2024 h67ma <szycikm@gmail.com>
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "../util/hashable_vector3.hpp"
+#include "room.hpp"
+
+using room_load_function = std::function<std::shared_ptr<Room>(const HashableVector3i&)>;
+
+/**
+ * RoomStreamer loads Rooms on a background thread, so that nearby Rooms can be prepared before the Player enters them
+ * (see Location::updateLoadedRooms()).
+ *
+ * The actual loading is done by a function provided by the owner, which must be safe to call from another thread. The
+ * streamer never touches the RoomGrid - loaded Rooms are stored until the owner picks them up via ::takeLoaded().
+ *
+ * Rooms which failed to load are remembered (see ::hasFailed()) and not loaded again, so that the same error isn't
+ * reported over and over.
+ */
+class RoomStreamer
+{
+	private:
+		room_load_function loadFunc;
+		std::thread worker;
+		std::mutex mutex;
+		std::condition_variable cond;
+		bool stopRequested = false;
+		std::deque<HashableVector3i> queue;
+		std::unordered_set<HashableVector3i, Vector3Hasher<int>> pending; // queued, or being loaded right now
+		std::vector<std::pair<HashableVector3i, std::shared_ptr<Room>>> loaded; // waiting to be picked up
+		std::unordered_set<HashableVector3i, Vector3Hasher<int>> failed; // never requested again, see ::request()
+		void work();
+
+	public:
+		~RoomStreamer();
+		void start(const room_load_function& loadFunc);
+		void stop();
+		bool isRunning() const;
+		void request(const HashableVector3i& coords, bool urgent = false);
+		void cancelQueued();
+		bool hasFailed(const HashableVector3i& coords);
+		std::vector<std::pair<HashableVector3i, std::shared_ptr<Room>>> takeLoaded();
+};
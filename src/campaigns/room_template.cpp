@@ -0,0 +1,300 @@
+// SPDX-License-Identifier: GPL-3.0-only
+//
+// (c) 2024 h67ma <szycikm@gmail.com>
+
+#include "room_template.hpp"
+
+#include <type_traits>
+
+#include "../consts.hpp"
+#include "../hud/log.hpp"
+#include "../util/i18n.hpp"
+#include "../util/json.hpp"
+#include "../util/util.hpp"
+
+RoomTemplate::RoomTemplate(std::uint64_t hash) : hash(hash)
+{
+}
+
+/**
+ * Calculates the hash identifying contents of a room node (see Room::load() for node structure). Keys which only
+ * describe where the Room is placed in a Location (coordinates, start room flag) are skipped, so that identical Rooms
+ * placed in different coordinates (or different Locations) have the same hash.
+ *
+ * Keys of json objects are sorted, so the hash doesn't depend on the order in which keys were defined.
+ *
+ * @param root reference to json node containing room data
+ * @return hash of room data
+ */
+std::uint64_t RoomTemplate::getJsonHash(const nlohmann::json& root)
+{
+	std::uint64_t hash = HASH_SEED;
+
+	for (const auto& item : root.items())
+	{
+		if (item.key() == FOERR_JSON_KEY_COORDS || item.key() == FOERR_JSON_KEY_IS_START)
+			continue;
+
+		const std::string value = item.value().dump();
+		hash = hashBytes(item.key().data(), item.key().size(), hash);
+		hash = hashBytes(value.data(), value.size(), hash);
+	}
+
+	return hash;
+}
+
+/**
+ * Loads room-wide elements and background objects from a room node (see Room::load() for node structure). Cells are
+ * not loaded, they should be set via ::setCellSymbols().
+ *
+ * @param root reference to json node containing room data
+ * @param filePath location file path, just for printing
+ * @returns true on load success
+ * @returns false on load fail
+ */
+bool RoomTemplate::loadJson(const nlohmann::json& root, const std::string& filePath)
+{
+	///// room-wide backwall /////
+
+	// backwall can be empty
+	std::string backwallName;
+	parseJsonKey<std::string>(root, filePath, FOERR_JSON_KEY_BACKWALL, backwallName, true);
+	if (!backwallName.empty())
+		this->backwall = AssetInterner::intern(pathCombine(PATH_TEXT_CELLS, backwallName + ".png"));
+
+	///// room-wide liquid level /////
+
+	// if liquid level is defined and > 0, room is fully submerged to that level (counting from bottom, in cells).
+	// solids are also submerged
+	parseJsonKey<uint>(root, filePath, FOERR_JSON_KEY_LIQUID_LEVEL, this->liquidLevelHeight, true);
+	if (this->liquidLevelHeight > 0)
+	{
+		std::string liquidSymbolStr;
+		if (!parseJsonKey<std::string>(root, filePath, FOERR_JSON_KEY_LIQUID_SYMBOL, liquidSymbolStr))
+			return false;
+
+		if (liquidSymbolStr.length() != 1)
+		{
+			Log::e(STR_MAT_LOAD_KEY_NOT_1CHAR, liquidSymbolStr.c_str());
+			return false;
+		}
+
+		this->liquidSymbol = liquidSymbolStr[0];
+	}
+
+	///// spawn coords /////
+
+	// spawn coords are usually only defined for the first room
+	parseJsonVector2Key<uint>(root, filePath, FOERR_JSON_KEY_SPAWN_COORDS, this->spawnCoords, true);
+
+	///// lights state override /////
+
+	int lightsOn;
+	if (parseJsonKey<int>(root, filePath, FOERR_JSON_KEY_LIGHTS_ON, lightsOn, true))
+		this->lightsState = lonToLightObjectsState(lightsOn);
+
+	///// background objects /////
+
+	if (!RoomTemplate::parseBackObjsNode(root, filePath, FOERR_JSON_KEY_BACK_OBJS, this->backObjectsData))
+		return false;
+
+	if (!RoomTemplate::parseBackObjsNode(root, filePath, FOERR_JSON_KEY_FAR_BACK_OBJS, this->backObjectsDataFar))
+		return false;
+
+	if (!RoomTemplate::parseBackObjsNode(root, filePath, FOERR_JSON_KEY_BACK_HOLES, this->backHoleObjectsData))
+		return false;
+
+	return true;
+}
+
+/**
+ * Loads the template from data previously written with ::writeCompiled().
+ *
+ * The data is expected to have been validated when it was written, so no validation is performed here. Materials and
+ * objects are checked anyway when the template is instantiated (see Room::instantiate()).
+ *
+ * @param reader reader containing compiled data of this template only
+ * @returns true on load success
+ * @returns false if the data is corrupted
+ */
+bool RoomTemplate::loadCompiled(BinaryReader& reader)
+{
+	// interned ids are only valid while the game is running, so strings are stored instead
+	std::string backwallPath;
+	std::uint32_t liquidLevel;
+	std::int32_t lights;
+	if (!reader.readString(backwallPath) || !reader.read(liquidLevel) || !reader.read(this->liquidSymbol) ||
+		!reader.read(this->spawnCoords) || !reader.read(lights))
+		return false;
+
+	this->backwall = AssetInterner::intern(backwallPath);
+	this->liquidLevelHeight = liquidLevel;
+	this->lightsState = static_cast<enum LightObjectsState>(lights);
+
+	// cells are stored as a flat array, so they can be copied in one go
+	static_assert(std::is_trivially_copyable_v<struct cell_symbols>);
+	if (!reader.readBytes(this->cells, sizeof(this->cells)))
+		return false;
+
+	if (!RoomTemplate::readCompiledBackObjs(reader, this->backObjectsData) ||
+		!RoomTemplate::readCompiledBackObjs(reader, this->backObjectsDataFar) ||
+		!RoomTemplate::readCompiledBackObjs(reader, this->backHoleObjectsData))
+		return false;
+
+	return reader.atEnd();
+}
+
+/**
+ * Writes all data needed to recreate the template via ::loadCompiled(). The hash is not written, it should be stored
+ * separately.
+ */
+void RoomTemplate::writeCompiled(BinaryWriter& writer) const
+{
+	writer.writeString(AssetInterner::getString(this->backwall));
+	writer.write(static_cast<std::uint32_t>(this->liquidLevelHeight));
+	writer.write(this->liquidSymbol);
+	writer.write(this->spawnCoords);
+	writer.write(static_cast<std::int32_t>(this->lightsState));
+	writer.writeBytes(this->cells, sizeof(this->cells));
+
+	RoomTemplate::writeCompiledBackObjs(writer, this->backObjectsData);
+	RoomTemplate::writeCompiledBackObjs(writer, this->backObjectsDataFar);
+	RoomTemplate::writeCompiledBackObjs(writer, this->backHoleObjectsData);
+}
+
+bool RoomTemplate::readCompiledBackObjs(BinaryReader& reader, std::vector<struct back_obj_data>& dataVector)
+{
+	dataVector.clear();
+
+	std::uint32_t count;
+	if (!reader.read(count))
+		return false;
+
+	for (std::uint32_t i = 0; i < count; i++)
+	{
+		struct back_obj_data objData;
+		std::string id;
+		std::int32_t variantIdx;
+		if (!reader.readString(id) || !reader.read(objData.coordinates) || !reader.read(variantIdx))
+			return false;
+
+		objData.id = AssetInterner::intern(id);
+		objData.variantIdx = variantIdx;
+		dataVector.push_back(objData);
+	}
+
+	return true;
+}
+
+void RoomTemplate::writeCompiledBackObjs(BinaryWriter& writer, const std::vector<struct back_obj_data>& dataVector)
+{
+	writer.write(static_cast<std::uint32_t>(dataVector.size()));
+	for (const auto& objData : dataVector)
+	{
+		writer.writeString(AssetInterner::getString(objData.id));
+		writer.write(objData.coordinates);
+		writer.write(static_cast<std::int32_t>(objData.variantIdx));
+	}
+}
+
+/**
+ * Parses a json node containing a list of background objects and adds their data into ::dataVector.
+ * @return true if parsing was successful
+ * @return false if parsing resulted in an error
+ */
+bool RoomTemplate::parseBackObjsNode(const nlohmann::json& root, const std::string& filePath, const std::string& key,
+									 std::vector<struct back_obj_data>& dataVector)
+{
+	dataVector.clear();
+
+	auto bgObjsSearch = root.find(key);
+	if (bgObjsSearch == root.end())
+	{
+		// the room doesn't have to define any background objects under any key (this is not an error)
+		return true;
+	}
+
+	if (!bgObjsSearch->is_array())
+	{
+		Log::e(STR_INVALID_TYPE, filePath.c_str(), key.c_str());
+		return false;
+	}
+
+	for (const auto& backObjNode : *bgObjsSearch)
+	{
+		struct back_obj_data parsedNode;
+
+		std::string id;
+		if (!parseJsonKey<std::string>(backObjNode, filePath, FOERR_JSON_KEY_ID, id))
+			return false;
+
+		parsedNode.id = AssetInterner::intern(id);
+
+		if (!parseJsonVector2Key<uint>(backObjNode, filePath, FOERR_JSON_KEY_COORDS, parsedNode.coordinates))
+			return false;
+
+		if (!parseJsonKey<int>(backObjNode, filePath, FOERR_JSON_KEY_VARIANT, parsedNode.variantIdx, true))
+			parsedNode.variantIdx = -1; // negative -> use random variant
+
+		parsedNode.coordinates *= CELL_SIDE_LEN;
+
+		dataVector.push_back(parsedNode);
+	}
+
+	return true;
+}
+
+void RoomTemplate::setCellSymbols(uint x, uint y, const struct cell_symbols& symbols)
+{
+	this->cells[y][x] = symbols;
+}
+
+std::uint64_t RoomTemplate::getHash() const
+{
+	return this->hash;
+}
+
+asset_id RoomTemplate::getBackwall() const
+{
+	return this->backwall;
+}
+
+uint RoomTemplate::getLiquidLevelHeight() const
+{
+	return this->liquidLevelHeight;
+}
+
+char RoomTemplate::getLiquidSymbol() const
+{
+	return this->liquidSymbol;
+}
+
+sf::Vector2u RoomTemplate::getSpawnCoords() const
+{
+	return this->spawnCoords;
+}
+
+enum LightObjectsState RoomTemplate::getLightsState() const
+{
+	return this->lightsState;
+}
+
+const struct cell_symbols& RoomTemplate::getCellSymbols(uint x, uint y) const
+{
+	return this->cells[y][x];
+}
+
+const std::vector<struct back_obj_data>& RoomTemplate::getBackObjectsData() const
+{
+	return this->backObjectsData;
+}
+
+const std::vector<struct back_obj_data>& RoomTemplate::getBackObjectsDataFar() const
+{
+	return this->backObjectsDataFar;
+}
+
+const std::vector<struct back_obj_data>& RoomTemplate::getBackHoleObjectsData() const
+{
+	return this->backHoleObjectsData;
+}
@@ -0,0 +1,73 @@
+// SPDX-License-Identifier: GPL-3.0-only
+//
+// (c) 2024 h67ma <szycikm@gmail.com>
+
+#pragma once
+
+#include <cstdint>
+
+#include <string>
+#include <vector>
+
+#include <SFML/System/Vector2.hpp>
+#include <nlohmann/json.hpp>
+
+#include "../objects/back_obj_data.hpp"
+#include "../objects/light_objects_state.hpp"
+#include "../resources/asset_interner.hpp"
+#include "../util/binary_stream.hpp"
+#include "room_cell.hpp"
+
+constexpr uint ROOM_WIDTH_WITH_BORDER = 48;
+constexpr uint ROOM_HEIGHT_WITH_BORDER = 25;
+
+/**
+ * RoomTemplate is the immutable part of a Room, i.e. everything that was defined in room data: room-wide elements,
+ * symbols of all cells, and background objects. Everything that can change during the game (destroyed cells, lights
+ * state, randomized object variants, spawned objects) is kept in the Room itself.
+ *
+ * Templates are identified by a hash of room data (see ::getJsonHash()). Rooms with identical data (very common in
+ * grind Locations) share a single template, so the room data only needs to be parsed once, and every other Room using
+ * it can be quickly set up via Room::instantiate() (see RoomTemplateCache).
+ *
+ * Cell symbols are not parsed here, as they need to be validated against materials, which is done by RoomCell.
+ * Instead, Room::load() stores symbols of already validated cells via ::setCellSymbols().
+ */
+class RoomTemplate
+{
+	private:
+		std::uint64_t hash;
+		asset_id backwall = ASSET_ID_NONE; // interned texture path
+		uint liquidLevelHeight = 0;
+		char liquidSymbol = '\0';
+		sf::Vector2u spawnCoords { ROOM_WIDTH_WITH_BORDER / 2, ROOM_HEIGHT_WITH_BORDER / 2 }; // Room center by default
+		enum LightObjectsState lightsState = LIGHTS_DEFAULT;
+		struct cell_symbols cells[ROOM_HEIGHT_WITH_BORDER][ROOM_WIDTH_WITH_BORDER];
+
+		std::vector<struct back_obj_data> backObjectsData;
+		std::vector<struct back_obj_data> backObjectsDataFar;
+		std::vector<struct back_obj_data> backHoleObjectsData;
+
+		static bool parseBackObjsNode(const nlohmann::json& root, const std::string& filePath, const std::string& key,
+									  std::vector<struct back_obj_data>& dataVector);
+		static bool readCompiledBackObjs(BinaryReader& reader, std::vector<struct back_obj_data>& dataVector);
+		static void writeCompiledBackObjs(BinaryWriter& writer, const std::vector<struct back_obj_data>& dataVector);
+
+	public:
+		explicit RoomTemplate(std::uint64_t hash);
+		static std::uint64_t getJsonHash(const nlohmann::json& root);
+		bool loadJson(const nlohmann::json& root, const std::string& filePath);
+		bool loadCompiled(BinaryReader& reader);
+		void writeCompiled(BinaryWriter& writer) const;
+		void setCellSymbols(uint x, uint y, const struct cell_symbols& symbols);
+		std::uint64_t getHash() const;
+		asset_id getBackwall() const;
+		uint getLiquidLevelHeight() const;
+		char getLiquidSymbol() const;
+		sf::Vector2u getSpawnCoords() const;
+		enum LightObjectsState getLightsState() const;
+		const struct cell_symbols& getCellSymbols(uint x, uint y) const;
+		const std::vector<struct back_obj_data>& getBackObjectsData() const;
+		const std::vector<struct back_obj_data>& getBackObjectsDataFar() const;
+		const std::vector<struct back_obj_data>& getBackHoleObjectsData() const;
+};
@@ -0,0 +1,63 @@
+// SPDX-License-Identifier: GPL-3.0-only
+//
+// (c) 2024 h67ma <szycikm@gmail.com>
+
+#include "room_template_cache.hpp"
+
+/**
+ * @param hash hash of the template (see RoomTemplate::getJsonHash())
+ * @return the template, or nullptr if no template with such hash is in use
+ */
+std::shared_ptr<const RoomTemplate> RoomTemplateCache::get(std::uint64_t hash)
+{
+	const std::lock_guard<std::mutex> lock(this->mutex);
+
+	auto search = this->templates.find(hash);
+	if (search == this->templates.end())
+		return nullptr;
+
+	return search->second.lock();
+}
+
+/**
+ * Adds a template to the cache. If a template with the same hash is already in use (e.g. because it was loaded on
+ * another thread at the same time), the template is not added, and the existing one is returned instead.
+ *
+ * @param roomTemplate template to add
+ * @return template which should be used by the caller
+ */
+std::shared_ptr<const RoomTemplate> RoomTemplateCache::add(const std::shared_ptr<const RoomTemplate>& roomTemplate)
+{
+	const std::lock_guard<std::mutex> lock(this->mutex);
+
+	std::weak_ptr<const RoomTemplate>& cached = this->templates[roomTemplate->getHash()];
+
+	std::shared_ptr<const RoomTemplate> existing = cached.lock();
+	if (existing != nullptr)
+		return existing;
+
+	cached = roomTemplate;
+	return roomTemplate;
+}
+
+/**
+ * Removes entries of templates which are no longer used by any Room.
+ */
+void RoomTemplateCache::cleanUnused()
+{
+	const std::lock_guard<std::mutex> lock(this->mutex);
+
+	for (auto it = this->templates.begin(); it != this->templates.end();)
+	{
+		if (it->second.expired())
+			it = this->templates.erase(it);
+		else
+			it++;
+	}
+}
+
+void RoomTemplateCache::clear()
+{
+	const std::lock_guard<std::mutex> lock(this->mutex);
+	this->templates.clear();
+}
@@ -0,0 +1,33 @@
+// SPDX-License-Identifier: GPL-3.0-only
+//
+// (c) 2024 h67ma <szycikm@gmail.com>
+
+#pragma once
+
+#include <cstdint>
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "room_template.hpp"
+
+/**
+ * Keeps track of RoomTemplates which are currently in use, so that identical Rooms can share a single template, both
+ * in the same Location and across Locations of a Campaign.
+ *
+ * The cache doesn't keep templates alive by itself - a template is freed as soon as the last Room using it is freed.
+ * It's safe to use from multiple threads.
+ */
+class RoomTemplateCache
+{
+	private:
+		std::mutex mutex;
+		std::unordered_map<std::uint64_t, std::weak_ptr<const RoomTemplate>> templates;
+
+	public:
+		std::shared_ptr<const RoomTemplate> get(std::uint64_t hash);
+		std::shared_ptr<const RoomTemplate> add(const std::shared_ptr<const RoomTemplate>& roomTemplate);
+		void cleanUnused();
+		void clear();
+};
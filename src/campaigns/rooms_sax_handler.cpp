@@ -0,0 +1,172 @@
+// SPDX-License-Identifier: GPL-3.0-only
+//
+// (c) 2024 h67ma <szycikm@gmail.com>
+
+#include "rooms_sax_handler.hpp"
+
+#include <utility>
+
+#include "../hud/log.hpp"
+#include "../util/i18n.hpp"
+#include "../util/json.hpp"
+
+/**
+ * @param filePath rooms file path, just for printing
+ * @param roomCallback called for each element of "rooms" array, as soon as it's parsed. if it returns false, parsing
+ *					   is stopped. the node can be moved from, it will be discarded after the callback returns
+ */
+RoomsSaxHandler::RoomsSaxHandler(const std::string& filePath, std::function<bool(nlohmann::json&)> roomCallback) :
+	filePath(filePath),
+	roomCallback(std::move(roomCallback))
+{
+}
+
+/**
+ * @return root node of the parsed file, with all room nodes removed
+ */
+nlohmann::json& RoomsSaxHandler::getRoot()
+{
+	return this->root;
+}
+
+/**
+ * Adds a value to the container which is currently being built.
+ *
+ * @return pointer to the added value
+ */
+nlohmann::json* RoomsSaxHandler::addValue(nlohmann::json&& value)
+{
+	if (this->stack.empty())
+	{
+		this->root = std::move(value);
+		return &this->root;
+	}
+
+	nlohmann::json* parent = this->stack.back();
+
+	// elements of the rooms array are built separately (see class description)
+	if (parent == this->roomsArray)
+	{
+		this->currentRoom = std::move(value);
+		return &this->currentRoom;
+	}
+
+	if (parent->is_array())
+	{
+		parent->push_back(std::move(value));
+		return &parent->back();
+	}
+
+	nlohmann::json& member = (*parent)[this->lastKey];
+	member = std::move(value);
+	return &member;
+}
+
+/**
+ * Adds a value which is not a container. If the value is a room node (which is invalid, but possible), it's passed to
+ * the callback right away, so that the callback can complain about it.
+ */
+bool RoomsSaxHandler::addScalar(nlohmann::json&& value)
+{
+	if (this->addValue(std::move(value)) != &this->currentRoom)
+		return true;
+
+	bool result = this->roomCallback(this->currentRoom);
+	this->currentRoom = nullptr;
+	return result;
+}
+
+/**
+ * Finishes building the current container. If the container was a room node, it's passed to the callback.
+ */
+bool RoomsSaxHandler::endContainer()
+{
+	nlohmann::json* finished = this->stack.back();
+	this->stack.pop_back();
+
+	if (finished != &this->currentRoom)
+		return true;
+
+	bool result = this->roomCallback(this->currentRoom);
+
+	// free the room node as soon as possible
+	this->currentRoom = nullptr;
+
+	return result;
+}
+
+bool RoomsSaxHandler::null()
+{
+	return this->addScalar(nullptr);
+}
+
+bool RoomsSaxHandler::boolean(bool val)
+{
+	return this->addScalar(val);
+}
+
+bool RoomsSaxHandler::number_integer(std::int64_t val)
+{
+	return this->addScalar(val);
+}
+
+bool RoomsSaxHandler::number_unsigned(std::uint64_t val)
+{
+	return this->addScalar(val);
+}
+
+bool RoomsSaxHandler::number_float(double val, const std::string&)
+{
+	return this->addScalar(val);
+}
+
+bool RoomsSaxHandler::string(std::string& val)
+{
+	return this->addScalar(std::move(val));
+}
+
+bool RoomsSaxHandler::binary(nlohmann::json::binary_t& val)
+{
+	return this->addScalar(std::move(val));
+}
+
+bool RoomsSaxHandler::start_object(std::size_t)
+{
+	this->stack.push_back(this->addValue(nlohmann::json::object()));
+	return true;
+}
+
+bool RoomsSaxHandler::key(std::string& val)
+{
+	this->lastKey = val;
+	return true;
+}
+
+bool RoomsSaxHandler::end_object()
+{
+	return this->endContainer();
+}
+
+bool RoomsSaxHandler::start_array(std::size_t)
+{
+	bool isRoomsArray = this->stack.size() == 1 && this->stack.back() == &this->root && this->root.is_object() &&
+						this->lastKey == FOERR_JSON_KEY_ROOMS;
+
+	nlohmann::json* added = this->addValue(nlohmann::json::array());
+	if (isRoomsArray)
+		this->roomsArray = added;
+
+	this->stack.push_back(added);
+	return true;
+}
+
+bool RoomsSaxHandler::end_array()
+{
+	return this->endContainer();
+}
+
+bool RoomsSaxHandler::parse_error(std::size_t, const std::string&, const nlohmann::json::exception& ex)
+{
+	Log::e(STR_ERROR_PARSING_JSON_FILE, this->filePath.c_str(), ex.what());
+	return false;
+}
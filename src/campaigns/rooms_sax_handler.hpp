@@ -0,0 +1,62 @@
+// SPDX-License-Identifier: GPL-3.0-only
+//
+// (c) 2024 h67ma <szycikm@gmail.com>
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+/**
+ * SAX handler for rooms files (see Location::loadContent() for file structure).
+ *
+ * Parsing the whole rooms file into a single json DOM means that the whole file needs to be kept in memory (in a much
+ * less compact form than the file itself), while Rooms are created from it. Instead, this handler builds the DOM for
+ * everything except elements of the top-level "rooms" array. Each element of that array is built as a separate,
+ * small DOM, which is passed to a callback as soon as it's complete, and freed afterwards. This way only a single room
+ * node is kept in memory at any time (plus whatever the callback decides to keep).
+ *
+ * The resulting root node contains an empty "rooms" array, so that its presence and type can still be checked.
+ *
+ * Usage: nlohmann::json::sax_parse(input, &handler, nlohmann::json::input_format_t::json, true, true)
+ */
+class RoomsSaxHandler
+{
+	private:
+		const std::string& filePath;
+		const std::function<bool(nlohmann::json&)> roomCallback;
+		nlohmann::json root;
+		nlohmann::json currentRoom;
+		nlohmann::json* roomsArray = nullptr;
+		std::vector<nlohmann::json*> stack; // containers which are currently being built
+		std::string lastKey;
+
+		nlohmann::json* addValue(nlohmann::json&& value);
+		bool addScalar(nlohmann::json&& value);
+		bool endContainer();
+
+	public:
+		RoomsSaxHandler(const std::string& filePath, std::function<bool(nlohmann::json&)> roomCallback);
+		nlohmann::json& getRoot();
+
+		// nlohmann::json SAX interface
+		bool null();
+		bool boolean(bool val);
+		bool number_integer(std::int64_t val);
+		bool number_unsigned(std::uint64_t val);
+		bool number_float(double val, const std::string& str);
+		bool string(std::string& val);
+		bool binary(nlohmann::json::binary_t& val);
+		bool start_object(std::size_t elements);
+		bool key(std::string& val);
+		bool end_object();
+		bool start_array(std::size_t elements);
+		bool end_array();
+		bool parse_error(std::size_t position, const std::string& lastToken, const nlohmann::json::exception& ex);
+};
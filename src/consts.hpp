@@ -22,10 +22,13 @@ constexpr float GAME_AREA_MID_Y = 500;
 // paths
 const std::string PATH_DIR_GAMEDATA = ".foerr";
 const std::string PATH_DIR_SAVES = "savegames";
+const std::string PATH_DIR_CACHE = "cache";
 const std::string PATH_SETTINGS = "config.json";
 const std::string PATH_KEYMAP = "keymap.json";
 const std::string PATH_LOCATIONS_META = "locations.json";
 const std::string PATH_LOGFILE = "foerr.log";
+const std::string PATH_ASSET_ARCHIVE = "res.pak";
+const std::string PATH_DIR_RES = "res";
 const std::string PATH_MATERIALS = "res/materials.json";
 const std::string PATH_OBJS = "res/objs.json";
 const std::string PATH_CURSOR_ARROW = "res/hud/cursor/cursor.png";
@@ -56,6 +59,7 @@ enum GameState
 	STATE_MAINMENU,
 	STATE_PLAYING,
 	STATE_PIPBUCK,
+	STATE_LOADING, // campaign is being loaded in the background (see Campaign::loadAsync())
 };
 
 enum Direction
@@ -1,20 +1,102 @@
 // SPDX-License-Identifier: GPL-3.0-only
 //
-// (c) 2022-2023 h67ma <szycikm@gmail.com>
+// (c) 2022-2024 h67ma <szycikm@gmail.com>
 
 #include "loading_screen.hpp"
 
+#include <cstddef>
+
+#include <algorithm>
+
 #include "../settings/settings_manager.hpp"
 #include "../util/i18n.hpp"
+#include "../util/load_progress.hpp"
+#include "../util/util.hpp"
+
+constexpr float PROGRESS_BAR_WIDTH = 400;
+constexpr float PROGRESS_BAR_HEIGHT = 10;
+constexpr float PROGRESS_BAR_OUTLINE_THICKNESS = 1;
+constexpr float LINE_SPACING = 20;
 
 LoadingScreen::LoadingScreen(ResourceManager& resMgr, sf::Vector2u windowSize) :
-	loadingText(STR_LOADING, *resMgr.getFont(FONT_FIXED), FONT_H1, SettingsManager::hudColor)
+	loadingText(STR_LOADING, *resMgr.getFont(FONT_FIXED), FONT_H1, SettingsManager::hudColor),
+	progressText(*resMgr.getFont(FONT_FIXED), FONT_SPAN),
+	cancelHintText(STR_LOADING_CANCEL_HINT, *resMgr.getFont(FONT_FIXED), FONT_SPAN, SettingsManager::hudColor)
 {
+	this->progressText.setFillColor(SettingsManager::hudColor);
+
+	this->progressBarOutline.setSize({ PROGRESS_BAR_WIDTH, PROGRESS_BAR_HEIGHT });
+	this->progressBarOutline.setFillColor(sf::Color::Transparent);
+	this->progressBarOutline.setOutlineColor(SettingsManager::hudColor);
+	this->progressBarOutline.setOutlineThickness(PROGRESS_BAR_OUTLINE_THICKNESS);
+
+	this->progressBar.setFillColor(SettingsManager::hudColor);
+
 	this->loadingText.setPosition(static_cast<float>((windowSize.x - this->loadingText.getLocalBounds().width) / 2),
 								  static_cast<float>((windowSize.y - this->loadingText.getLocalBounds().height) / 2));
 }
 
+/**
+ * Refreshes displayed progress and positions of all components. Should be called on every frame while the loading
+ * screen is displayed.
+ *
+ * @param windowSize current window size
+ */
+void LoadingScreen::update(sf::Vector2u windowSize)
+{
+	this->showProgress = true;
+
+	const LoadProgress& progress = *LoadProgress::getMain();
+	std::size_t roomsTotal = progress.getRoomsTotal();
+	std::size_t kibRead = static_cast<std::size_t>(progress.getBytesRead() / 1024);
+
+	// total number of Rooms is only known when loading compiled Rooms
+	this->showProgressBar = roomsTotal > 0;
+	if (this->showProgressBar)
+	{
+		std::size_t roomsParsed = std::min(progress.getRoomsParsed(), roomsTotal);
+		this->progressText.setString(litSprintf(STR_LOADING_PROGRESS, roomsParsed, roomsTotal,
+												progress.getTexturesDecoded(), kibRead));
+		this->progressBar.setSize({ PROGRESS_BAR_WIDTH * static_cast<float>(roomsParsed) /
+										static_cast<float>(roomsTotal),
+									PROGRESS_BAR_HEIGHT });
+	}
+	else
+	{
+		this->progressText.setString(litSprintf(STR_LOADING_PROGRESS_NO_TOTAL, progress.getRoomsParsed(),
+												progress.getTexturesDecoded(), kibRead));
+	}
+
+	float centerX = static_cast<float>(windowSize.x) / 2;
+	float y = static_cast<float>((windowSize.y - this->loadingText.getLocalBounds().height) / 2);
+
+	this->loadingText.setPosition(centerX - this->loadingText.getLocalBounds().width / 2, y);
+	y += this->loadingText.getLocalBounds().height + LINE_SPACING;
+
+	this->progressText.setPosition(centerX - this->progressText.getLocalBounds().width / 2, y);
+	y += this->progressText.getLocalBounds().height + LINE_SPACING;
+
+	this->progressBarOutline.setPosition(centerX - PROGRESS_BAR_WIDTH / 2, y);
+	this->progressBar.setPosition(centerX - PROGRESS_BAR_WIDTH / 2, y);
+	y += PROGRESS_BAR_HEIGHT + LINE_SPACING;
+
+	this->cancelHintText.setPosition(centerX - this->cancelHintText.getLocalBounds().width / 2, y);
+}
+
 void LoadingScreen::draw(sf::RenderTarget& target, sf::RenderStates states) const
 {
 	target.draw(this->loadingText, states);
+
+	if (!this->showProgress)
+		return;
+
+	target.draw(this->progressText, states);
+
+	if (this->showProgressBar)
+	{
+		target.draw(this->progressBarOutline, states);
+		target.draw(this->progressBar, states);
+	}
+
+	target.draw(this->cancelHintText, states);
 }
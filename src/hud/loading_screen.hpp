@@ -1,21 +1,32 @@
 // SPDX-License-Identifier: GPL-3.0-only
 //
-// (c) 2022-2023 h67ma <szycikm@gmail.com>
+// (c) 2022-2024 h67ma <szycikm@gmail.com>
 
 #pragma once
 
 #include <SFML/Graphics/Drawable.hpp>
+#include <SFML/Graphics/RectangleShape.hpp>
 #include <SFML/Graphics/RenderTarget.hpp>
 
 #include "../resources/resource_manager.hpp"
 #include "text_label.hpp"
 
+/**
+ * Displays "Loading..." along with progress of the current background load (see LoadProgress).
+ */
 class LoadingScreen : public sf::Drawable
 {
 	private:
 		TextLabel loadingText;
+		TextLabel progressText;
+		TextLabel cancelHintText;
+		sf::RectangleShape progressBarOutline;
+		sf::RectangleShape progressBar;
+		bool showProgress = false; // only set when ::update() is called, as not all loads report progress
+		bool showProgressBar = false;
 
 	public:
 		LoadingScreen(ResourceManager& resMgr, sf::Vector2u windowSize);
+		void update(sf::Vector2u windowSize);
 		void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
 };
@@ -21,6 +21,10 @@ sf::Clock Log::clock;
 
 std::ofstream Log::logFile;
 msg_add_function Log::msgAddedCallback = nullptr;
+std::mutex Log::mutex;
+std::thread::id Log::mainThreadId = std::this_thread::get_id();
+std::list<StringAndColor> Log::pendingHudMessages;
+thread_local std::vector<struct log_message>* Log::capture = nullptr;
 
 /**
  * Sets *temporary* SettingsManager settings, which are relevant only in the short window of time between when
@@ -30,12 +34,67 @@ msg_add_function Log::msgAddedCallback = nullptr;
  */
 void Log::setup()
 {
+	Log::mainThreadId = std::this_thread::get_id();
+
 	SettingsManager::debugWriteLogToFile = false;
 	SettingsManager::debugPrintToStderr = true;
 	SettingsManager::debugVerbose = true;
 	SettingsManager::guiScale = 1.F;
 }
 
+void Log::write(const char* prefix, sf::Color color, bool hideInGui, const std::string& formatted)
+{
+	{
+		const std::lock_guard<std::mutex> lock(Log::mutex);
+
+		if (SettingsManager::debugPrintToStderr)
+			Log::logStderr(prefix, formatted);
+
+		if (SettingsManager::debugWriteLogToFile)
+			Log::logToFile(prefix, formatted);
+
+		// don't display debug msgs in hud
+		if (hideInGui)
+			return;
+
+		// hud elements can only be touched by the main thread, it will pick up the message in ::tick()
+		if (std::this_thread::get_id() != Log::mainThreadId)
+		{
+			Log::pendingHudMessages.emplace_back(formatted, color);
+			return;
+		}
+	}
+
+	Log::addHudMessage({ formatted, color });
+}
+
+/**
+ * Holds back all messages logged by the calling thread, until ::stopCapture() is called. Messages can then be logged
+ * with ::replay(), e.g. so that messages from jobs running in parallel are logged in a deterministic order.
+ *
+ * @param messages captured messages will be added here
+ */
+void Log::startCapture(std::vector<struct log_message>& messages)
+{
+	Log::capture = &messages;
+}
+
+void Log::stopCapture()
+{
+	Log::capture = nullptr;
+}
+
+/**
+ * Logs messages previously captured with ::startCapture().
+ */
+void Log::replay(const std::vector<struct log_message>& messages)
+{
+	for (const struct log_message& message : messages)
+	{
+		Log::write(message.prefix, message.color, message.hideInGui, message.text);
+	}
+}
+
 void Log::setFont(sf::Font* font)
 {
 	Log::font = font;
@@ -76,6 +135,7 @@ void Log::openLogFile()
 /**
  * Removes old items from history.
  * If update should happen (based on private clock) and there are items in history, calculate their positions.
+ * Unless forced, also displays messages logged from worker threads since the last tick.
  *
  * @param force update even if there was an update in last `LOG_UPDATE_FREQUENCY_MS`
  */
@@ -85,6 +145,21 @@ void Log::tick(bool force)
 	uint y = LOG_ANCHOR_PADDING_TOP; // constant offset from top, will be enough for CORNER_TOP_*
 	uint timesUpCnt = 0;
 
+	if (!force)
+	{
+		std::list<StringAndColor> pending;
+
+		{
+			const std::lock_guard<std::mutex> lock(Log::mutex);
+			pending.swap(Log::pendingHudMessages);
+		}
+
+		for (const auto& message : pending)
+		{
+			Log::addHudMessage(message);
+		}
+	}
+
 	if ((Log::hudHistory.empty() || Log::clock.getElapsedTime().asMilliseconds() < LOG_UPDATE_FREQUENCY_MS) && !force)
 		return;
 
@@ -109,6 +184,21 @@ void Log::tick(bool force)
 	Log::clock.restart();
 }
 
+/**
+ * Displays a message in hud and passes it to the callback. Must be called from the main thread.
+ */
+void Log::addHudMessage(const StringAndColor& message)
+{
+	if (Log::font != nullptr)
+	{
+		Log::hudHistory.emplace_back(message.first, *Log::font, message.second);
+		Log::tick(true);
+	}
+
+	if (Log::msgAddedCallback != nullptr)
+		Log::msgAddedCallback(message);
+}
+
 void Log::draw(sf::RenderTarget& target)
 {
 	for (const auto& item : Log::hudHistory)
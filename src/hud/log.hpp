@@ -8,7 +8,11 @@
 #include <functional>
 #include <iostream>
 #include <list>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #include <SFML/Graphics/Color.hpp>
 #include <SFML/Graphics/Font.hpp>
@@ -28,6 +32,15 @@
 
 using msg_add_function = std::function<void(const StringAndColor&)>;
 
+// message held back by Log::startCapture()
+struct log_message
+{
+		const char* prefix;
+		sf::Color color;
+		bool hideInGui;
+		std::string text;
+};
+
 class Log
 {
 	private:
@@ -39,6 +52,12 @@ class Log
 		static sf::Clock clock;
 		static std::ofstream logFile;
 		static msg_add_function msgAddedCallback;
+		static std::mutex mutex; // messages can be logged from worker threads, e.g. when loading Rooms
+		static std::thread::id mainThreadId;
+		static std::list<StringAndColor> pendingHudMessages; // logged from worker threads, guarded by ::mutex
+		static thread_local std::vector<struct log_message>* capture; // see ::startCapture()
+		static void write(const char* prefix, sf::Color color, bool hideInGui, const std::string& formatted);
+		static void addHudMessage(const StringAndColor& message);
 		static void logToFile(const char* prefix, const std::string& msg);
 		static void logStderr(const char* prefix, const std::string& msg);
 
@@ -52,6 +71,9 @@ class Log
 		static void tick(bool force = false);
 		static void draw(sf::RenderTarget& target);
 		static void close();
+		static void startCapture(std::vector<struct log_message>& messages);
+		static void stopCapture();
+		static void replay(const std::vector<struct log_message>& messages);
 
 		/**
 		 * Adds a formatted message to the game log. Both `fmt` and `args` must not contain newlines.
@@ -69,24 +91,13 @@ class Log
 
 			std::string formatted = litSprintf(fmt, args...);
 
-			if (SettingsManager::debugPrintToStderr)
-				Log::logStderr(prefix, formatted);
-
-			if (SettingsManager::debugWriteLogToFile)
-				Log::logToFile(prefix, formatted);
-
-			// don't display debug msgs in hud
-			if (hideInGui)
-				return;
-
-			if (Log::font != nullptr)
+			if (Log::capture != nullptr)
 			{
-				Log::hudHistory.emplace_back(formatted, *Log::font, color);
-				Log::tick(true);
+				Log::capture->push_back({ prefix, color, hideInGui, std::move(formatted) });
+				return;
 			}
 
-			if (msgAddedCallback != nullptr)
-				msgAddedCallback({ formatted, color });
+			Log::write(prefix, color, hideInGui, formatted);
 		}
 
 		/**
@@ -233,6 +233,15 @@ void MainMenu::handleScreenResize(sf::Vector2u newSize)
 	this->licenseText.setPosition(5, newSize.y - 10 - this->licenseText.getLocalBounds().height);
 }
 
+void MainMenu::tick()
+{
+	// all pages are ticked, not only the selected one, so they're up to date once they're displayed
+	for (const auto& page : this->pages)
+	{
+		page.second->tick();
+	}
+}
+
 void MainMenu::handleSettingsChange()
 {
 	this->versionText.handleSettingsChange();
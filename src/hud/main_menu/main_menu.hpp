@@ -51,6 +51,7 @@ class MainMenu : public sf::Drawable, public sf::Transformable, public Configura
 		void handleLeftClickUp();
 		void handleMouseMove(sf::Vector2i mousePos);
 		void handleScreenResize(sf::Vector2u newSize);
+		void tick();
 		void handleSettingsChange() override;
 		void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
 };
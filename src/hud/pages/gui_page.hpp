@@ -63,6 +63,9 @@ class GuiPage : public sf::Drawable, public GuiTransformable
 		}
 
 		virtual void unloadCampaignInfos() {}
+
+		// called on every frame while the page can be displayed
+		virtual void tick() {}
 		void handleSettingsChange() override;
 		const std::string pageTitle;
 };
@@ -4,55 +4,19 @@
 
 #include "gui_page_new_game.hpp"
 
-#include <filesystem>
-#include <set>
-
 #include "../../consts.hpp"
 #include "../../util/i18n.hpp"
-#include "../../util/json.hpp"
-#include "../loading_screen.hpp"
+#include "../../util/load_progress.hpp"
 #include "../log.hpp"
 
 constexpr uint BTN_POS_LEFT = 0;
 constexpr uint BTN_POS_TOP = 10;
 constexpr uint BTN_POS_HEIGHT = 35;
 
-struct campaign_meta
-{
-		std::string title;
-		std::string description;
-};
-
-/**
- * Reads a _index.json file for a given campaign ID and fills the meta structure with relevant info.
- * In case of any errors, the meta struct will be filled with ??? and errors/warnings will be logged.
- *
- * @param meta reference to metadata struct to fill
- * @param campaignId campaign ID
- */
-static void getCampaignMeta(struct campaign_meta& meta, const std::string& campaignId)
-{
-	std::string indexPath = pathCombine(PATH_CAMPAIGNS, campaignId, FILENAME_INDEX);
-
-	nlohmann::json root;
-	if (!loadJsonFromFile(root, indexPath))
-	{
-		meta.title = CONFUSION;
-		meta.description = CONFUSION;
-		return;
-	}
-
-	if (!parseJsonKey<std::string>(root, indexPath, FOERR_JSON_KEY_TITLE, meta.title))
-		meta.title = CONFUSION;
-
-	if (!parseJsonKey<std::string>(root, indexPath, FOERR_JSON_KEY_DESCRIPTION, meta.description))
-		meta.description = CONFUSION;
-}
-
 static void btnRefresh(GuiPageNewGame* page)
 {
 	Log::i(STR_REFRESHING_CAMPAIGN_LIST);
-	page->rebuildCampaignList();
+	page->refreshCampaignList();
 }
 
 GuiPageNewGame::GuiPageNewGame(ResourceManager& resMgr, CursorManager& cursorMgr, sf::RenderWindow& window,
@@ -66,7 +30,24 @@ GuiPageNewGame::GuiPageNewGame(ResourceManager& resMgr, CursorManager& cursorMgr
 	gameState(gameState),
 	pipBuck(pipBuck)
 {
+	// cached catalog is displayed right away, and updated in the background in case campaigns have changed
+	this->catalog.load();
 	this->rebuildCampaignList();
+	this->catalog.startRescan();
+}
+
+/**
+ * Starts rescanning installed campaigns in the background. The list will be rebuilt in ::tick() if anything changed.
+ */
+void GuiPageNewGame::refreshCampaignList()
+{
+	this->catalog.startRescan();
+}
+
+void GuiPageNewGame::tick()
+{
+	if (this->catalog.handleRescanFinished())
+		this->rebuildCampaignList();
 }
 
 void GuiPageNewGame::rebuildCampaignList()
@@ -74,26 +55,13 @@ void GuiPageNewGame::rebuildCampaignList()
 	this->campaignListHoverMgr.clear();
 	this->campaignItems.clear();
 
-	// directory_iterator outputs unsorted entries, use a set to sort them
-	std::set<std::string> sortedIds;
-
-	for (const auto& entry : std::filesystem::directory_iterator(PATH_CAMPAIGNS))
-	{
-		if (!entry.is_directory())
-			continue;
-
-		sortedIds.insert(entry.path().stem().string());
-	}
-
 	uint i = 0;
-	for (std::string campaignId : sortedIds)
+	for (const auto& entry : this->catalog.getEntries())
 	{
-		struct campaign_meta meta;
-		getCampaignMeta(meta, campaignId);
-
+		std::string campaignId = entry.id;
 		SimpleButton btn(BTN_NORMAL, this->resMgr, sf::Vector2u(BTN_POS_LEFT, BTN_POS_TOP + BTN_POS_HEIGHT * i),
-						 meta.title);
-		// TODO display meta.description in a side panel
+						 entry.title);
+		// TODO display entry.description and entry.locationCnt in a side panel
 
 		this->campaignItems.emplace_back(campaignId, btn);
 		i++;
@@ -110,37 +78,51 @@ void GuiPageNewGame::rebuildCampaignList()
 	this->hoverMgr += &this->refreshButton;
 }
 
-bool GuiPageNewGame::loadCampaign(const std::string& campaignId)
+/**
+ * Starts loading a campaign in the background. The loading screen is displayed until the load is finished, after which
+ * the game starts, or the main menu is displayed again if the load failed.
+ *
+ * @param campaignId id of the campaign to load
+ */
+void GuiPageNewGame::loadCampaign(const std::string& campaignId)
 {
-	// this is a pretty terrible way of showing a loading screen, but it will do for now
-	// TODO load on thread, display loading screen in main loop with a progress bar
-	LoadingScreen loadingScreen(this->resMgr, this->window.getSize());
-	this->window.clear();
-	this->window.draw(loadingScreen);
-	this->window.display();
-
-	if (!this->campaign.load(campaignId))
-	{
-		Log::e(STR_CAMPAIGN_LOAD_FAILED);
-		return false;
-	}
-
-	if (!this->pipBuck.setupCampaignInfos())
-	{
-		Log::e(STR_PIPBUCK_SETUP_FAILED);
-
-		// unroll
-		this->campaign.unload();
-
-		return false;
-	}
-
-	this->gameState = STATE_PLAYING;
-
-	// TODO query campaign to check what the player is actually pointing at and set proper cursor color
-	this->cursorMgr.setCursor(CROSSHAIR_WHITE);
-
-	return true;
+	this->gameState = STATE_LOADING;
+
+	this->campaign.loadAsync(campaignId,
+							 [this](bool loaded)
+							 {
+								 if (!loaded)
+								 {
+									 this->gameState = STATE_MAINMENU;
+									 if (LoadProgress::getMain()->isCancelled())
+										 return;
+
+									 Log::e(STR_CAMPAIGN_LOAD_FAILED);
+
+									 // maybe something changed on disk since the list was initially loaded, e.g. a dir
+									 // was renamed or removed. refresh campaign list in an attempt to reflect any
+									 // changes
+									 Log::w(STR_REFRESHING_CAMPAIGN_LIST);
+									 this->refreshCampaignList();
+									 return;
+								 }
+
+								 if (!this->pipBuck.setupCampaignInfos())
+								 {
+									 Log::e(STR_PIPBUCK_SETUP_FAILED);
+
+									 // unroll
+									 this->campaign.unload();
+									 this->gameState = STATE_MAINMENU;
+									 return;
+								 }
+
+								 this->gameState = STATE_PLAYING;
+
+								 // TODO query campaign to check what the player is actually pointing at and set proper
+								 // cursor color
+								 this->cursorMgr.setCursor(CROSSHAIR_WHITE);
+							 });
 }
 
 void GuiPageNewGame::handleSettingsChange()
@@ -172,15 +154,7 @@ ClickStatus GuiPageNewGame::handleLeftClick(sf::Vector2i clickPos)
 		ClickStatus status = item.button.handleLeftClick(clickPos);
 		if (status != CLICK_NOT_CONSUMED)
 		{
-			if (!this->loadCampaign(item.campaignId))
-			{
-				// maybe something changed on disk since the list was initially loaded, e.g. a dir was renamed or
-				// removed. refresh campaign list in an attempt to reflect any changes
-				Log::w(STR_REFRESHING_CAMPAIGN_LIST);
-				this->rebuildCampaignList();
-				return CLICK_CONSUMED;
-			}
-
+			this->loadCampaign(item.campaignId);
 			return CLICK_CONSUMED_RESET_MENU;
 		}
 	}
@@ -9,6 +9,7 @@
 
 #include <SFML/Graphics/RenderWindow.hpp>
 
+#include "../../campaigns/campaign_catalog.hpp"
 #include "../../resources/resource_manager.hpp"
 #include "../../window/cursor_manager.hpp"
 #include "../buttons/simple_button.hpp"
@@ -33,6 +34,7 @@ class GuiPageNewGame : public GuiPage
 				}
 		};
 
+		CampaignCatalog catalog;
 		HoverManager campaignListHoverMgr;
 		HoverManager hoverMgr;
 		std::vector<struct GuiPageNewGame::list_item> campaignItems; // TODO use some sort of scrollable list instead
@@ -44,12 +46,14 @@ class GuiPageNewGame : public GuiPage
 		GameState& gameState;
 		PipBuck& pipBuck;
 
-		bool loadCampaign(const std::string& campaignId);
+		void loadCampaign(const std::string& campaignId);
 
 	public:
 		GuiPageNewGame(ResourceManager& resMgr, CursorManager& cursorMgr, sf::RenderWindow& window, Campaign& campaign,
 					   GameState& gameState, PipBuck& pipBuck);
 		void rebuildCampaignList();
+		void refreshCampaignList();
+		void tick() override;
 		void handleSettingsChange() override;
 		bool handleMouseMove(sf::Vector2i mousePos) override;
 		ClickStatus handleLeftClick(sf::Vector2i clickPos) override;
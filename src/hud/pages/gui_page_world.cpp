@@ -21,30 +21,14 @@ constexpr uchar GRID_LINES_TRANSPARENCY = 0x40;
 constexpr uint DESC_TEXT_WIDTH = 430;
 constexpr float MAP_GRID_SPACING = 110;
 constexpr float SQRT2 = 1.414213562;
+constexpr int PREFETCH_HOVER_DELAY_MS = 300;
 
-GuiPageWorld::GuiPageWorld(ResourceManager& resMgr, Campaign& campaign) :
+GuiPageWorld::GuiPageWorld(ResourceManager& resMgr, Campaign& campaign, GameState& gameState) :
 	GuiPage("World"), // TODO translate
 	resMgr(resMgr),
 	campaign(campaign),
-	gotoLocationBtn(BTN_NORMAL, resMgr, POS_BTN_GOTO, "Travel",
-					[this]()
-					{
-						auto search = this->mapButtons.find(this->selectedLocId);
-						if (search == this->mapButtons.end())
-							return;
-
-						// TODO display a loading screen
-						if (!this->campaign.changeLocation(this->selectedLocId))
-							return;
-
-						this->updateActiveIndicator();
-
-						// reset selection
-						// no need to reset texts as now they are not shown anyway
-						search->second.setSelected(false);
-						this->selectedLocId = NO_LOCATION_SELECTED;
-						this->travelButtonAvailable = false;
-					}),
+	gameState(gameState),
+	gotoLocationBtn(BTN_NORMAL, resMgr, POS_BTN_GOTO, "Travel", [this]() { this->travel(); }),
 	locTitle(*resMgr.getFont(FONT_MEDIUM), FONT_H2, POS_LOC_TITLE),
 	locDescription(*resMgr.getFont(FONT_NORMAL), FONT_SPAN, POS_LOC_DESCRIPTION)
 {
@@ -124,6 +108,10 @@ ClickStatus GuiPageWorld::handleLeftClick(sf::Vector2i clickPos)
 				// prevent traveling to the location which is already active
 				this->travelButtonAvailable = this->selectedLocId != this->campaign.getCurrentLocation()->getId();
 
+				// the player will probably travel to the selected location, so start loading it already
+				if (this->travelButtonAvailable)
+					this->campaign.prefetchLocation(this->selectedLocId);
+
 				return CLICK_CONSUMED;
 			}
 		}
@@ -146,15 +134,54 @@ bool GuiPageWorld::handleMouseMove(sf::Vector2i mousePos)
 	if (this->mapContainsPoint(mousePos))
 	{
 		if (this->mapButtonHoverMgr.handleMouseMove(mousePos))
+		{
+			for (auto& btn : this->mapButtons)
+			{
+				if (btn.second.containsPoint(mousePos))
+				{
+					this->setHoveredLocation(btn.first);
+					break;
+				}
+			}
+
 			return true;
+		}
 	}
 
+	this->setHoveredLocation(NO_LOCATION_SELECTED);
+
 	if (this->isAnyLocationSelected() && this->travelButtonAvailable)
 		return this->hoverMgr.handleMouseMove(mousePos);
 
 	return false;
 }
 
+void GuiPageWorld::setHoveredLocation(const std::string& locId)
+{
+	if (locId == this->hoveredLocId)
+		return;
+
+	this->hoveredLocId = locId;
+	this->hoverTimer.restart();
+}
+
+/**
+ * Prefetches the hovered location (see Campaign::prefetchLocation()) once the mouse has stayed on it for a moment, so
+ * that moving the mouse across the map doesn't start (and discard) a load for every location on the way.
+ */
+void GuiPageWorld::tick()
+{
+	if (this->hoveredLocId == NO_LOCATION_SELECTED ||
+		this->hoverTimer.getElapsedTime().asMilliseconds() < PREFETCH_HOVER_DELAY_MS)
+		return;
+
+	// hovering is a weaker hint than selecting, so don't replace the prefetched selected location
+	if (!this->isAnyLocationSelected())
+		this->campaign.prefetchLocation(this->hoveredLocId);
+
+	this->hoveredLocId = NO_LOCATION_SELECTED;
+}
+
 void GuiPageWorld::setComponentColors()
 {
 	this->mapBg.setColor(SettingsManager::hudColor);
@@ -268,6 +295,37 @@ void GuiPageWorld::setGuiScale()
 	this->updateActiveIndicator();
 }
 
+/**
+ * Starts changing the current Location to the selected one in the background. The loading screen is displayed until
+ * the change is finished, after which the PipBuck is displayed again.
+ */
+void GuiPageWorld::travel()
+{
+	if (this->mapButtons.find(this->selectedLocId) == this->mapButtons.end())
+		return;
+
+	this->gameState = STATE_LOADING;
+
+	this->campaign.changeLocationAsync(this->selectedLocId,
+									   [this](bool changed)
+									   {
+										   this->gameState = STATE_PIPBUCK;
+										   if (!changed)
+											   return;
+
+										   this->updateActiveIndicator();
+
+										   // reset selection
+										   // no need to reset texts as now they are not shown anyway
+										   auto search = this->mapButtons.find(this->selectedLocId);
+										   if (search != this->mapButtons.end())
+											   search->second.setSelected(false);
+
+										   this->selectedLocId = NO_LOCATION_SELECTED;
+										   this->travelButtonAvailable = false;
+									   });
+}
+
 bool GuiPageWorld::isAnyLocationSelected() const
 {
 	return this->selectedLocId != NO_LOCATION_SELECTED; // NOLINT(readability-container-size-empty)
@@ -8,6 +8,7 @@
 #include <unordered_map>
 
 #include <SFML/Graphics/CircleShape.hpp>
+#include <SFML/System/Clock.hpp>
 
 #include "../../campaigns/campaign.hpp"
 #include "../../resources/resource_manager.hpp"
@@ -29,6 +30,7 @@ class GuiPageWorld : public GuiPage
 	private:
 		ResourceManager& resMgr;
 		Campaign& campaign;
+		GameState& gameState;
 		SpriteResource mapBg;
 		sf::VertexArray mapBorder = sf::VertexArray(sf::LineStrip, 5);
 		sf::VertexArray mapGridLines = sf::VertexArray(sf::Lines, 16); // max 4 horizontal, 4 vertical
@@ -44,6 +46,11 @@ class GuiPageWorld : public GuiPage
 		// NOLINTNEXTLINE(readability-redundant-string-init)
 		std::string selectedLocId = NO_LOCATION_SELECTED;
 
+		// location which will be prefetched if it stays hovered for a moment (see ::tick())
+		// NOLINTNEXTLINE(readability-redundant-string-init)
+		std::string hoveredLocId = NO_LOCATION_SELECTED;
+		sf::Clock hoverTimer;
+
 		bool travelButtonAvailable = false;
 		void setComponentColors();
 		void setupMapDecorations();
@@ -51,11 +58,14 @@ class GuiPageWorld : public GuiPage
 		void updateActiveIndicator();
 		void setGuiScale();
 		bool isAnyLocationSelected() const;
+		void travel();
+		void setHoveredLocation(const std::string& locId);
 
 	public:
-		GuiPageWorld(ResourceManager& resMgr, Campaign& campaign);
+		GuiPageWorld(ResourceManager& resMgr, Campaign& campaign, GameState& gameState);
 		ClickStatus handleLeftClick(sf::Vector2i clickPos) override;
 		bool handleMouseMove(sf::Vector2i mousePos) override;
+		void tick() override;
 		bool setupCampaignInfos() override;
 		void unloadCampaignInfos() override;
 		void handleSettingsChange() override;
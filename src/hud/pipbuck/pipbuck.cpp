@@ -72,7 +72,7 @@ PipBuck::PipBuck(ResourceManager& resMgr, CursorManager& cursorMgr, Campaign& ca
 		  std::make_shared<PipBuckCategory>(resMgr, PIPB_PAGE_MAP,
 											std::map<PipBuckPageType, std::shared_ptr<GuiPage>> {
 												{ PIPB_PAGE_MAP, std::make_shared<GuiPageMap>(resMgr) },
-												{ PIPB_PAGE_WORLD, std::make_shared<GuiPageWorld>(resMgr, campaign) },
+												{ PIPB_PAGE_WORLD, std::make_shared<GuiPageWorld>(resMgr, campaign, gameState) },
 												{ PIPB_PAGE_QUESTS, std::make_shared<GuiPageQuests>(resMgr) },
 												{ PIPB_PAGE_NOTES, std::make_shared<GuiPageNotes>(resMgr) },
 												{ PIPB_PAGE_ENEMIES, std::make_shared<GuiPageEnemies>(resMgr) } }) },
@@ -480,6 +480,9 @@ void PipBuck::tick()
 	this->radIndicator.setRotation(
 		this->radIndicatorLevel * -180 +
 		static_cast<float>(this->getSmoothNoise(this->timer.getElapsedTime().asSeconds()) / 2));
+
+	if (this->selectedCategory != nullptr)
+		this->selectedCategory->tick();
 }
 
 void PipBuck::setGuiScale()
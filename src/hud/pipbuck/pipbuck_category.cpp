@@ -164,6 +164,13 @@ bool PipBuckCategory::handleMouseMove(sf::Vector2i mousePos)
 	return this->hoverMgr.handleMouseMove(mousePos);
 }
 
+void PipBuckCategory::tick()
+{
+	// only the selected page is ticked, as the others can't be interacted with
+	if (this->selectedPage != nullptr)
+		this->selectedPage->tick();
+}
+
 /**
  * Setups the PipBuck pages according to campaign data.
  * Locations in the campaign should be already loaded.
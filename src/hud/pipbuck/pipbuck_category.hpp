@@ -56,6 +56,7 @@ class PipBuckCategory : public sf::Drawable, public sf::Transformable, public Co
 		void handleLeftClickUp();
 		void handleScroll(float delta, sf::Vector2i mousePos);
 		bool handleMouseMove(sf::Vector2i mousePos);
+		void tick();
 		bool changePage(PipBuckPageType newPageType);
 		bool setupCampaignInfos();
 		void unloadCampaignInfos();
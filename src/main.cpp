@@ -7,6 +7,7 @@
 
 #include <functional>
 #include <iostream>
+#include <unordered_set>
 
 #include <SFML/System/Clock.hpp>
 #include <SFML/Window/Event.hpp>
@@ -20,6 +21,8 @@
 #include "hud/log.hpp"
 #include "hud/main_menu/main_menu.hpp"
 #include "hud/pipbuck/pipbuck.hpp"
+#include "resources/asset_archive.hpp"
+#include "resources/asset_manifest.hpp"
 #include "resources/resource_manager.hpp"
 #include "settings/keymap.hpp"
 #include "settings/settings_manager.hpp"
@@ -59,6 +62,9 @@ int main()
 	SettingsManager::loadConfig();
 	Log::openLogFile();
 
+	AssetArchive::open(PATH_ASSET_ARCHIVE); // optional
+	AssetManifest::build(PATH_DIR_RES);
+
 	sf::RenderWindow window;
 	sf::View gameWorldView({ GAME_AREA_MID_X, GAME_AREA_MID_Y }, { GAME_AREA_WIDTH, GAME_AREA_HEIGHT });
 	sf::View hudView;
@@ -216,8 +222,12 @@ int main()
 				  campaign.gotoRoom(DIR_BACK);
 		  } },
 
-		{ ACTION_TOGGLE_FULLSCREEN, [&window, &fpsMeter, &hudView, &gameWorldView, &pipBuck, &mainMenu, &console]()
-		  { toggleFullscreen(window, fpsMeter, hudView, gameWorldView, pipBuck, mainMenu, console); } },
+		{ ACTION_TOGGLE_FULLSCREEN,
+		  [&window, &fpsMeter, &hudView, &gameWorldView, &pipBuck, &mainMenu, &console, &resManager, &campaign]()
+		  {
+			  toggleFullscreen(window, fpsMeter, hudView, gameWorldView, pipBuck, mainMenu, console, resManager,
+							   campaign);
+		  } },
 
 		{ ACTION_DEBUG_TOGGLE_CONSOLE, [&console]() { console.open(); } },
 		{ ACTION_DEBUG_REPEAT_LAST_CONSOLE_CMD,
@@ -268,23 +278,32 @@ int main()
 		{ ACTION_PIPB_GOTO_ENEMIES,
 		  [&pipBuck, &window]() { pipBuck.switchToPage(PIPB_PAGE_ENEMIES, sf::Mouse::getPosition(window)); } },
 
-		{ ACTION_TOGGLE_FULLSCREEN, [&window, &fpsMeter, &hudView, &gameWorldView, &pipBuck, &mainMenu, &console]()
-		  { toggleFullscreen(window, fpsMeter, hudView, gameWorldView, pipBuck, mainMenu, console); } },
+		{ ACTION_TOGGLE_FULLSCREEN,
+		  [&window, &fpsMeter, &hudView, &gameWorldView, &pipBuck, &mainMenu, &console, &resManager, &campaign]()
+		  {
+			  toggleFullscreen(window, fpsMeter, hudView, gameWorldView, pipBuck, mainMenu, console, resManager,
+							   campaign);
+		  } },
 
 		{ ACTION_DEBUG_TOGGLE_CONSOLE, [&console]() { console.open(); } },
 		{ ACTION_DEBUG_REPEAT_LAST_CONSOLE_CMD, [&console]() { console.executeLast(); } },
 	};
 
 	std::unordered_map<KeyAction, std::function<void(void)>> mainMenuCbs {
-		{ ACTION_TOGGLE_FULLSCREEN, [&window, &fpsMeter, &hudView, &gameWorldView, &pipBuck, &mainMenu, &console]()
-		  { toggleFullscreen(window, fpsMeter, hudView, gameWorldView, pipBuck, mainMenu, console); } },
+		{ ACTION_TOGGLE_FULLSCREEN,
+		  [&window, &fpsMeter, &hudView, &gameWorldView, &pipBuck, &mainMenu, &console, &resManager, &campaign]()
+		  {
+			  toggleFullscreen(window, fpsMeter, hudView, gameWorldView, pipBuck, mainMenu, console, resManager,
+							   campaign);
+		  } },
 
 		{ ACTION_DEBUG_TOGGLE_CONSOLE, [&console]() { console.open(); } },
 		{ ACTION_DEBUG_REPEAT_LAST_CONSOLE_CMD, [&console]() { console.executeLast(); } },
 	};
 
 	// initial size
-	windowSizeChanged(window.getSize(), fpsMeter, hudView, gameWorldView, pipBuck, mainMenu, console);
+	windowSizeChanged(window.getSize(), fpsMeter, hudView, gameWorldView, pipBuck, mainMenu, console, resManager,
+					  campaign);
 
 	cursorMgr.setCursor(POINTER);
 
@@ -293,13 +312,22 @@ int main()
 	{
 		Log::d(STR_AUTLOADING_CAMPAIGN);
 
-		if (campaign.load(SettingsManager::debugAutoloadCampaign) && pipBuck.setupCampaignInfos())
-		{
-			gameState = STATE_PLAYING;
-
-			// TODO query campaign to check what the player is actually pointing at and set proper cursor color
-			cursorMgr.setCursor(CROSSHAIR_WHITE);
-		}
+		gameState = STATE_LOADING;
+		campaign.loadAsync(SettingsManager::debugAutoloadCampaign,
+						   [&gameState, &pipBuck, &cursorMgr](bool loaded)
+						   {
+							   if (!loaded || !pipBuck.setupCampaignInfos())
+							   {
+								   gameState = STATE_MAINMENU;
+								   return;
+							   }
+
+							   gameState = STATE_PLAYING;
+
+							   // TODO query campaign to check what the player is actually pointing at and set proper
+							   // cursor color
+							   cursorMgr.setCursor(CROSSHAIR_WHITE);
+						   });
 	}
 
 	tickTimer.restart(); // so that all initialization above won't be counted
@@ -404,6 +432,16 @@ int main()
 					continue;
 				}
 			}
+			else if (gameState == STATE_LOADING)
+			{
+				if (event.type == sf::Event::KeyPressed)
+				{
+					if (event.key.code == sf::Keyboard::Escape)
+						campaign.cancelLoad();
+
+					continue;
+				}
+			}
 			else if (gameState == STATE_MAINMENU)
 			{
 				if (event.type == sf::Event::MouseMoved)
@@ -449,6 +487,9 @@ int main()
 				// TODO autosave if campaign loaded
 				Log::d(STR_SHUTTING_DOWN);
 
+				// the load thread could still be logging
+				campaign.stopLoad();
+
 				Log::close();
 				window.close();
 				return 0;
@@ -456,7 +497,8 @@ int main()
 
 			if (event.type == sf::Event::Resized)
 			{
-				windowSizeChanged(window.getSize(), fpsMeter, hudView, gameWorldView, pipBuck, mainMenu, console);
+				windowSizeChanged(window.getSize(), fpsMeter, hudView, gameWorldView, pipBuck, mainMenu, console,
+								  resManager, campaign);
 			}
 		}
 
@@ -471,8 +513,24 @@ int main()
 			campaign.tick(frameDuration.asMicroseconds());
 		else if (gameState == STATE_PIPBUCK)
 			pipBuck.tick();
+		else if (gameState == STATE_MAINMENU)
+			mainMenu.tick();
+		else if (gameState == STATE_LOADING)
+			campaign.handleLoadFinished(); // can change game state
+
+		if (SettingsManager::debugHotReloadRooms && (gameState == STATE_PLAYING || gameState == STATE_PIPBUCK))
+			campaign.hotReloadRooms();
+
+		// Campaign can't be touched while loading, textures will be reloaded after that
+		if (SettingsManager::debugHotReloadTextures && gameState != STATE_LOADING)
+		{
+			std::unordered_set<const sf::Texture*> reloadedTextures = resManager.reloadChangedTextures();
+			if (!reloadedTextures.empty())
+				campaign.redrawIfUsesTexture(reloadedTextures);
+		}
 
 		Log::tick();
+		resManager.uploadPendingTextures();
 
 		if (SettingsManager::showFpsCounter)
 			fpsMeter.tick();
@@ -504,6 +562,11 @@ int main()
 			window.draw(pipBuck);
 		else if (gameState == STATE_MAINMENU)
 			window.draw(mainMenu);
+		else if (gameState == STATE_LOADING)
+		{
+			loadingScreen.update(window.getSize());
+			window.draw(loadingScreen);
+		}
 
 		if (console.getIsOpen())
 			window.draw(console);
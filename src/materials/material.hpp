@@ -4,11 +4,11 @@
 
 #pragma once
 
-#include <string>
-
 #include <SFML/Graphics/Color.hpp>
 #include <SFML/System/Vector2.hpp>
 
+#include "../resources/asset_interner.hpp"
+
 enum MaterialType
 {
 	MAT_SOLID = 1,
@@ -22,9 +22,9 @@ enum MaterialType
 struct material
 {
 		enum MaterialType type;
-		std::string texturePath;
-		std::string textureDelimPath;
-		std::string maskTexturePath;
+		asset_id texture; // interned texture paths, see AssetInterner
+		asset_id textureDelim;
+		asset_id maskTexture;
 		bool isRight; // stairs, ladders
 		int offsetLeft; // can be negative
 		sf::Vector2i delimOffset;
@@ -90,8 +90,10 @@ bool MaterialManager::loadMap(const nlohmann::json& root, std::unordered_map<cha
 		color.loadFromColorString(colorString);
 		color.a = LIQUID_OPACITY;
 
-		theMap.emplace(matSymbol, material { matType, texturePath, textureDelimPath, maskTexturePath, matIsRight,
-											 offsetLeft, delimOffset, color });
+		// texture paths are interned, so that Rooms can get textures without hashing strings
+		theMap.emplace(matSymbol,
+					   material { matType, AssetInterner::intern(texturePath), AssetInterner::intern(textureDelimPath),
+								  AssetInterner::intern(maskTexturePath), matIsRight, offsetLeft, delimOffset, color });
 	}
 
 	return true;
@@ -5,9 +5,8 @@
 #include "back_hole_obj.hpp"
 
 #include "../util/json.hpp"
-#include "../util/random.hpp"
 
-bool BackHoleObject::loadFromJson(const nlohmann::json& jsonNode)
+bool BackHoleObject::loadFromJson(const nlohmann::json& jsonNode, const std::string& id)
 {
 	parseJsonKey<uint>(jsonNode, PATH_OBJS, FOERR_JSON_KEY_MAIN_CNT, this->variantsCnt);
 
@@ -20,27 +19,32 @@ bool BackHoleObject::loadFromJson(const nlohmann::json& jsonNode)
 
 	// note: hole objects don't support alpha attribute
 
+	for (uint i = 0; i < this->variantsCnt; i++)
+	{
+		this->mainTextures.push_back(BackObjectBase::getVariantPathId(id, i, TXT_MAIN_SUFFIX));
+		this->holeTextures.push_back(BackObjectBase::getVariantPathId(id, i, TXT_HOLE_SUFFIX));
+	}
+
 	// the only condition for the object being valid is that there's at least one variant
 	return this->variantsCnt > 0;
 }
 
 bool BackHoleObject::setupBgSprites(SpriteResource& mainSpriteRes, SpriteResource& holeSpriteRes, bool& blend,
-									ResourceManager& resMgr, const struct back_obj_data& backObjData) const
+									ResourceManager& resMgr, const struct back_obj_data& backObjData,
+									uint variantRoll) const
 {
 	int selectedVariant = backObjData.variantIdx;
 
 	if (selectedVariant < 0)
-		selectedVariant = Randomizer::getRandomBetween(0, this->variantsCnt - 1);
+		selectedVariant = static_cast<int>(variantRoll % this->variantsCnt);
 	else if (selectedVariant >= this->variantsCnt)
 		return false;
 
-	mainSpriteRes.setTexture(resMgr.getTexture(litSprintf("%s/%s_%d%s", PATH_TEXT_OBJS_BACK.c_str(),
-														  backObjData.id.c_str(), selectedVariant, TXT_MAIN_SUFFIX)));
+	mainSpriteRes.setTexture(resMgr.getTexture(this->mainTextures[selectedVariant]));
 	mainSpriteRes.setPosition(this->offset);
 	mainSpriteRes.setColor(BACK_OBJ_COLOR);
 
-	holeSpriteRes.setTexture(resMgr.getTexture(litSprintf("%s/%s_%d%s", PATH_TEXT_OBJS_BACK.c_str(),
-														  backObjData.id.c_str(), selectedVariant, TXT_HOLE_SUFFIX)));
+	holeSpriteRes.setTexture(resMgr.getTexture(this->holeTextures[selectedVariant]));
 	holeSpriteRes.setPosition(this->offset);
 
 	blend = this->blend;
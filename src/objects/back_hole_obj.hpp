@@ -5,6 +5,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 #include <nlohmann/json.hpp>
 
@@ -31,9 +32,11 @@ class BackHoleObject : public BackObjectBase
 		// blood2), but it doesn't seem to make sense, so let's ignore it for now and only have a flag for overlay
 		// blending mode here
 		bool blend = false;
+		std::vector<asset_id> mainTextures;
+		std::vector<asset_id> holeTextures;
 
 	public:
-		bool loadFromJson(const nlohmann::json& jsonNode);
+		bool loadFromJson(const nlohmann::json& jsonNode, const std::string& id) override;
 		bool setupBgSprites(SpriteResource& mainSpriteRes, SpriteResource& holeSpriteRes, bool& blend,
-							ResourceManager& resMgr, const struct back_obj_data& backObjData) const;
+							ResourceManager& resMgr, const struct back_obj_data& backObjData, uint variantRoll) const;
 };
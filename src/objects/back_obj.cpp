@@ -7,9 +7,8 @@
 #include <algorithm>
 
 #include "../util/json.hpp"
-#include "../util/random.hpp"
 
-bool BackObject::loadFromJson(const nlohmann::json& jsonNode)
+bool BackObject::loadFromJson(const nlohmann::json& jsonNode, const std::string& id)
 {
 	// each can be undefined, in which case we assume 0
 	parseJsonKey<uint>(jsonNode, PATH_OBJS, FOERR_JSON_KEY_MAIN_CNT, this->mainCnt, true);
@@ -25,6 +24,16 @@ bool BackObject::loadFromJson(const nlohmann::json& jsonNode)
 
 	this->variantsCnt = std::max(this->mainCnt, this->lightCnt);
 
+	for (uint i = 0; i < this->mainCnt; i++)
+	{
+		this->mainTextures.push_back(BackObjectBase::getVariantPathId(id, i, TXT_MAIN_SUFFIX));
+	}
+
+	for (uint i = 0; i < this->lightCnt; i++)
+	{
+		this->lightTextures.push_back(BackObjectBase::getVariantPathId(id, i, TXT_LIGHT_SUFFIX));
+	}
+
 	// the only condition for the object being valid is that at least one of the types defines at least one variant
 	return this->variantsCnt > 0;
 }
@@ -32,7 +41,6 @@ bool BackObject::loadFromJson(const nlohmann::json& jsonNode)
 /**
  * @brief Sets up back object sprites with a variant of textures
  *
- * backObjData.id should not contain extension and variant index
  * backObjData.variantIdx is zero-based, use negative to randomize variant
  *
  * @param mainSpriteRes reference to a sprite resource to use as main texture
@@ -44,7 +52,8 @@ bool BackObject::loadFromJson(const nlohmann::json& jsonNode)
  * @return false if no types provided texture for requested variant
  */
 bool BackObject::setupBgSprites(SpriteResource& mainSpriteRes, SpriteResource& lightSpriteRes, ResourceManager& resMgr,
-								const struct back_obj_data& backObjData, enum LightObjectsState lightState) const
+								const struct back_obj_data& backObjData, enum LightObjectsState lightState,
+								uint variantRoll) const
 {
 	int selectedVariant = backObjData.variantIdx;
 
@@ -67,16 +76,14 @@ bool BackObject::setupBgSprites(SpriteResource& mainSpriteRes, SpriteResource& l
 			// should always be displayed.
 			selectedVariant = this->lightCnt;
 		else if (selectedVariant < 0)
-			selectedVariant = Randomizer::getRandomBetween(0, this->variantsCnt - 1);
+			selectedVariant = static_cast<int>(variantRoll % this->variantsCnt);
 	}
 
 	bool gotOne = false;
 
 	if (selectedVariant < this->mainCnt)
 	{
-		mainSpriteRes.setTexture(
-			resMgr.getTexture(litSprintf("%s/%s_%d%s", PATH_TEXT_OBJS_BACK.c_str(), backObjData.id.c_str(),
-										 selectedVariant, TXT_MAIN_SUFFIX)));
+		mainSpriteRes.setTexture(resMgr.getTexture(this->mainTextures[selectedVariant]));
 		mainSpriteRes.setPosition(this->offset);
 
 		// objects which are light sources are not dimmed
@@ -90,9 +97,7 @@ bool BackObject::setupBgSprites(SpriteResource& mainSpriteRes, SpriteResource& l
 
 	if (selectedVariant < this->lightCnt)
 	{
-		lightSpriteRes.setTexture(
-			resMgr.getTexture(litSprintf("%s/%s_%d%s", PATH_TEXT_OBJS_BACK.c_str(), backObjData.id.c_str(),
-										 selectedVariant, TXT_LIGHT_SUFFIX)));
+		lightSpriteRes.setTexture(resMgr.getTexture(this->lightTextures[selectedVariant]));
 		lightSpriteRes.setPosition(this->offsetLight);
 
 		// note: light texture is not dimmed like main texture
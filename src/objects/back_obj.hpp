@@ -5,6 +5,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 #include <nlohmann/json.hpp>
 
@@ -41,9 +42,12 @@ class BackObject : public BackObjectBase
 		uint mainCnt = 0;
 		uint lightCnt = 0;
 		uchar alphaChannel = COLOR_MAX_CHANNEL_VALUE;
+		std::vector<asset_id> mainTextures;
+		std::vector<asset_id> lightTextures;
 
 	public:
-		bool loadFromJson(const nlohmann::json& jsonNode) override;
+		bool loadFromJson(const nlohmann::json& jsonNode, const std::string& id) override;
 		bool setupBgSprites(SpriteResource& mainSpriteRes, SpriteResource& lightSpriteRes, ResourceManager& resMgr,
-							const struct back_obj_data& backObjData, enum LightObjectsState lightState) const;
+							const struct back_obj_data& backObjData, enum LightObjectsState lightState,
+							uint variantRoll) const;
 };
@@ -4,9 +4,13 @@
 
 #pragma once
 
+#include <string>
+
 #include <SFML/System/Vector2.hpp>
 #include <nlohmann/json.hpp>
 
+#include "../consts.hpp"
+#include "../resources/asset_interner.hpp"
 #include "../util/util.hpp"
 
 // TODO find out the exact shade
@@ -22,9 +26,10 @@
  * behind them (depends in which collection in Room it is defined - "back_objs" or "far_back_objs"). Holes are handled
  * separately ("back_holes").
  *
- * The object does not store paths of textures; instead, because of the strict naming convention, it derives filenames
- * from object id (stored in BackObjectsManager as map key and passed to ::setupBgSprites()), texture variant, and type
- * (main/hole/light).
+ * Because of the strict naming convention, paths of textures don't need to be defined - they are derived from object id
+ * (stored in ObjectManager as map key), texture variant, and type (main/hole/light). Paths of all variants are derived
+ * and interned once, when the object is loaded (see ::getVariantPathId()), so setting up sprites doesn't need to build
+ * any strings.
  *
  * A "variant" is an alternative texture for a given object. For example object "door" could have 4 textures, each
  * one a slightly different door. By displaying one of N variants for each object in a given Room, the environment gains
@@ -55,6 +60,18 @@ class BackObjectBase
 		sf::Vector2f offset { 0.F, 0.F };
 		uint variantsCnt = 0;
 
+		/**
+		 * @param id object id
+		 * @param variantIdx zero-based variant index
+		 * @param suffix texture type suffix (e.g. TXT_MAIN_SUFFIX)
+		 * @return interned path of the texture
+		 */
+		static asset_id getVariantPathId(const std::string& id, uint variantIdx, const char* suffix)
+		{
+			return AssetInterner::intern(
+				litSprintf("%s/%s_%d%s", PATH_TEXT_OBJS_BACK.c_str(), id.c_str(), variantIdx, suffix));
+		}
+
 	public:
-		virtual bool loadFromJson(const nlohmann::json& jsonNode) = 0;
+		virtual bool loadFromJson(const nlohmann::json& jsonNode, const std::string& id) = 0;
 };
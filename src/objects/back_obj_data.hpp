@@ -4,14 +4,14 @@
 
 #pragma once
 
-#include <string>
-
 #include <SFML/System/Vector2.hpp>
 
+#include "../resources/asset_interner.hpp"
+
 // representation of back object json node
 struct back_obj_data
 {
-		std::string id;
+		asset_id id; // interned object id
 		sf::Vector2u coordinates;
 		int variantIdx;
 };
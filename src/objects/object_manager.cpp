@@ -28,8 +28,9 @@ bool ObjectManager::load()
 
 	for (const auto& objNode : bgObjsSearch->items())
 	{
-		this->objects.emplace(objNode.key(), BackObject());
-		if (!this->objects.at(objNode.key()).loadFromJson(objNode.value()))
+		const asset_id objId = AssetInterner::intern(objNode.key());
+		this->objects.emplace(objId, BackObject());
+		if (!this->objects.at(objId).loadFromJson(objNode.value(), objNode.key()))
 		{
 			this->objects.clear();
 			return false;
@@ -51,8 +52,9 @@ bool ObjectManager::load()
 
 	for (const auto& objNode : bgHoleObjsSearch->items())
 	{
-		this->holeObjects.emplace(objNode.key(), BackHoleObject());
-		if (!this->holeObjects.at(objNode.key()).loadFromJson(objNode.value()))
+		const asset_id objId = AssetInterner::intern(objNode.key());
+		this->holeObjects.emplace(objId, BackHoleObject());
+		if (!this->holeObjects.at(objId).loadFromJson(objNode.value(), objNode.key()))
 		{
 			this->holeObjects.clear();
 			this->objects.clear();
@@ -67,28 +69,29 @@ bool ObjectManager::load()
  * Sets up sprite resources for the specified object id and variant
  *
  * Object id should not contain file extension nor variant index.
- * Variant can be set to negative to use random one.
+ * Variant can be set to negative to pick one based on variantRoll.
  *
  * @param mainSpriteRes reference to a sprite resource to use as main texture
  * @param lightSpriteRes reference to a sprite resource to use as light
  * @param resMgr reference to Resource Manager
  * @param backObjData object data
  * @param lightState override light state (only valid for light object)
+ * @param variantRoll random number used to pick the variant, if it's not set in object data
  * @return true if setup was successful
  * @return false if setup has failed
  */
 bool ObjectManager::setupBgSprites(SpriteResource& mainSpriteRes, SpriteResource& lightSpriteRes,
 								   ResourceManager& resMgr, const struct back_obj_data& backObjData,
-								   enum LightObjectsState lightState) const
+								   enum LightObjectsState lightState, uint variantRoll) const
 {
 	auto search = this->objects.find(backObjData.id);
 	if (search == this->objects.end())
 	{
-		Log::e(STR_BACK_OBJ_SETUP_FAIL_DEF_MISSING, backObjData.id.c_str());
+		Log::e(STR_BACK_OBJ_SETUP_FAIL_DEF_MISSING, AssetInterner::getString(backObjData.id).c_str());
 		return false;
 	}
 
-	if (!search->second.setupBgSprites(mainSpriteRes, lightSpriteRes, resMgr, backObjData, lightState))
+	if (!search->second.setupBgSprites(mainSpriteRes, lightSpriteRes, resMgr, backObjData, lightState, variantRoll))
 		return false;
 
 	// note: move() instead of setPosition(), as objects were already moved according to offset
@@ -102,27 +105,29 @@ bool ObjectManager::setupBgSprites(SpriteResource& mainSpriteRes, SpriteResource
  * Sets up sprite resources for the specified hole object id and variant
  *
  * Object id should not contain file extension nor variant index.
- * Variant can be set to negative to use random one.
+ * Variant can be set to negative to pick one based on variantRoll.
  *
  * @param mainSpriteRes reference to a sprite resource to use as main texture
  * @param holeSpriteRes reference to a sprite resource to use as light
  * @param blend reference to blend variable
  * @param resMgr reference to Resource Manager
  * @param backObjData object data
+ * @param variantRoll random number used to pick the variant, if it's not set in object data
  * @return true if setup was successful
  * @return false if setup has failed
  */
 bool ObjectManager::setupBgHoleSprites(SpriteResource& mainSpriteRes, SpriteResource& holeSpriteRes, bool& blend,
-									   ResourceManager& resMgr, const struct back_obj_data& backObjData) const
+									   ResourceManager& resMgr, const struct back_obj_data& backObjData,
+									   uint variantRoll) const
 {
 	auto search = this->holeObjects.find(backObjData.id);
 	if (search == this->holeObjects.end())
 	{
-		Log::e(STR_BACK_OBJ_SETUP_FAIL_DEF_MISSING, backObjData.id.c_str());
+		Log::e(STR_BACK_OBJ_SETUP_FAIL_DEF_MISSING, AssetInterner::getString(backObjData.id).c_str());
 		return false;
 	}
 
-	if (!search->second.setupBgSprites(mainSpriteRes, holeSpriteRes, blend, resMgr, backObjData))
+	if (!search->second.setupBgSprites(mainSpriteRes, holeSpriteRes, blend, resMgr, backObjData, variantRoll))
 		return false;
 
 	// note: move() instead of setPosition(), as objects were already moved according to offset
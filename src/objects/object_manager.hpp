@@ -4,7 +4,6 @@
 
 #pragma once
 
-#include <string>
 #include <unordered_map>
 
 #include "back_hole_obj.hpp"
@@ -18,13 +17,16 @@
 class ObjectManager
 {
 	private:
-		std::unordered_map<std::string, BackObject> objects;
-		std::unordered_map<std::string, BackHoleObject> holeObjects;
+		// keyed by interned object id
+		std::unordered_map<asset_id, BackObject> objects;
+		std::unordered_map<asset_id, BackHoleObject> holeObjects;
 
 	public:
 		bool load();
 		bool setupBgSprites(SpriteResource& mainSpriteRes, SpriteResource& lightSpriteRes, ResourceManager& resMgr,
-							const struct back_obj_data& backObjData, enum LightObjectsState lightState) const;
+							const struct back_obj_data& backObjData, enum LightObjectsState lightState,
+							uint variantRoll) const;
 		bool setupBgHoleSprites(SpriteResource& mainSpriteRes, SpriteResource& holeSpriteRes, bool& blend,
-								ResourceManager& resMgr, const struct back_obj_data& backObjData) const;
+								ResourceManager& resMgr, const struct back_obj_data& backObjData,
+								uint variantRoll) const;
 };
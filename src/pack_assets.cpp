@@ -0,0 +1,114 @@
+// SPDX-License-Identifier: GPL-3.0-only
+//
+// (c) 2024 h67ma <szycikm@gmail.com>
+
+#include <cstdint>
+#include <cstdlib>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include "resources/asset_archive.hpp"
+#include "util/binary_stream.hpp"
+
+/**
+ * Resource packer.
+ *
+ * Packs all files of the resources dir into a single archive (see AssetArchive). Files are stored under the same paths
+ * which the game uses to load them (e.g. "res/materials.json"), i.e. relative to the parent of the resources dir.
+ *
+ * Usage: foerr-pack <resources dir> <output path>
+ *
+ * Exit code is 0 if the archive was written, 1 otherwise.
+ */
+int main(int argc, char* argv[])
+{
+	if (argc != 3)
+	{
+		std::cerr << "Usage: " << argv[0] << " <resources dir> <output path>" << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	const std::filesystem::path resDir = std::filesystem::path(argv[1]).lexically_normal();
+	const std::filesystem::path rootDir = resDir.parent_path();
+	const std::string outPath = argv[2];
+
+	// archive path, filesystem path. sorted, so that the archive is the same every time
+	std::vector<std::pair<std::string, std::filesystem::path>> files;
+	std::error_code err;
+	for (auto it = std::filesystem::recursive_directory_iterator(resDir, err);
+		 !err && it != std::filesystem::recursive_directory_iterator(); it.increment(err))
+	{
+		if (it->is_regular_file())
+			files.emplace_back(it->path().lexically_relative(rootDir).generic_string(), it->path());
+	}
+
+	if (err)
+	{
+		std::cerr << "Error listing " << resDir.string() << ": " << err.message() << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	std::sort(files.begin(), files.end());
+
+	// file data starts right after the file table
+	std::uint64_t offset = 3 * sizeof(std::uint32_t);
+	std::vector<std::uint64_t> sizes;
+	for (const auto& [archivePath, fsPath] : files)
+	{
+		offset += sizeof(std::uint32_t) + archivePath.length() + 2 * sizeof(std::uint64_t);
+		sizes.push_back(std::filesystem::file_size(fsPath, err));
+		if (err)
+		{
+			std::cerr << "Error reading " << fsPath.string() << ": " << err.message() << std::endl;
+			return EXIT_FAILURE;
+		}
+	}
+
+	BinaryWriter header;
+	header.write(ASSET_ARCHIVE_MAGIC);
+	header.write(ASSET_ARCHIVE_VERSION);
+	header.write(static_cast<std::uint32_t>(files.size()));
+	for (std::size_t i = 0; i < files.size(); i++)
+	{
+		header.writeString(files[i].first);
+		header.write(offset);
+		header.write(sizes[i]);
+		offset += sizes[i];
+	}
+
+	// file data is streamed, so that the whole archive doesn't need to fit in memory
+	std::ofstream writer(outPath, std::ios::binary);
+	writer.write(header.getBuffer().data(), static_cast<std::streamsize>(header.getBuffer().size()));
+	for (std::size_t i = 0; i < files.size(); i++)
+	{
+		// inserting an empty stream would fail the writer
+		if (sizes[i] == 0)
+			continue;
+
+		std::ifstream reader(files[i].second, std::ios::binary);
+		if (!reader.is_open())
+		{
+			std::cerr << "Error reading " << files[i].second.string() << std::endl;
+			return EXIT_FAILURE;
+		}
+
+		writer << reader.rdbuf();
+	}
+
+	writer.close();
+	if (!writer.good())
+	{
+		std::cerr << "Error writing " << outPath << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	std::cout << "Packed " << files.size() << " files into " << outPath << std::endl;
+	return EXIT_SUCCESS;
+}
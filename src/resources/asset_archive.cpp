@@ -0,0 +1,182 @@
+// SPDX-License-Identifier: GPL-3.0-only
+//
+// (c) 2024 h67ma <szycikm@gmail.com>
+
+#include "asset_archive.hpp"
+
+#include <filesystem>
+#include <system_error>
+
+#include "../hud/log.hpp"
+#include "../util/binary_stream.hpp"
+#include "../util/i18n.hpp"
+#include "../util/util.hpp"
+#include "asset_manifest.hpp"
+
+MappedFile AssetArchive::file;
+std::unordered_map<std::string, struct archive_entry> AssetArchive::entries;
+std::int64_t AssetArchive::archiveMtime = 0;
+
+/**
+ * Opens the archive and reads its file table. The archive stays mapped until ::close() is called.
+ *
+ * @param path path to the archive
+ * @return true if the archive was opened
+ * @return false if the archive is missing or corrupted. Loose files will be used then
+ */
+bool AssetArchive::open(const std::string& path)
+{
+	AssetArchive::close();
+
+	if (!AssetArchive::file.open(path))
+	{
+		Log::v(STR_ASSET_ARCHIVE_MISSING, path.c_str());
+		return false;
+	}
+
+	const std::size_t fileSize = AssetArchive::file.getSize();
+	BinaryReader reader(AssetArchive::file.getData(), fileSize);
+
+	std::uint32_t magic;
+	std::uint32_t version;
+	std::uint32_t fileCnt;
+	if (!reader.read(magic) || !reader.read(version) || magic != ASSET_ARCHIVE_MAGIC ||
+		version != ASSET_ARCHIVE_VERSION || !reader.read(fileCnt))
+	{
+		Log::w(STR_ASSET_ARCHIVE_CORRUPT, path.c_str());
+		AssetArchive::close();
+		return false;
+	}
+
+	for (std::uint32_t i = 0; i < fileCnt; i++)
+	{
+		std::string filePath;
+		struct archive_entry entry;
+		if (!reader.readString(filePath) || !reader.read(entry.offset) || !reader.read(entry.size) ||
+			entry.offset > fileSize || entry.size > fileSize - entry.offset)
+		{
+			Log::w(STR_ASSET_ARCHIVE_CORRUPT, path.c_str());
+			AssetArchive::close();
+			return false;
+		}
+
+		AssetArchive::entries.emplace(filePath, entry);
+	}
+
+	std::error_code err;
+	AssetArchive::archiveMtime = std::filesystem::last_write_time(path, err).time_since_epoch().count();
+
+	Log::d(STR_ASSET_ARCHIVE_OPENED, path.c_str(), AssetArchive::entries.size());
+	return true;
+}
+
+void AssetArchive::close()
+{
+	AssetArchive::entries.clear();
+	AssetArchive::file.close();
+	AssetArchive::archiveMtime = 0;
+}
+
+/**
+ * @return true if the file is in the archive (regardless of whether it's overridden by a loose file)
+ */
+bool AssetArchive::contains(const std::string& path)
+{
+	return AssetArchive::entries.find(path) != AssetArchive::entries.end();
+}
+
+/**
+ * Finds a file in the archive. Only returns archived files which are not overridden by a loose file.
+ *
+ * Can be called from multiple threads at the same time.
+ *
+ * @param path path of the file
+ * @param data pointer to file data will be stored here. It stays valid until the archive is closed
+ * @param size size of file data will be stored here
+ * @return true if the file should be read from the archive
+ * @return false if the file should be read from disk (or doesn't exist at all)
+ */
+bool AssetArchive::getFile(const std::string& path, const char*& data, std::size_t& size)
+{
+	if (AssetArchive::entries.empty())
+		return false;
+
+	auto search = AssetArchive::entries.find(path);
+	if (search == AssetArchive::entries.end())
+		return false;
+
+	if (AssetManifest::isLoose(path))
+		return false; // loose file overrides the archived one
+
+	data = AssetArchive::file.getData() + search->second.offset;
+	size = search->second.size;
+	return true;
+}
+
+/**
+ * Same as ::hashFile() from util, but also works for archived files.
+ */
+bool AssetArchive::hashFile(const std::string& path, std::uint64_t& hash, std::uint64_t seed)
+{
+	const char* data;
+	std::size_t size;
+	if (!AssetArchive::getFile(path, data, size))
+		return ::hashFile(path, hash, seed);
+
+	hash = hashBytes(data, size, seed);
+	return true;
+}
+
+/**
+ * Gets size and modification time of a file, which together can be used to cheaply check if the file has changed.
+ * Archived files get the modification time of the whole archive.
+ *
+ * @param path path of the file
+ * @param size file size will be stored here
+ * @param mtime file modification time will be stored here (in unspecified units)
+ * @return true if the file exists
+ * @return false if the file doesn't exist, neither loose nor archived
+ */
+bool AssetArchive::getFileStamp(const std::string& path, std::uint64_t& size, std::int64_t& mtime)
+{
+	if (AssetManifest::isLoose(path))
+	{
+		std::error_code err;
+		size = std::filesystem::file_size(path, err);
+		if (err)
+			return false;
+
+		mtime = std::filesystem::last_write_time(path, err).time_since_epoch().count();
+		return !err;
+	}
+
+	auto search = AssetArchive::entries.find(path);
+	if (search == AssetArchive::entries.end())
+		return false;
+
+	size = search->second.size;
+	mtime = AssetArchive::archiveMtime;
+	return true;
+}
+
+/**
+ * Adds names of all archived directories directly inside a directory to a set. Loose directories are not included.
+ *
+ * @param dirPath path of the parent directory, without trailing delimiter
+ * @param names set to add directory names to
+ */
+void AssetArchive::addSubdirNames(const std::string& dirPath, std::set<std::string>& names)
+{
+	const std::string prefix = dirPath + PATH_DELIM;
+
+	for (const auto& entry : AssetArchive::entries)
+	{
+		if (entry.first.compare(0, prefix.size(), prefix) != 0)
+			continue;
+
+		// only files inside a subdirectory count
+		std::size_t delimPos = entry.first.find(PATH_DELIM, prefix.size());
+		if (delimPos != std::string::npos)
+			names.insert(entry.first.substr(prefix.size(), delimPos - prefix.size()));
+	}
+}
@@ -0,0 +1,58 @@
+// SPDX-License-Identifier: GPL-3.0-only
+//
+// (c) 2024 h67ma <szycikm@gmail.com>
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <set>
+#include <string>
+#include <unordered_map>
+
+#include "../util/mapped_file.hpp"
+
+// archives with a different magic or version are ignored
+constexpr std::uint32_t ASSET_ARCHIVE_MAGIC = 0x4B414F46; // "FOAK"
+constexpr std::uint32_t ASSET_ARCHIVE_VERSION = 1;
+
+// location of a single file inside the archive
+struct archive_entry
+{
+		std::uint64_t offset;
+		std::uint64_t size;
+};
+
+/**
+ * AssetArchive provides access to game resources packed into a single file (see pack_assets.cpp), to avoid
+ * opening hundreds of separate files when the game starts or loads a Location. The archive is memory-mapped, so files
+ * can be decoded straight from the mapping, without any copying.
+ *
+ * Files are identified by the same paths which are used for loose files (e.g. "res/materials.json"). A loose file
+ * always takes precedence over an archived file with the same path, so resources can still be modified (modded)
+ * without rebuilding the archive.
+ *
+ * Archive structure (native byte order):
+ *   - magic (ASSET_ARCHIVE_MAGIC) and version (ASSET_ARCHIVE_VERSION)
+ *   - file count, followed by file table: path, offset and size of file data (relative to start of archive)
+ *   - file data
+ *
+ * The archive is optional - if it's missing, only loose files are used.
+ */
+class AssetArchive
+{
+	private:
+		static MappedFile file;
+		static std::unordered_map<std::string, struct archive_entry> entries;
+		static std::int64_t archiveMtime;
+
+	public:
+		static bool open(const std::string& path);
+		static void close();
+		static bool contains(const std::string& path);
+		static bool getFile(const std::string& path, const char*& data, std::size_t& size);
+		static bool hashFile(const std::string& path, std::uint64_t& hash, std::uint64_t seed);
+		static bool getFileStamp(const std::string& path, std::uint64_t& size, std::int64_t& mtime);
+		static void addSubdirNames(const std::string& dirPath, std::set<std::string>& names);
+};
@@ -0,0 +1,44 @@
+// SPDX-License-Identifier: GPL-3.0-only
+//
+// (c) 2024 h67ma <szycikm@gmail.com>
+
+#include "asset_interner.hpp"
+
+#include <mutex>
+
+std::shared_mutex AssetInterner::mutex;
+std::unordered_map<std::string, asset_id> AssetInterner::ids { { "", ASSET_ID_NONE } };
+std::deque<std::string> AssetInterner::strings { "" };
+
+/**
+ * @param str string to intern
+ * @return id of the string. Interning the same string again always returns the same id
+ */
+asset_id AssetInterner::intern(const std::string& str)
+{
+	{
+		const std::shared_lock<std::shared_mutex> lock(AssetInterner::mutex);
+		auto search = AssetInterner::ids.find(str);
+		if (search != AssetInterner::ids.end())
+			return search->second;
+	}
+
+	const std::lock_guard<std::shared_mutex> lock(AssetInterner::mutex);
+
+	// another thread could have interned the same string in the meantime, in which case nothing is inserted
+	auto inserted = AssetInterner::ids.emplace(str, static_cast<asset_id>(AssetInterner::strings.size()));
+	if (inserted.second)
+		AssetInterner::strings.push_back(str);
+
+	return inserted.first->second;
+}
+
+/**
+ * @param id id returned by ::intern()
+ * @return the interned string. The reference stays valid until the program exits
+ */
+const std::string& AssetInterner::getString(asset_id id)
+{
+	const std::shared_lock<std::shared_mutex> lock(AssetInterner::mutex);
+	return AssetInterner::strings.at(id);
+}
@@ -0,0 +1,40 @@
+// SPDX-License-Identifier: GPL-3.0-only
+//
+// (c) 2024 h67ma <szycikm@gmail.com>
+
+#pragma once
+
+#include <cstdint>
+
+#include <deque>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
+typedef std::uint32_t asset_id;
+
+// id of an empty string, can be used to mark a missing asset (e.g. material without a mask texture)
+constexpr asset_id ASSET_ID_NONE = 0;
+
+/**
+ * AssetInterner assigns compact integer ids to strings identifying assets (resource paths, object ids). Strings are
+ * interned once, when data is loaded, and from then on assets can be identified (and looked up in maps) by their id,
+ * without allocating or hashing any strings.
+ *
+ * Ids are only valid while the game is running, so they should never be saved anywhere - save the string instead.
+ *
+ * Interned strings are never removed, which is fine, as the number of assets is limited.
+ *
+ * Can be used from multiple threads at the same time.
+ */
+class AssetInterner
+{
+	private:
+		static std::shared_mutex mutex;
+		static std::unordered_map<std::string, asset_id> ids;
+		static std::deque<std::string> strings; // deque, so that references to elements stay valid when adding more
+
+	public:
+		static asset_id intern(const std::string& str);
+		static const std::string& getString(asset_id id);
+};
@@ -0,0 +1,68 @@
+// SPDX-License-Identifier: GPL-3.0-only
+//
+// (c) 2024 h67ma <szycikm@gmail.com>
+
+#include "asset_manifest.hpp"
+
+#include <filesystem>
+#include <system_error>
+
+#include "../hud/log.hpp"
+#include "../util/i18n.hpp"
+#include "asset_archive.hpp"
+
+std::unordered_set<std::string> AssetManifest::looseFiles;
+bool AssetManifest::built = false;
+
+/**
+ * Scans a directory (recursively) and stores paths of all files inside it. Should be called once at startup, before
+ * any resources are loaded.
+ *
+ * Paths are stored in the same form as they are used for loading resources (e.g. "res/materials.json").
+ *
+ * @param dirPath path of the resources directory
+ */
+void AssetManifest::build(const std::string& dirPath)
+{
+	AssetManifest::looseFiles.clear();
+
+	std::error_code err;
+	for (auto it = std::filesystem::recursive_directory_iterator(dirPath, err);
+		 !err && it != std::filesystem::recursive_directory_iterator(); it.increment(err))
+	{
+		std::error_code fileErr;
+		if (it->is_regular_file(fileErr))
+			AssetManifest::looseFiles.insert(it->path().generic_string());
+	}
+
+	// even if the dir is missing, the manifest is still valid (everything will be read from the archive then)
+	AssetManifest::built = true;
+
+	Log::d(STR_ASSET_MANIFEST_BUILT, AssetManifest::looseFiles.size(), dirPath.c_str());
+}
+
+/**
+ * Can be called from multiple threads at the same time.
+ *
+ * @return true if the file exists as a loose file (i.e. not only in the archive)
+ */
+bool AssetManifest::isLoose(const std::string& path)
+{
+	if (!AssetManifest::built)
+	{
+		std::error_code err;
+		return std::filesystem::exists(path, err);
+	}
+
+	return AssetManifest::looseFiles.find(path) != AssetManifest::looseFiles.end();
+}
+
+/**
+ * Can be called from multiple threads at the same time.
+ *
+ * @return true if the file exists, either as a loose file, or in the archive
+ */
+bool AssetManifest::exists(const std::string& path)
+{
+	return AssetManifest::isLoose(path) || AssetArchive::contains(path);
+}
@@ -0,0 +1,30 @@
+// SPDX-License-Identifier: GPL-3.0-only
+//
+// (c) 2024 h67ma <szycikm@gmail.com>
+
+#pragma once
+
+#include <string>
+#include <unordered_set>
+
+/**
+ * AssetManifest is a list of all loose resource files, built once at startup by scanning the resources dir. It allows
+ * checking if a resource exists without asking the filesystem, which is important as resources are looked up
+ * thousands of times when loading a Location (and most of the lookups are for missing textures, which would need a
+ * filesystem probe every time).
+ *
+ * Files added after the manifest was built are not visible, unless they are archived (see AssetArchive).
+ *
+ * If the manifest was not built, all lookups fall back to the filesystem.
+ */
+class AssetManifest
+{
+	private:
+		static std::unordered_set<std::string> looseFiles;
+		static bool built;
+
+	public:
+		static void build(const std::string& dirPath);
+		static bool isLoose(const std::string& path);
+		static bool exists(const std::string& path);
+};
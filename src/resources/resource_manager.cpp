@@ -4,12 +4,20 @@
 
 #include "resource_manager.hpp"
 
-#include <filesystem>
+#include <algorithm>
 #include <string>
+#include <utility>
+
+#include <SFML/Graphics/Image.hpp>
 
 #include "../consts.hpp"
 #include "../hud/log.hpp"
+#include "../settings/settings_manager.hpp"
 #include "../util/i18n.hpp"
+#include "../util/parallel.hpp"
+#include "asset_archive.hpp"
+#include "asset_manifest.hpp"
+#include "texture_cache.hpp"
 
 // order matters!
 const std::array<std::string, 3> FONTS = {
@@ -34,6 +42,43 @@ const std::array<std::string, 3> AUDIO_CORE = {
 	PATH_AUD_PIPBUCK_PAGE_CLICK,
 };
 
+// uploading takes a while, so don't do too many at once, to avoid stutter
+constexpr std::size_t MAX_TEXTURE_UPLOADS_PER_FRAME = 16;
+
+// downscaled texture variants are identified by source path followed by this and the downscale factor
+const std::string TEXTURE_DOWNSCALE_DELIM = "@";
+constexpr uint MAX_TEXTURE_DOWNSCALE = 8;
+
+ResourceManager::ResourceManager(bool headless) : headless(headless), mainThreadId(std::this_thread::get_id())
+{
+	if (headless)
+	{
+		// core resources aren't loaded in headless mode
+		this->notFoundTexture = std::make_shared<sf::Texture>();
+		return;
+	}
+
+	for (std::size_t i = 0; i < getParallelThreadCnt(); i++)
+	{
+		this->decodeThreads.emplace_back(&ResourceManager::decodeWork, this);
+	}
+}
+
+ResourceManager::~ResourceManager()
+{
+	{
+		const std::lock_guard<std::mutex> lock(this->texturesMutex);
+		this->stopDecoding = true;
+	}
+
+	this->decodeCond.notify_all();
+
+	for (auto& thread : this->decodeThreads)
+	{
+		thread.join();
+	}
+}
+
 /**
  * Loads fonts.
  * If the loading fails, then the program must be exited.
@@ -64,10 +109,20 @@ bool ResourceManager::loadCore()
 {
 	Log::d(STR_LOADING_CORE_RES);
 
+	// request all first, so that they are decoded in parallel
+	std::vector<TextureHandle> coreTextures;
 	for (const auto& txt : TEXTURES_CORE)
 	{
-		if (!this->getTexture(txt))
+		coreTextures.push_back(this->requestTexture(txt));
+	}
+
+	for (std::size_t i = 0; i < coreTextures.size(); i++)
+	{
+		if (this->waitForTexture(AssetInterner::intern(TEXTURES_CORE[i]), coreTextures[i]) == nullptr)
+		{
+			Log::e(STR_LOAD_FAIL, TEXTURES_CORE[i].c_str());
 			return false;
+		}
 	}
 
 	for (const auto& buf : AUDIO_CORE)
@@ -88,50 +143,479 @@ bool ResourceManager::loadCore()
 	return true;
 }
 
+/**
+ * Requests a texture to be loaded in the background, without waiting for it. If the texture is already loaded or
+ * being loaded, no new load is started.
+ *
+ * The image is decoded by one of the decoding threads, and then uploaded on the main thread via
+ * ::uploadPendingTextures(). Waiting for the handle speeds this up by doing the remaining work on the waiting thread
+ * (except uploading, which is only done on the main thread, see TextureHandle::get()).
+ *
+ * Can be called from multiple threads at the same time.
+ *
+ * @param pathId interned image resource path
+ * @return handle to the texture
+ */
+TextureHandle ResourceManager::requestTexture(asset_id pathId)
+{
+	const std::lock_guard<std::mutex> lock(this->texturesMutex);
+
+	auto search = this->textures.find(pathId);
+	if (search != this->textures.end())
+		return TextureHandle(search->second); // resource already loaded
+
+	auto pendingSearch = this->pendingTextures.find(pathId);
+	if (pendingSearch != this->pendingTextures.end())
+		return TextureHandle(pendingSearch->second); // resource already being loaded
+
+	if (this->headless)
+	{
+		// nothing will be drawn, so the image doesn't need to be loaded
+		std::shared_ptr<sf::Texture> txt = std::make_shared<sf::Texture>();
+		this->textures.emplace(pathId, txt);
+		return TextureHandle(txt);
+	}
+
+	std::shared_ptr<struct texture_load> load = std::make_shared<struct texture_load>();
+	load->path = AssetInterner::getString(pathId);
+	load->texture = std::make_shared<sf::Texture>();
+
+	this->pendingTextures.emplace(pathId, load);
+	this->decodeQueue.push_back(load);
+	this->decodeCond.notify_one();
+
+	return TextureHandle(load);
+}
+
+TextureHandle ResourceManager::requestTexture(const std::string& path)
+{
+	return this->requestTexture(AssetInterner::intern(path));
+}
+
+/**
+ * Uploads textures which were decoded in the background to the GPU, and makes them available via ::getTexture().
+ * Tiles of tiled textures are uploaded afterwards, if the upload limit wasn't reached yet. Should be called once per
+ * frame on the main thread. Failed loads are dropped, so they can be retried.
+ */
+void ResourceManager::uploadPendingTextures()
+{
+	std::vector<std::pair<asset_id, std::shared_ptr<struct texture_load>>> loads;
+	std::vector<std::shared_ptr<sf::Texture>> repeated;
+	{
+		const std::lock_guard<std::mutex> lock(this->texturesMutex);
+		loads.assign(this->pendingTextures.begin(), this->pendingTextures.end());
+		repeated.swap(this->pendingRepeatedTextures);
+	}
+
+	for (const auto& txt : repeated)
+	{
+		txt->setRepeated(true);
+	}
+
+	std::size_t uploadCnt = 0;
+	for (auto& [pathId, load] : loads)
+	{
+		if (uploadCnt >= MAX_TEXTURE_UPLOADS_PER_FRAME)
+			break;
+
+		// only waits if another thread is uploading the same texture right now
+		TextureHandle handle(load);
+		if (!handle.isReady())
+		{
+			if (!uploadTexture(*load))
+				continue; // still decoding
+
+			uploadCnt++;
+		}
+
+		this->waitForTexture(pathId, handle);
+	}
+
+	this->uploadPendingTiles(uploadCnt);
+}
+
+/**
+ * Uploads all textures requested so far, waiting for them to be decoded if needed. Unlike ::uploadPendingTextures(),
+ * there's no limit of uploads. Should be called on the main thread before drawing anything which was loaded on another
+ * thread (e.g. before baking a Room, see Location::bakeCurrentRoom()), so that it's not drawn with empty textures.
+ * Tiled textures are not affected, as they're meant to fill in over multiple frames anyway.
+ */
+void ResourceManager::finishPendingTextures()
+{
+	std::vector<std::pair<asset_id, std::shared_ptr<struct texture_load>>> loads;
+	std::vector<std::shared_ptr<sf::Texture>> repeated;
+	{
+		const std::lock_guard<std::mutex> lock(this->texturesMutex);
+		loads.assign(this->pendingTextures.begin(), this->pendingTextures.end());
+		repeated.swap(this->pendingRepeatedTextures);
+	}
+
+	for (const auto& [pathId, load] : loads)
+	{
+		this->waitForTexture(pathId, TextureHandle(load));
+	}
+
+	for (const auto& txt : repeated)
+	{
+		txt->setRepeated(true);
+	}
+}
+
+/**
+ * @return true if some textures were requested, but are not uploaded yet (see ::finishPendingTextures())
+ */
+bool ResourceManager::hasPendingTextures()
+{
+	const std::lock_guard<std::mutex> lock(this->texturesMutex);
+	return !this->pendingTextures.empty() || !this->pendingRepeatedTextures.empty();
+}
+
+/**
+ * Uploads tiles of decoded tiled textures (see ::getTiledTexture()), one tile per upload, until the upload limit for
+ * this frame is reached. Tiled textures are finished one after another, in the order they were requested.
+ *
+ * @param uploadCnt number of uploads already done in this frame, will be increased by the number of uploaded tiles
+ */
+void ResourceManager::uploadPendingTiles(std::size_t& uploadCnt)
+{
+	while (uploadCnt < MAX_TEXTURE_UPLOADS_PER_FRAME)
+	{
+		struct tiled_texture_load tiledLoad;
+		{
+			const std::lock_guard<std::mutex> lock(this->texturesMutex);
+			if (this->pendingTiledTextures.empty())
+				return;
+
+			tiledLoad = this->pendingTiledTextures.front();
+		}
+
+		enum TextureLoadState state;
+		{
+			const std::lock_guard<std::mutex> lock(tiledLoad.load->mutex);
+			state = tiledLoad.load->state;
+		}
+
+		if (state == TXT_LOAD_QUEUED || state == TXT_LOAD_DECODING)
+			return; // still decoding, next textures have to wait for their turn
+
+		std::shared_ptr<TiledTexture> tiled = tiledLoad.texture.lock();
+		if (tiled != nullptr && state == TXT_LOAD_DECODED)
+		{
+			// the image is not touched by decoding threads anymore
+			if (!tiled->isCreated())
+				tiled->create(tiledLoad.load->image.getSize(), tiledLoad.load->downscale);
+
+			while (uploadCnt < MAX_TEXTURE_UPLOADS_PER_FRAME && tiled->uploadNextTile(tiledLoad.load->image))
+			{
+				uploadCnt++;
+			}
+
+			if (!tiled->isUploaded())
+				return;
+
+			Log::v(STR_LOADED_FILE, AssetInterner::getString(tiledLoad.pathId).c_str());
+		}
+
+		const std::lock_guard<std::mutex> lock(this->texturesMutex);
+		if (tiled != nullptr && state == TXT_LOAD_FAILED)
+		{
+			// failed loads are dropped, so they can be retried
+			this->tiledTextures.erase(tiledLoad.pathId);
+			this->missingTextures.insert(AssetInterner::intern(tiledLoad.load->path));
+		}
+
+		this->pendingTiledTextures.pop_front();
+	}
+}
+
+/**
+ * Waits for a texture load to finish, and moves the texture from pending loads to loaded textures. On threads other
+ * than the main thread, this only waits for the image to be decoded, and the texture stays pending until it's uploaded
+ * on the main thread.
+ *
+ * @return the loaded texture, or nullptr if it could not be loaded
+ */
+std::shared_ptr<sf::Texture> ResourceManager::waitForTexture(asset_id pathId, const TextureHandle& handle)
+{
+	std::shared_ptr<sf::Texture> txt = handle.get(std::this_thread::get_id() == this->mainThreadId);
+
+	// empty until it's uploaded, see ::uploadPendingTextures()
+	if (txt != nullptr && !handle.isReady())
+		return txt;
+
+	const std::lock_guard<std::mutex> lock(this->texturesMutex);
+
+	this->pendingTextures.erase(pathId);
+	if (txt != nullptr && this->textures.emplace(pathId, txt).second)
+	{
+		const std::string& path = AssetInterner::getString(pathId);
+		Log::v(STR_LOADED_FILE, path.c_str());
+
+		// archived files can't be edited anyway
+		if (SettingsManager::debugHotReloadTextures && AssetManifest::isLoose(path))
+			this->textureWatcher.watch(path);
+	}
+
+	return txt;
+}
+
+void ResourceManager::decodeWork()
+{
+	while (true)
+	{
+		std::shared_ptr<struct texture_load> load;
+		{
+			std::unique_lock<std::mutex> lock(this->texturesMutex);
+			this->decodeCond.wait(lock, [this]() { return this->stopDecoding || !this->decodeQueue.empty(); });
+
+			if (this->stopDecoding)
+				return;
+
+			load = std::move(this->decodeQueue.front());
+			this->decodeQueue.pop_front();
+		}
+
+		// could have been already picked up by a thread waiting for the texture
+		decodeTexture(*load);
+	}
+}
+
 /**
  * Loads a texture from specified path into resource manager object.
  * Pointer to the loaded texture is returned. If the texture is already
  * loaded, duplicate loading does not occur.
  *
- * @param path image resource path
+ * This is a blocking wrapper for ::requestTexture(). Can be called from multiple threads at the same time. On threads
+ * other than the main thread, the returned texture might be empty until it's uploaded (see ::finishPendingTextures()).
+ *
+ * @param pathId interned image resource path
  * @param returnSomething if true, and requested texture is not found, a dummy texture will be returned instead of
  * nullptr
  * @returns shared pointer to the loaded texture resource (can be `nullptr` if loading fails and !returnSomething)
  */
-std::shared_ptr<sf::Texture> ResourceManager::getTexture(const std::string& path, bool returnSomething)
+std::shared_ptr<sf::Texture> ResourceManager::getTexture(asset_id pathId, bool returnSomething)
 {
-	auto search = this->textures.find(path);
-	if (search != this->textures.end())
-		return search->second; // resource already loaded
-
-	std::shared_ptr<sf::Texture> txt = std::make_shared<sf::Texture>();
-	if (!std::filesystem::exists(path) || !txt->loadFromFile(path))
 	{
-		if (returnSomething)
-		{
-			// do not output a warning as it would produce way too much spam. the problem will be clearly visible anyway
+		const std::lock_guard<std::mutex> lock(this->texturesMutex);
+
+		// fast path for textures which are already loaded, or are already known to be missing
+		auto search = this->textures.find(pathId);
+		if (search != this->textures.end())
+			return search->second;
+
+		if (returnSomething && (this->missingTextures.find(pathId) != this->missingTextures.end() ||
+								this->reportedMissingTextures.find(pathId) != this->reportedMissingTextures.end()))
 			return this->notFoundTexture;
-		}
-		else
-		{
-			Log::e(STR_LOAD_FAIL, path.c_str());
-			return nullptr;
-		}
 	}
 
-	txt->setSmooth(true);
+	const std::string& path = AssetInterner::getString(pathId);
 
-	Log::v(STR_LOADED_FILE, path.c_str());
+	// don't even start loading textures which don't exist
+	if (AssetManifest::exists(path))
+	{
+		std::shared_ptr<sf::Texture> txt = this->waitForTexture(pathId, this->requestTexture(pathId));
+		if (txt != nullptr)
+			return txt;
+	}
+
+	if (returnSomething)
+	{
+		// do not output a warning for each texture as it would produce way too much spam. missing textures are
+		// reported all at once instead (see ::reportMissingTextures())
+		const std::lock_guard<std::mutex> lock(this->texturesMutex);
+		this->missingTextures.insert(pathId);
+		return this->notFoundTexture;
+	}
+
+	Log::e(STR_LOAD_FAIL, path.c_str());
+	return nullptr;
+}
+
+std::shared_ptr<sf::Texture> ResourceManager::getTexture(const std::string& path, bool returnSomething)
+{
+	return this->getTexture(AssetInterner::intern(path), returnSomething);
+}
+
+/**
+ * Same as ::getTexture(), but additionally makes sure that the returned texture has repeating enabled. If the texture
+ * can't be loaded, the dummy texture is returned (which is always repeated).
+ *
+ * Can be called from multiple threads at the same time.
+ *
+ * @param pathId interned image resource path
+ * @returns shared pointer to the loaded texture resource
+ */
+std::shared_ptr<sf::Texture> ResourceManager::getRepeatedTexture(asset_id pathId)
+{
+	std::shared_ptr<sf::Texture> txt = this->getTexture(pathId);
+
+	// the same texture can be requested by multiple threads at the same time
+	const std::lock_guard<std::mutex> lock(this->texturesMutex);
+	if (std::this_thread::get_id() == this->mainThreadId)
+		txt->setRepeated(true);
+	else
+		this->pendingRepeatedTextures.push_back(txt);
 
-	this->textures[path] = txt;
 	return txt;
 }
 
+std::shared_ptr<sf::Texture> ResourceManager::getRepeatedTexture(const std::string& path)
+{
+	return this->getRepeatedTexture(AssetInterner::intern(path));
+}
+
+/**
+ * Requests a large texture (e.g. full background) to be loaded as a TiledTexture, downscaled by the specified factor.
+ * The image is decoded in the background, same as with ::requestTexture(), and then its tiles are uploaded a few at a
+ * time in ::uploadPendingTextures(), so that the upload doesn't stall a single frame. The returned texture is empty
+ * until then, and fills in tile by tile.
+ *
+ * Each downscale factor is a separate variant, so the full size image doesn't need to be uploaded at all. The texture
+ * is scaled up by the same factor when drawn, so it always covers the same area.
+ *
+ * If the texture can't be loaded, it will stay empty, and will be reported as missing (see ::reportMissingTextures()).
+ *
+ * Can be called from multiple threads at the same time.
+ *
+ * @param path image resource path
+ * @param downscale downscale factor, typically ::getWorldDownscale()
+ * @returns shared pointer to the tiled texture
+ */
+std::shared_ptr<TiledTexture> ResourceManager::getTiledTexture(const std::string& path, uint downscale)
+{
+	asset_id variantId = AssetInterner::intern(path + TEXTURE_DOWNSCALE_DELIM + std::to_string(downscale));
+
+	const std::lock_guard<std::mutex> lock(this->texturesMutex);
+
+	auto search = this->tiledTextures.find(variantId);
+	if (search != this->tiledTextures.end())
+		return search->second; // resource already loaded or being loaded
+
+	std::shared_ptr<TiledTexture> tiled = std::make_shared<TiledTexture>();
+	if (!AssetManifest::exists(path))
+	{
+		// not stored, so that it can be loaded once the file is there
+		this->missingTextures.insert(AssetInterner::intern(path));
+		return tiled;
+	}
+
+	this->tiledTextures.emplace(variantId, tiled);
+
+	// nothing will be drawn, so the image doesn't need to be loaded
+	if (this->headless)
+		return tiled;
+
+	std::shared_ptr<struct texture_load> load = std::make_shared<struct texture_load>();
+	load->path = path;
+	load->downscale = downscale;
+
+	this->pendingTiledTextures.push_back({ variantId, load, tiled });
+	this->decodeQueue.push_back(load);
+	this->decodeCond.notify_one();
+
+	return tiled;
+}
+
+/**
+ * Updates the downscale factor for textures drawn over the whole game world, so that one texel of a downscaled texture
+ * still covers at most one pixel of the game world viewport. Only power of two factors are used, so that the number of
+ * variants stays low.
+ *
+ * @param viewportSize size of game world viewport, in pixels
+ */
+void ResourceManager::setWorldViewportSize(sf::Vector2u viewportSize)
+{
+	if (viewportSize.x == 0 || viewportSize.y == 0)
+		return;
+
+	float ratio = std::min(GAME_AREA_WIDTH / static_cast<float>(viewportSize.x),
+						   GAME_AREA_HEIGHT / static_cast<float>(viewportSize.y));
+
+	uint downscale = 1;
+	while (downscale < MAX_TEXTURE_DOWNSCALE && static_cast<float>(downscale * 2) <= ratio)
+	{
+		downscale *= 2;
+	}
+
+	this->worldDownscale = downscale;
+}
+
+/**
+ * @return downscale factor for textures drawn over the whole game world, see ::setWorldViewportSize()
+ */
+uint ResourceManager::getWorldDownscale() const
+{
+	return this->worldDownscale;
+}
+
 std::shared_ptr<sf::Texture> ResourceManager::getNotFoundTexture() const
 {
 	return this->notFoundTexture;
 }
 
+/**
+ * Gets all textures which were replaced with the dummy texture since the last call, and marks them as reported (see
+ * ::reportMissingTextures()).
+ *
+ * Can be called from multiple threads at the same time.
+ *
+ * @return sorted paths of missing textures
+ */
+std::vector<std::string> ResourceManager::takeMissingTextures()
+{
+	std::vector<std::string> paths;
+	{
+		const std::lock_guard<std::mutex> lock(this->texturesMutex);
+		for (asset_id pathId : this->missingTextures)
+		{
+			if (this->reportedMissingTextures.insert(pathId).second)
+				paths.push_back(AssetInterner::getString(pathId));
+		}
+
+		this->missingTextures.clear();
+	}
+
+	std::sort(paths.begin(), paths.end());
+	return paths;
+}
+
+/**
+ * Logs a single summary of all textures which were replaced with the dummy texture since the last report. Textures
+ * are only reported once, until ::forgetMissingTextures() is called.
+ *
+ * Can be called from multiple threads at the same time.
+ *
+ * @param context what was being loaded (e.g. Location file path), just for printing
+ */
+void ResourceManager::reportMissingTextures(const std::string& context)
+{
+	std::vector<std::string> paths = this->takeMissingTextures();
+	if (paths.empty())
+		return;
+
+	std::string list;
+	for (const auto& path : paths)
+	{
+		if (!list.empty())
+			list += ", ";
+
+		list += path;
+	}
+
+	Log::w(STR_MISSING_TEXTURES, paths.size(), context.c_str());
+	Log::d(STR_MISSING_TEXTURES_LIST, context.c_str(), list.c_str());
+}
+
+/**
+ * Makes all missing textures reportable again, e.g. when another Location is loaded.
+ */
+void ResourceManager::forgetMissingTextures()
+{
+	const std::lock_guard<std::mutex> lock(this->texturesMutex);
+	this->missingTextures.clear();
+	this->reportedMissingTextures.clear();
+}
+
 /**
  * Loads audio from specified path into resource manager object.
  * Pointer to the loaded sound buffer is returned. If the buffer is already
@@ -147,7 +631,13 @@ std::shared_ptr<sf::SoundBuffer> ResourceManager::getSoundBuffer(const std::stri
 		return search->second; // resource already loaded
 
 	std::shared_ptr<sf::SoundBuffer> buf = std::make_shared<sf::SoundBuffer>();
-	if (!buf->loadFromFile(path))
+	const char* archivedData;
+	std::size_t archivedSize;
+	bool loaded = AssetArchive::getFile(path, archivedData, archivedSize) ?
+					  buf->loadFromMemory(archivedData, archivedSize) :
+					  buf->loadFromFile(path);
+
+	if (!loaded)
 	{
 		Log::e(STR_LOAD_FAIL, path.c_str());
 		return nullptr;
@@ -171,12 +661,89 @@ sf::Font* ResourceManager::getFont(FontType fontType)
 	return &this->fonts[fontType];
 }
 
+/**
+ * Finds paths of textures, e.g. to check if their files were modified (see RoomBackCache). Textures which are not
+ * managed by Resource Manager are skipped.
+ *
+ * Can be called from multiple threads at the same time.
+ *
+ * @param textures textures to look for
+ * @return interned paths of found textures, sorted by path, so that the order is the same in every game run
+ */
+std::vector<asset_id> ResourceManager::getTexturePathIds(const std::unordered_set<const sf::Texture*>& textures)
+{
+	std::vector<asset_id> pathIds;
+
+	{
+		const std::lock_guard<std::mutex> lock(this->texturesMutex);
+		for (const auto& [pathId, texture] : this->textures)
+		{
+			if (textures.find(texture.get()) != textures.end())
+				pathIds.push_back(pathId);
+		}
+	}
+
+	std::sort(pathIds.begin(), pathIds.end(),
+			  [](asset_id lhs, asset_id rhs) { return AssetInterner::getString(lhs) < AssetInterner::getString(rhs); });
+
+	return pathIds;
+}
+
+/**
+ * Reloads textures whose files were modified since the last call. Textures are reloaded in place, i.e. the image is
+ * uploaded to the same sf::Texture objects, so everything using them displays the new image right away, without being
+ * set up again. The only exception are things which drew the textures onto another texture (e.g. Room caches), which
+ * need to be redrawn.
+ *
+ * Note that sprites keep their texture rect, so if image size changes, they need to be set up again anyway.
+ *
+ * Should be called on the main thread, e.g. once per frame, while SettingsManager::debugHotReloadTextures is set.
+ *
+ * @return textures which were reloaded
+ */
+std::unordered_set<const sf::Texture*> ResourceManager::reloadChangedTextures()
+{
+	std::vector<std::pair<std::string, std::shared_ptr<sf::Texture>>> changed;
+	{
+		const std::lock_guard<std::mutex> lock(this->texturesMutex);
+
+		for (const std::string& path : this->textureWatcher.pollChanged())
+		{
+			auto search = this->textures.find(AssetInterner::intern(path));
+			if (search != this->textures.end())
+				changed.emplace_back(path, search->second);
+		}
+	}
+
+	std::unordered_set<const sf::Texture*> reloaded;
+	for (const auto& [path, txt] : changed)
+	{
+		// repeated and smooth flags are kept by sf::Texture
+		sf::Image image;
+		if (!image.loadFromFile(path) || !txt->loadFromImage(image))
+		{
+			Log::w(STR_TEXTURE_RELOAD_FAIL, path.c_str());
+			continue;
+		}
+
+		if (SettingsManager::textureCache)
+			TextureCache::save(path, image);
+
+		reloaded.insert(txt.get());
+		Log::i(STR_TEXTURE_RELOADED, path.c_str());
+	}
+
+	return reloaded;
+}
+
 /**
  * Unloads all unused resources.
  * Used to clear resources used by campaign after unloading a location, or whole campaign.
  */
 void ResourceManager::cleanUnused()
 {
+	const std::lock_guard<std::mutex> lock(this->texturesMutex);
+
 	size_t oldSize = this->textures.size();
 
 	for (auto it = this->textures.begin(); it != this->textures.end();)
@@ -189,6 +756,19 @@ void ResourceManager::cleanUnused()
 
 	size_t cleaned = oldSize - this->textures.size();
 
+	// tiles of erased tiled textures which are still pending won't be uploaded, see ::uploadPendingTiles()
+	oldSize = this->tiledTextures.size();
+
+	for (auto it = this->tiledTextures.begin(); it != this->tiledTextures.end();)
+	{
+		if (it->second.use_count() <= 1) // the only shared ptr exists in res mgr itself
+			it = this->tiledTextures.erase(it);
+		else
+			it++;
+	}
+
+	cleaned += (oldSize - this->tiledTextures.size());
+
 	oldSize = this->audios.size();
 
 	for (auto it = this->audios.begin(); it != this->audios.end();)
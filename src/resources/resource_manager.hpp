@@ -4,15 +4,27 @@
 
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
+#include <deque>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 #include <SFML/Audio/SoundBuffer.hpp>
 #include <SFML/Graphics/Font.hpp>
 #include <SFML/Graphics/Texture.hpp>
+#include <SFML/System/Vector2.hpp>
 
+#include "../util/file_watcher.hpp"
+#include "asset_interner.hpp"
+#include "texture_handle.hpp"
 #include "texture_resource.hpp"
+#include "tiled_texture.hpp"
 
 // core textures
 const std::string PATH_TXT_PIPBUCK_OVERLAY = "res/hud/pipbuck.png";
@@ -34,6 +46,13 @@ enum FontType
 	_FONT_CNT
 };
 
+struct tiled_texture_load
+{
+		asset_id pathId; // id of the variant, see ResourceManager::getTiledTexture()
+		std::shared_ptr<struct texture_load> load;
+		std::weak_ptr<TiledTexture> texture; // not kept alive if it's not used anymore
+};
+
 /**
  * The role of the ResourceManager is to avoid resource (e.g. textures, audio files, etc.) duplication in memory.
  *
@@ -54,6 +73,8 @@ enum FontType
  * their structure and provide convenient methods for getting/modifying data.
  *
  * Resource files are identified by their path in filesystem. The same string is used for loading and getting resources.
+ * Textures can also be identified by the id of their interned path (see AssetInterner), which is preferred for code
+ * that requests lots of textures (e.g. Room loading), as no strings need to be built or hashed then.
  *
  * There's a group of resources that need to be loaded all the time, e.g. some textures. Paths of these resources are
  * hardcoded. They must be loaded before starting the game. Game should not continue if any of those "core" resources
@@ -64,26 +85,94 @@ enum FontType
  *
  * Cursors are handled separately via the CursorManager class.
  *
+ * Getting textures is thread-safe, as Rooms are loaded in parallel (see Location::loadContent()). Textures can also be
+ * requested without waiting for them (see ::requestTexture()) - images are then decoded by a pool of background
+ * threads, and uploaded to the GPU in batches on the main thread (see ::uploadPendingTextures()). Concurrent requests
+ * for the same texture are merged into a single load. ::getTexture() is simply a blocking wrapper for that.
+ *
+ * Textures are only ever uploaded on the main thread (the one which created the Resource Manager and owns the window),
+ * as other threads don't have an OpenGL context. When a texture is requested on another thread, only decoding is
+ * waited for, and the returned texture stays empty until it's uploaded. Anything loaded on another thread should only
+ * be drawn after ::finishPendingTextures().
+ *
+ * Large textures which are drawn over the whole game world (e.g. full backgrounds) are loaded as tiled textures, which
+ * are uploaded to the GPU over multiple frames (see ::getTiledTexture()). They can be requested in a downscaled
+ * variant, matching current size of the game world viewport. When the window is small, this saves memory and fill
+ * rate, with no visible difference.
+ *
+ * In headless mode (e.g. when validating campaigns without a window, see Campaign::validate()), images are never
+ * decoded. Requested textures are only checked for existence, and empty textures are returned in their place.
+ *
  * TODO? res mgr could potentially be made into a "static class", same as with Log, to avoid passing it along everywhere
  */
 class ResourceManager
 {
 	private:
+		const bool headless;
+		const std::thread::id mainThreadId; // the only thread which uploads textures
 		sf::Font fonts[_FONT_CNT];
-		std::unordered_map<std::string, std::shared_ptr<sf::Texture>> textures;
+		std::unordered_map<asset_id, std::shared_ptr<sf::Texture>> textures;
+		std::unordered_map<asset_id, std::shared_ptr<struct texture_load>> pendingTextures;
+		std::unordered_map<asset_id, std::shared_ptr<TiledTexture>> tiledTextures;
+		std::mutex texturesMutex;
+
+		// guarded by texturesMutex. tiles are uploaded in request order, see ::uploadPendingTextures()
+		std::deque<struct tiled_texture_load> pendingTiledTextures;
+
+		// guarded by texturesMutex
+		std::deque<std::shared_ptr<struct texture_load>> decodeQueue;
+		std::condition_variable decodeCond;
+		bool stopDecoding = false;
+		std::vector<std::thread> decodeThreads;
 
 		// returned when requested texture could not be loaded. ptr stored here in order to always keep it loaded.
 		TextureResource notFoundTexture;
 
+		// textures which were requested to be repeated on another thread, guarded by texturesMutex. setting repeat mode
+		// of an uploaded texture needs OpenGL, so it's done on the main thread
+		std::vector<std::shared_ptr<sf::Texture>> pendingRepeatedTextures;
+
+		// textures which were replaced with notFoundTexture, guarded by texturesMutex. see ::reportMissingTextures()
+		std::unordered_set<asset_id> missingTextures;
+		std::unordered_set<asset_id> reportedMissingTextures;
+
+		// files of loaded textures, guarded by texturesMutex. see ::reloadChangedTextures()
+		FileWatcher textureWatcher;
+
+		// see ::setWorldViewportSize()
+		std::atomic<uint> worldDownscale = 1;
+
 		// it would be more convenient to store sf::Sound, however then we'd be unable
 		// to play the same sound multiple times at the same time, which will definitely happen
 		std::unordered_map<std::string, std::shared_ptr<sf::SoundBuffer>> audios;
 
+		void uploadPendingTiles(std::size_t& uploadCnt);
+		void decodeWork();
+		std::shared_ptr<sf::Texture> waitForTexture(asset_id pathId, const TextureHandle& handle);
+
 	public:
+		explicit ResourceManager(bool headless = false);
+		~ResourceManager();
 		bool loadFonts();
 		bool loadCore();
+		TextureHandle requestTexture(asset_id pathId);
+		TextureHandle requestTexture(const std::string& path);
+		void uploadPendingTextures();
+		void finishPendingTextures();
+		bool hasPendingTextures();
+		std::shared_ptr<sf::Texture> getTexture(asset_id pathId, bool returnSomething = true);
 		std::shared_ptr<sf::Texture> getTexture(const std::string& path, bool returnSomething = true);
+		std::shared_ptr<sf::Texture> getRepeatedTexture(asset_id pathId);
+		std::shared_ptr<sf::Texture> getRepeatedTexture(const std::string& path);
+		std::shared_ptr<TiledTexture> getTiledTexture(const std::string& path, uint downscale);
+		void setWorldViewportSize(sf::Vector2u viewportSize);
+		uint getWorldDownscale() const;
 		std::shared_ptr<sf::Texture> getNotFoundTexture() const;
+		std::vector<std::string> takeMissingTextures();
+		void reportMissingTextures(const std::string& context);
+		void forgetMissingTextures();
+		std::vector<asset_id> getTexturePathIds(const std::unordered_set<const sf::Texture*>& textures);
+		std::unordered_set<const sf::Texture*> reloadChangedTextures();
 		std::shared_ptr<sf::SoundBuffer> getSoundBuffer(const std::string& path);
 		sf::Font* getFont(FontType fontType);
 		void cleanUnused();
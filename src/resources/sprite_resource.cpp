@@ -23,6 +23,19 @@ bool SpriteResource::isTextureSet() const
 	return this->txt != nullptr;
 }
 
+/**
+ * Sets texture rect to cover the whole texture. Needed when the texture was set before it was uploaded (e.g. on a
+ * loading thread, see ResourceManager::getTexture()), as the rect is then set to the empty texture's size (0x0).
+ */
+void SpriteResource::resetTextureRect()
+{
+	if (this->txt == nullptr)
+		return;
+
+	const sf::Vector2u size = this->txt->getSize();
+	this->setTextureRect({ 0, 0, static_cast<int>(size.x), static_cast<int>(size.y) });
+}
+
 void SpriteResource::clearPtr()
 {
 	this->txt = nullptr;
@@ -29,5 +29,6 @@ class SpriteResource : public sf::Sprite
 		explicit SpriteResource(std::shared_ptr<sf::Texture> txt);
 		void setTexture(std::shared_ptr<sf::Texture> txt);
 		bool isTextureSet() const;
+		void resetTextureRect();
 		void clearPtr();
 };
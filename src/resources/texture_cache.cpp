@@ -0,0 +1,80 @@
+// SPDX-License-Identifier: GPL-3.0-only
+//
+// (c) 2024 h67ma <szycikm@gmail.com>
+
+#include "texture_cache.hpp"
+
+#include <algorithm>
+#include <vector>
+
+#include "../hud/log.hpp"
+#include "../settings/settings_manager.hpp"
+#include "../util/binary_stream.hpp"
+#include "../util/i18n.hpp"
+#include "../util/mapped_file.hpp"
+#include "../util/qoi.hpp"
+#include "../util/util.hpp"
+#include "asset_archive.hpp"
+
+std::string TextureCache::getCachePath(const std::string& path)
+{
+	std::string filename = path;
+	std::replace(filename.begin(), filename.end(), PATH_DELIM, '_');
+	return pathCombine(SettingsManager::getCacheDir(), filename + ".qoi");
+}
+
+/**
+ * Loads a cached image, previously written with ::save().
+ *
+ * @param path path of the source image (not the cache file)
+ * @param image loaded image will be stored here
+ * @return true if the image was loaded from cache
+ * @return false if the image is not cached, or the cached version is outdated. Source image should be decoded then
+ */
+bool TextureCache::load(const std::string& path, sf::Image& image)
+{
+	struct texture_cache_header expected = { TEXTURE_CACHE_MAGIC, TEXTURE_CACHE_VERSION, 0, 0 };
+	if (!AssetArchive::getFileStamp(path, expected.sourceSize, expected.sourceMtime))
+		return false;
+
+	MappedFile cacheFile;
+	if (!cacheFile.open(TextureCache::getCachePath(path)))
+		return false;
+
+	BinaryReader reader(cacheFile.getData(), cacheFile.getSize());
+	struct texture_cache_header header;
+	if (!reader.read(header) || header.magic != expected.magic || header.version != expected.version ||
+		header.sourceSize != expected.sourceSize || header.sourceMtime != expected.sourceMtime)
+		return false;
+
+	std::uint32_t width;
+	std::uint32_t height;
+	std::vector<std::uint8_t> pixels;
+	if (!qoiDecode(cacheFile.getData() + sizeof(header), cacheFile.getSize() - sizeof(header), width, height, pixels))
+		return false;
+
+	image.create(width, height, pixels.data());
+	return true;
+}
+
+/**
+ * Writes a decoded image to cache. Failing to write is not critical, the image will just be decoded from source
+ * again next time.
+ *
+ * @param path path of the source image (not the cache file)
+ * @param image decoded source image
+ */
+void TextureCache::save(const std::string& path, const sf::Image& image)
+{
+	struct texture_cache_header header = { TEXTURE_CACHE_MAGIC, TEXTURE_CACHE_VERSION, 0, 0 };
+	if (!AssetArchive::getFileStamp(path, header.sourceSize, header.sourceMtime))
+		return;
+
+	BinaryWriter writer;
+	writer.write(header);
+	qoiEncode(image.getPixelsPtr(), image.getSize().x, image.getSize().y, writer);
+
+	const std::string cachePath = TextureCache::getCachePath(path);
+	if (!writer.saveToFile(cachePath))
+		Log::w(STR_TEXTURE_CACHE_WRITE_FAIL, cachePath.c_str());
+}
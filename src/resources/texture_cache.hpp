@@ -0,0 +1,44 @@
+// SPDX-License-Identifier: GPL-3.0-only
+//
+// (c) 2024 h67ma <szycikm@gmail.com>
+
+#pragma once
+
+#include <cstdint>
+
+#include <string>
+
+#include <SFML/Graphics/Image.hpp>
+
+// cache files with a different magic or version are ignored (and overwritten)
+constexpr std::uint32_t TEXTURE_CACHE_MAGIC = 0x43544F46; // "FOTC"
+constexpr std::uint32_t TEXTURE_CACHE_VERSION = 1;
+
+struct texture_cache_header
+{
+		std::uint32_t magic;
+		std::uint32_t version;
+		std::uint64_t sourceSize;
+		std::int64_t sourceMtime;
+};
+
+/**
+ * TextureCache stores decoded textures in the cache dir, so that next time they are loaded, decoding PNG (slow) can be
+ * replaced with decoding QOI (fast, see qoi.hpp). Cached images are validated against size and modification time of
+ * the source file, so changing a texture automatically invalidates its cached version.
+ *
+ * Cache file structure (native byte order):
+ *   - header (see struct texture_cache_header)
+ *   - the image, encoded as QOI
+ *
+ * Can be disabled via SettingsManager::textureCache.
+ */
+class TextureCache
+{
+	private:
+		static std::string getCachePath(const std::string& path);
+
+	public:
+		static bool load(const std::string& path, sf::Image& image);
+		static void save(const std::string& path, const sf::Image& image);
+};
@@ -0,0 +1,203 @@
+// SPDX-License-Identifier: GPL-3.0-only
+//
+// (c) 2024 h67ma <szycikm@gmail.com>
+
+#include "texture_handle.hpp"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "../settings/settings_manager.hpp"
+#include "../util/load_progress.hpp"
+#include "asset_archive.hpp"
+#include "asset_manifest.hpp"
+#include "texture_cache.hpp"
+
+/**
+ * Downscales an image by an integer factor, averaging each block of factor x factor pixels. Blocks on the right and
+ * bottom edge can be smaller, if image size is not divisible by the factor.
+ *
+ * @param image image to downscale
+ * @param factor downscale factor
+ */
+static void downscaleImage(sf::Image& image, uint factor)
+{
+	const sf::Vector2u size = image.getSize();
+	const sf::Vector2u newSize((size.x + factor - 1) / factor, (size.y + factor - 1) / factor);
+	const sf::Uint8* pixels = image.getPixelsPtr();
+	std::vector<sf::Uint8> newPixels(static_cast<std::size_t>(newSize.x) * newSize.y * 4);
+
+	for (uint y = 0; y < newSize.y; y++)
+	{
+		const uint blockEndY = std::min((y + 1) * factor, size.y);
+		for (uint x = 0; x < newSize.x; x++)
+		{
+			const uint blockEndX = std::min((x + 1) * factor, size.x);
+			uint sums[4] = { 0, 0, 0, 0 };
+			for (uint srcY = y * factor; srcY < blockEndY; srcY++)
+			{
+				for (uint srcX = x * factor; srcX < blockEndX; srcX++)
+				{
+					const sf::Uint8* pixel = pixels + (static_cast<std::size_t>(srcY) * size.x + srcX) * 4;
+					for (uint channel = 0; channel < 4; channel++)
+					{
+						sums[channel] += pixel[channel];
+					}
+				}
+			}
+
+			const uint blockSize = (blockEndX - x * factor) * (blockEndY - y * factor);
+			sf::Uint8* newPixel = newPixels.data() + (static_cast<std::size_t>(y) * newSize.x + x) * 4;
+			for (uint channel = 0; channel < 4; channel++)
+			{
+				newPixel[channel] = static_cast<sf::Uint8>(sums[channel] / blockSize);
+			}
+		}
+	}
+
+	image.create(newSize.x, newSize.y, newPixels.data());
+}
+
+/**
+ * Decodes the image of a queued load. Does nothing if the load was already picked up by another thread.
+ *
+ * @return true if the load was picked up by this call
+ * @return false if another thread already picked it up
+ */
+bool decodeTexture(struct texture_load& load)
+{
+	{
+		const std::lock_guard<std::mutex> lock(load.mutex);
+		if (load.state != TXT_LOAD_QUEUED)
+			return false;
+
+		load.state = TXT_LOAD_DECODING;
+	}
+
+	// the image is only touched by the thread which set the decoding state, so no need to hold the lock here
+	bool decoded = SettingsManager::textureCache && TextureCache::load(load.path, load.image);
+	if (!decoded)
+	{
+		const char* archivedData;
+		std::size_t archivedSize;
+		if (AssetArchive::getFile(load.path, archivedData, archivedSize))
+		{
+			decoded = load.image.loadFromMemory(archivedData, archivedSize);
+			load.progress->addBytesRead(archivedSize);
+		}
+		else
+			decoded = AssetManifest::isLoose(load.path) && load.image.loadFromFile(load.path);
+
+		if (decoded && SettingsManager::textureCache)
+			TextureCache::save(load.path, load.image);
+	}
+
+	// only the source image is cached, downscaling is quick compared to decoding
+	if (decoded && load.downscale > 1)
+		downscaleImage(load.image, load.downscale);
+
+	if (decoded)
+		load.progress->addTextureDecoded();
+
+	{
+		const std::lock_guard<std::mutex> lock(load.mutex);
+		load.state = decoded ? TXT_LOAD_DECODED : TXT_LOAD_FAILED;
+	}
+
+	load.cond.notify_all();
+	return true;
+}
+
+/**
+ * Uploads the decoded image of a load to the GPU. Does nothing if the image is not decoded yet, or was already
+ * uploaded.
+ *
+ * Must be called on the thread owning the window (see ResourceManager::uploadPendingTextures()), as other threads
+ * don't have an OpenGL context.
+ *
+ * @return true if the load is finished (successfully or not)
+ * @return false if the image is not decoded yet
+ */
+bool uploadTexture(struct texture_load& load)
+{
+	std::unique_lock<std::mutex> lock(load.mutex);
+
+	if (load.state == TXT_LOAD_DONE || load.state == TXT_LOAD_FAILED)
+		return true;
+
+	if (load.state != TXT_LOAD_DECODED)
+		return false;
+
+	// the texture object already exists, it only needs to be filled. this way every waiting thread gets the same one
+	if (load.texture->loadFromImage(load.image))
+	{
+		load.texture->setSmooth(true);
+		load.state = TXT_LOAD_DONE;
+	}
+	else
+	{
+		load.state = TXT_LOAD_FAILED;
+	}
+
+	load.image = sf::Image(); // not needed anymore
+	lock.unlock();
+
+	load.cond.notify_all();
+	return true;
+}
+
+/**
+ * Creates a handle to an already loaded texture.
+ */
+TextureHandle::TextureHandle(std::shared_ptr<sf::Texture> texture) : texture(std::move(texture))
+{
+}
+
+TextureHandle::TextureHandle(std::shared_ptr<struct texture_load> load) : load(std::move(load))
+{
+}
+
+/**
+ * @return true if the texture is loaded (or failed to load), i.e. ::get() won't block
+ */
+bool TextureHandle::isReady() const
+{
+	if (this->load == nullptr)
+		return true;
+
+	const std::lock_guard<std::mutex> lock(this->load->mutex);
+	return this->load->state == TXT_LOAD_DONE || this->load->state == TXT_LOAD_FAILED;
+}
+
+/**
+ * Waits until the texture is loaded. If the texture is still queued, it's decoded on the calling thread instead of
+ * waiting for a decoding thread. Same for uploading - the calling thread won't wait for the next batch of uploads.
+ *
+ * Uploading can only be done on the thread owning the window, so other threads should only wait for the image to be
+ * decoded. The returned texture is then empty, until it's uploaded via ResourceManager::uploadPendingTextures().
+ *
+ * @param upload true if the texture should be uploaded on the calling thread, false to only wait for decoding
+ * @return the loaded texture, or nullptr if it could not be loaded
+ */
+std::shared_ptr<sf::Texture> TextureHandle::get(bool upload) const
+{
+	if (this->load == nullptr)
+		return this->texture;
+
+	decodeTexture(*this->load);
+
+	{
+		std::unique_lock<std::mutex> lock(this->load->mutex);
+		this->load->cond.wait(lock, [this]() { return this->load->state != TXT_LOAD_DECODING; });
+	}
+
+	if (upload)
+		uploadTexture(*this->load);
+
+	const std::lock_guard<std::mutex> lock(this->load->mutex);
+	if (this->load->state == TXT_LOAD_DONE || this->load->state == TXT_LOAD_DECODED)
+		return this->load->texture;
+
+	return nullptr;
+}
@@ -0,0 +1,62 @@
+// SPDX-License-Identifier: GPL-3.0-only
+//
+// (c) 2024 h67ma <szycikm@gmail.com>
+
+#pragma once
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include <SFML/Graphics/Image.hpp>
+#include <SFML/Graphics/Texture.hpp>
+
+#include "../consts.hpp"
+#include "../util/load_progress.hpp"
+
+enum TextureLoadState
+{
+	TXT_LOAD_QUEUED, // waiting for a decoding thread
+	TXT_LOAD_DECODING,
+	TXT_LOAD_DECODED, // image decoded, waiting for upload to GPU
+	TXT_LOAD_DONE,
+	TXT_LOAD_FAILED,
+};
+
+/**
+ * State of a single texture load, shared between all threads waiting for the texture.
+ */
+struct texture_load
+{
+		std::string path;
+		uint downscale = 1; // see ResourceManager::getTiledTexture()
+		std::mutex mutex;
+		std::condition_variable cond;
+		enum TextureLoadState state = TXT_LOAD_QUEUED;
+		sf::Image image;
+		std::shared_ptr<sf::Texture> texture = nullptr;
+		std::shared_ptr<LoadProgress> progress = LoadProgress::getCurrent(); // of the thread which requested the load
+};
+
+bool decodeTexture(struct texture_load& load);
+bool uploadTexture(struct texture_load& load);
+
+/**
+ * A handle to a texture which is possibly still being loaded in the background (see ResourceManager::requestTexture()).
+ * The handle can be polled via ::isReady(), or waited for via ::get().
+ *
+ * Copies of the handle refer to the same load.
+ */
+class TextureHandle
+{
+	private:
+		std::shared_ptr<struct texture_load> load = nullptr;
+		std::shared_ptr<sf::Texture> texture = nullptr;
+
+	public:
+		explicit TextureHandle(std::shared_ptr<sf::Texture> texture);
+		explicit TextureHandle(std::shared_ptr<struct texture_load> load);
+		bool isReady() const;
+		std::shared_ptr<sf::Texture> get(bool upload = true) const;
+};
@@ -0,0 +1,121 @@
+// SPDX-License-Identifier: GPL-3.0-only
+//
+// (c) 2024 h67ma <szycikm@gmail.com>
+
+#include "tiled_texture.hpp"
+
+#include <algorithm>
+
+#include <SFML/Graphics/PrimitiveType.hpp>
+#include <SFML/Graphics/Rect.hpp>
+
+/**
+ * Sets up the grid of tiles for an image of specified size. No tiles are uploaded yet.
+ *
+ * @param imageSize size of the image which will be uploaded
+ * @param scale factor by which the texture is scaled up when drawn (e.g. if the image was downscaled)
+ */
+void TiledTexture::create(sf::Vector2u imageSize, uint scale)
+{
+	this->size = imageSize;
+	this->scale = scale;
+	this->tileCnt = sf::Vector2u((imageSize.x + TEXTURE_TILE_SIZE - 1) / TEXTURE_TILE_SIZE,
+								 (imageSize.y + TEXTURE_TILE_SIZE - 1) / TEXTURE_TILE_SIZE);
+	this->uploadedCnt = 0;
+	this->created = true;
+
+	this->tiles.clear();
+	this->tiles.resize(static_cast<std::size_t>(this->tileCnt.x) * this->tileCnt.y);
+	this->vertices.clear();
+	this->vertices.reserve(this->tiles.size() * 4);
+
+	for (uint y = 0; y < this->tileCnt.y; y++)
+	{
+		for (uint x = 0; x < this->tileCnt.x; x++)
+		{
+			const uint left = x * TEXTURE_TILE_SIZE;
+			const uint top = y * TEXTURE_TILE_SIZE;
+			const uint right = std::min(left + TEXTURE_TILE_SIZE, imageSize.x);
+			const uint bottom = std::min(top + TEXTURE_TILE_SIZE, imageSize.y);
+
+			// tile texture starts 1px earlier, except for the first column/row (see ::uploadNextTile())
+			const float txtLeft = left > 0 ? 1.f : 0.f;
+			const float txtTop = top > 0 ? 1.f : 0.f;
+			const float txtRight = txtLeft + static_cast<float>(right - left);
+			const float txtBottom = txtTop + static_cast<float>(bottom - top);
+
+			const float posLeft = static_cast<float>(left * scale);
+			const float posTop = static_cast<float>(top * scale);
+			const float posRight = static_cast<float>(right * scale);
+			const float posBottom = static_cast<float>(bottom * scale);
+
+			this->vertices.emplace_back(sf::Vector2f(posLeft, posTop), sf::Vector2f(txtLeft, txtTop));
+			this->vertices.emplace_back(sf::Vector2f(posRight, posTop), sf::Vector2f(txtRight, txtTop));
+			this->vertices.emplace_back(sf::Vector2f(posRight, posBottom), sf::Vector2f(txtRight, txtBottom));
+			this->vertices.emplace_back(sf::Vector2f(posLeft, posBottom), sf::Vector2f(txtLeft, txtBottom));
+		}
+	}
+}
+
+/**
+ * Uploads the next tile (in row-major order) to the GPU. Must be called on the thread owning the window.
+ *
+ * @param image the image passed to ::create()
+ * @return true if a tile was uploaded
+ * @return false if all tiles were already uploaded
+ */
+bool TiledTexture::uploadNextTile(const sf::Image& image)
+{
+	if (this->uploadedCnt >= this->tiles.size())
+		return false;
+
+	const uint x = static_cast<uint>(this->uploadedCnt % this->tileCnt.x);
+	const uint y = static_cast<uint>(this->uploadedCnt / this->tileCnt.x);
+
+	// 1px border on each side shared with neighbouring tiles
+	const uint left = x * TEXTURE_TILE_SIZE;
+	const uint top = y * TEXTURE_TILE_SIZE;
+	const uint areaLeft = left > 0 ? left - 1 : 0;
+	const uint areaTop = top > 0 ? top - 1 : 0;
+	const uint areaRight = std::min(left + TEXTURE_TILE_SIZE + 1, this->size.x);
+	const uint areaBottom = std::min(top + TEXTURE_TILE_SIZE + 1, this->size.y);
+
+	sf::Texture& tile = this->tiles[this->uploadedCnt];
+	tile.loadFromImage(image, sf::IntRect(static_cast<int>(areaLeft), static_cast<int>(areaTop),
+										  static_cast<int>(areaRight - areaLeft),
+										  static_cast<int>(areaBottom - areaTop)));
+	tile.setSmooth(true);
+
+	this->uploadedCnt++;
+	return true;
+}
+
+bool TiledTexture::isCreated() const
+{
+	return this->created;
+}
+
+/**
+ * @return true if all tiles were uploaded
+ */
+bool TiledTexture::isUploaded() const
+{
+	return this->created && this->uploadedCnt == this->tiles.size();
+}
+
+/**
+ * @return size of the area covered by the texture when drawn, i.e. including scale
+ */
+sf::Vector2u TiledTexture::getSize() const
+{
+	return this->size * this->scale;
+}
+
+void TiledTexture::draw(sf::RenderTarget& target, sf::RenderStates states) const
+{
+	for (std::size_t i = 0; i < this->uploadedCnt; i++)
+	{
+		states.texture = &this->tiles[i];
+		target.draw(&this->vertices[i * 4], 4, sf::Quads, states);
+	}
+}
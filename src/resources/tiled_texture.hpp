@@ -0,0 +1,51 @@
+// SPDX-License-Identifier: GPL-3.0-only
+//
+// (c) 2024 h67ma <szycikm@gmail.com>
+
+#pragma once
+
+#include <cstddef>
+
+#include <vector>
+
+#include <SFML/Graphics/Drawable.hpp>
+#include <SFML/Graphics/Image.hpp>
+#include <SFML/Graphics/RenderStates.hpp>
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/Texture.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+#include <SFML/System/Vector2.hpp>
+
+#include "../consts.hpp"
+
+constexpr uint TEXTURE_TILE_SIZE = 512;
+
+/**
+ * A large texture split into a grid of smaller tiles, each tile being a separate texture. Tiles are uploaded to the GPU
+ * one at a time (see ResourceManager::uploadPendingTextures()), so that uploading the whole texture doesn't stall a
+ * single frame. Only tiles which were already uploaded are drawn.
+ *
+ * Each tile texture also contains a 1px border copied from neighbouring tiles, so that smoothing doesn't produce
+ * visible seams between tiles.
+ *
+ * Tiled textures are managed by Resource Manager, see ResourceManager::getTiledTexture().
+ */
+class TiledTexture : public sf::Drawable
+{
+	private:
+		sf::Vector2u size;
+		sf::Vector2u tileCnt;
+		std::vector<sf::Texture> tiles;
+		std::vector<sf::Vertex> vertices; // 4 per tile, as quads
+		std::size_t uploadedCnt = 0;
+		uint scale = 1;
+		bool created = false;
+
+	public:
+		void create(sf::Vector2u imageSize, uint scale);
+		bool uploadNextTile(const sf::Image& image);
+		bool isCreated() const;
+		bool isUploaded() const;
+		sf::Vector2u getSize() const;
+		void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+};
@@ -11,6 +11,7 @@
 
 #include <filesystem>
 #include <string>
+#include <system_error>
 
 #include <SFML/Graphics/RenderTexture.hpp>
 
@@ -44,8 +45,11 @@ constexpr uint MAX_ROOM_TRANSITION_MS = 5000;
 
 constexpr uint DEFAULT_AA = 8;
 
+constexpr uint MIN_LOADED_ROOMS = 7; // current Room + 6 neighbors
+
 std::string SettingsManager::gameRootDir;
 std::string SettingsManager::saveDir;
+std::string SettingsManager::cacheDir;
 
 std::vector<std::unique_ptr<Setting>> SettingsManager::settings;
 
@@ -73,12 +77,23 @@ uint SettingsManager::antiAliasing;
 uint SettingsManager::windowWidth;
 uint SettingsManager::windowHeight;
 
+///// memory /////
+uint SettingsManager::maxLoadedRooms;
+bool SettingsManager::prefetchLocations;
+uint SettingsManager::roomCacheBudgetMb;
+
+///// cache /////
+bool SettingsManager::textureCache;
+bool SettingsManager::roomBackCache;
+
 ///// debug /////
 std::string SettingsManager::debugAutoloadCampaign;
 bool SettingsManager::debugWriteLogToFile;
 bool SettingsManager::debugPrintToStderr;
 bool SettingsManager::debugVerbose;
 bool SettingsManager::debugNavigation;
+bool SettingsManager::debugHotReloadRooms;
+bool SettingsManager::debugHotReloadTextures;
 bool SettingsManager::debugBoundingBoxes;
 ScreenSide SettingsManager::debugConsoleAnchor;
 bool SettingsManager::debugConsoleEnabled;
@@ -133,6 +148,27 @@ void SettingsManager::setup()
 		NumericSetting, windowHeight, 720, [](uint val) { return val > 0 && val <= MAX_RESOLUTION; },
 		"between 0 and " STR_EXP(MAX_RESOLUTION));
 
+	///// memory /////
+
+	// 0 = keep all Rooms of the current Location loaded
+	SETT_SETUP_CONSTR(
+		NumericSetting, maxLoadedRooms, 0, [](uint val) { return val == 0 || val >= MIN_LOADED_ROOMS; },
+		"0, or at least " STR_EXP(MIN_LOADED_ROOMS));
+
+	// start loading a Location in the background when it's selected on the world map
+	SETT_SETUP(LogicSetting, prefetchLocations, true);
+
+	// GPU memory for render caches of recently visited Rooms. the current Room is always cached, even over budget
+	SETT_SETUP(NumericSetting, roomCacheBudgetMb, 256);
+
+	///// cache /////
+
+	// store decoded textures in cache dir, in a format which is much faster to decode than png
+	SETT_SETUP(LogicSetting, textureCache, true);
+
+	// store drawn room backgrounds in cache dir, so that they don't need to be drawn again when entering the room
+	SETT_SETUP(LogicSetting, roomBackCache, true);
+
 	///// debug /////
 
 	SETT_SETUP(TextSetting, debugAutoloadCampaign, ""); // "" = do not autoload
@@ -142,6 +178,12 @@ void SettingsManager::setup()
 
 	// TODO debugNavigation should also include `testmode` functionality (i.e. ability to travel to any location)
 	SETT_SETUP(LogicSetting, debugNavigation, false);
+
+	// reload Rooms of the current Location when its rooms file is modified
+	SETT_SETUP(LogicSetting, debugHotReloadRooms, false);
+
+	// reload loaded textures when their files are modified
+	SETT_SETUP(LogicSetting, debugHotReloadTextures, false);
 	SETT_SETUP(LogicSetting, debugBoundingBoxes, false);
 	SETT_SETUP_ENUM_SCREENSIDE(debugConsoleAnchor, SIDE_BOTTOM);
 	SETT_SETUP(LogicSetting, debugConsoleEnabled, false);
@@ -221,7 +263,7 @@ void SettingsManager::resetAllToDefault()
 }
 
 /**
- * @brief Generates game root and savegame dirs and creates directories for both.
+ * @brief Generates game root, savegame and cache dirs and creates directories for all of them.
  *
  * Can be called before calling ::loadConfig(), as paths do not depend on any custom config (it would be impossible, as
  * config.json is stored *inside* game root dir).
@@ -247,17 +289,22 @@ bool SettingsManager::generatePathsAndMkdir()
 
 	SettingsManager::gameRootDir = pathCombine(homeDir, PATH_DIR_GAMEDATA);
 	SettingsManager::saveDir = pathCombine(gameRootDir, PATH_DIR_SAVES);
+	SettingsManager::cacheDir = pathCombine(gameRootDir, PATH_DIR_CACHE);
 
-	if (std::filesystem::exists(saveDir))
+	if (std::filesystem::exists(saveDir) && std::filesystem::exists(cacheDir))
 		return true;
 
-	if (std::filesystem::create_directories(saveDir))
-	{
-		Log::d(STR_CREATED_GAME_DIRS);
-		return true;
-	}
+	std::error_code err;
+	std::filesystem::create_directories(saveDir, err);
+	if (err)
+		return false;
+
+	std::filesystem::create_directories(cacheDir, err);
+	if (err)
+		return false;
 
-	return false;
+	Log::d(STR_CREATED_GAME_DIRS);
+	return true;
 }
 
 std::string SettingsManager::getGameRootDir()
@@ -269,3 +316,12 @@ std::string SettingsManager::getSaveDir()
 {
 	return SettingsManager::saveDir;
 }
+
+/**
+ * @return path to directory for storing files generated from game data, which can be safely deleted (they will be
+ *		   regenerated when needed)
+ */
+std::string SettingsManager::getCacheDir()
+{
+	return SettingsManager::cacheDir;
+}
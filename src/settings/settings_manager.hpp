@@ -76,6 +76,7 @@ class SettingsManager
 		// with ::generatePathsAndMkdir()
 		static std::string gameRootDir;
 		static std::string saveDir;
+		static std::string cacheDir;
 
 	public:
 		static void setup();
@@ -85,6 +86,7 @@ class SettingsManager
 		static bool generatePathsAndMkdir();
 		static std::string getGameRootDir();
 		static std::string getSaveDir();
+		static std::string getCacheDir();
 
 		// when adding a new setting, it needs to be initialized in ::setup() to support serdes
 
@@ -112,12 +114,23 @@ class SettingsManager
 		static uint windowWidth;
 		static uint windowHeight;
 
+		///// memory /////
+		static uint maxLoadedRooms;
+		static bool prefetchLocations;
+		static uint roomCacheBudgetMb;
+
+		///// cache /////
+		static bool textureCache;
+		static bool roomBackCache;
+
 		///// debug - name must start with "debug" /////
 		static std::string debugAutoloadCampaign;
 		static bool debugWriteLogToFile;
 		static bool debugPrintToStderr;
 		static bool debugVerbose;
 		static bool debugNavigation;
+		static bool debugHotReloadRooms;
+		static bool debugHotReloadTextures;
 		static bool debugBoundingBoxes;
 		static ScreenSide debugConsoleAnchor;
 		static bool debugConsoleEnabled;
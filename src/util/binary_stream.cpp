@@ -0,0 +1,89 @@
+// SPDX-License-Identifier: GPL-3.0-only
+//
+// (c) 2024 h67ma <szycikm@gmail.com>
+
+#include "binary_stream.hpp"
+
+#include <cstdint>
+
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <system_error>
+#include <thread>
+
+/**
+ * Reads a string previously written with BinaryWriter::writeString().
+ */
+bool BinaryReader::readString(std::string& value)
+{
+	std::uint32_t len;
+	if (!this->read(len))
+		return false;
+
+	if (static_cast<std::size_t>(this->end - this->cursor) < len)
+		return false;
+
+	value.assign(this->cursor, len);
+	this->cursor += len;
+	return true;
+}
+
+bool BinaryReader::atEnd() const
+{
+	return this->cursor == this->end;
+}
+
+/**
+ * Writes a length-prefixed string.
+ */
+void BinaryWriter::writeString(const std::string& value)
+{
+	this->write(static_cast<std::uint32_t>(value.length()));
+	this->writeBytes(value.data(), value.length());
+}
+
+const std::string& BinaryWriter::getBuffer() const
+{
+	return this->buffer;
+}
+
+/**
+ * Writes the buffer to a file. The data is first written to a temporary file, which then replaces the target file,
+ * so that readers will never see a partially written file. The temporary file name is unique, so the same file can be
+ * written from multiple threads at the same time (the last write wins).
+ *
+ * @param path path to the target file
+ * @return true if the file was written
+ * @return false if writing failed
+ */
+bool BinaryWriter::saveToFile(const std::string& path) const
+{
+	static std::atomic<std::uint32_t> tmpCnt = 0;
+	const std::string tmpPath = path + "." + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) +
+								"." + std::to_string(tmpCnt++) + ".tmp";
+
+	std::ofstream writer(tmpPath, std::ios::binary | std::ios::trunc);
+	if (!writer.is_open())
+		return false;
+
+	writer.write(this->buffer.data(), static_cast<std::streamsize>(this->buffer.size()));
+	writer.close();
+
+	std::error_code err;
+	if (writer.fail())
+	{
+		std::filesystem::remove(tmpPath, err);
+		return false;
+	}
+
+	std::filesystem::rename(tmpPath, path, err);
+	if (err)
+	{
+		std::filesystem::remove(tmpPath, err);
+		return false;
+	}
+
+	return true;
+}
@@ -0,0 +1,73 @@
+// SPDX-License-Identifier: GPL-3.0-only
+//
+// (c) 2024 h67ma <szycikm@gmail.com>
+
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+
+#include <string>
+#include <type_traits>
+
+/**
+ * Reads binary data from a memory buffer (e.g. a MappedFile). The buffer is not copied, so it must outlive the reader.
+ *
+ * All reads are bounds-checked - reading past the end of the buffer fails and leaves the output untouched. Values are
+ * stored in native byte order, so the data is only meant to be read on the same machine it was written on.
+ */
+class BinaryReader
+{
+	private:
+		const char* cursor;
+		const char* end;
+
+	public:
+		BinaryReader(const char* data, std::size_t size) : cursor(data), end(data + size) {}
+
+		bool readBytes(void* dst, std::size_t len)
+		{
+			if (static_cast<std::size_t>(this->end - this->cursor) < len)
+				return false;
+
+			std::memcpy(dst, this->cursor, len);
+			this->cursor += len;
+			return true;
+		}
+
+		template<typename T>
+		bool read(T& value)
+		{
+			static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable types can be read directly");
+			return this->readBytes(&value, sizeof(T));
+		}
+
+		bool readString(std::string& value);
+		bool atEnd() const;
+};
+
+/**
+ * Writes binary data into a memory buffer, which can then be written to a file in one go. See BinaryReader.
+ */
+class BinaryWriter
+{
+	private:
+		std::string buffer;
+
+	public:
+		void writeBytes(const void* src, std::size_t len)
+		{
+			this->buffer.append(static_cast<const char*>(src), len);
+		}
+
+		template<typename T>
+		void write(const T& value)
+		{
+			static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable types can be written directly");
+			this->writeBytes(&value, sizeof(T));
+		}
+
+		void writeString(const std::string& value);
+		const std::string& getBuffer() const;
+		bool saveToFile(const std::string& path) const;
+};
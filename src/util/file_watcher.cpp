@@ -0,0 +1,134 @@
+// SPDX-License-Identifier: GPL-3.0-only
+//
+// (c) 2024 h67ma <szycikm@gmail.com>
+
+#include "file_watcher.hpp"
+
+#include <filesystem>
+#include <system_error>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif /* __linux__ */
+
+FileWatcher::~FileWatcher()
+{
+	this->clear();
+}
+
+/**
+ * Starts watching a file. Watching the same file again has no effect.
+ *
+ * @param path path to the file. Changed files will be reported by ::pollChanged() using the same path
+ * @return true if the file is being watched
+ * @return false if the file can't be watched (e.g. it doesn't exist)
+ */
+bool FileWatcher::watch(const std::string& path)
+{
+	if (this->watchedFiles.find(path) != this->watchedFiles.end())
+		return true;
+
+#ifdef __linux__
+	if (this->inotifyFd == -1)
+	{
+		this->inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+		if (this->inotifyFd == -1)
+			return false;
+	}
+
+	std::string dirPath = std::filesystem::path(path).parent_path().string();
+	if (dirPath.empty())
+		dirPath = ".";
+
+	// adding the same dir again returns the same descriptor
+	int wd = inotify_add_watch(this->inotifyFd, dirPath.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+	if (wd == -1)
+		return false;
+
+	this->watchedDirs.emplace(wd, dirPath);
+#else
+	std::error_code err;
+	std::filesystem::file_time_type mtime = std::filesystem::last_write_time(path, err);
+	if (err)
+		return false;
+
+	this->mtimes[path] = mtime;
+#endif /* __linux__ */
+
+	this->watchedFiles.insert(path);
+	return true;
+}
+
+/**
+ * Stops watching all files.
+ */
+void FileWatcher::clear()
+{
+	this->watchedFiles.clear();
+
+#ifdef __linux__
+	if (this->inotifyFd != -1)
+	{
+		// closing the descriptor removes all watches
+		::close(this->inotifyFd);
+		this->inotifyFd = -1;
+	}
+
+	this->watchedDirs.clear();
+#else
+	this->mtimes.clear();
+#endif /* __linux__ */
+}
+
+/**
+ * Never blocks.
+ *
+ * @return paths of watched files which changed since the last call. Each changed file is reported once, even if it
+ *         changed multiple times
+ */
+std::vector<std::string> FileWatcher::pollChanged()
+{
+	std::unordered_set<std::string> changed;
+
+#ifdef __linux__
+	if (this->inotifyFd == -1)
+		return {};
+
+	// buffer aligned for inotify_event, big enough for a few events at once
+	alignas(struct inotify_event) char buf[4096];
+	ssize_t len;
+	while ((len = read(this->inotifyFd, buf, sizeof(buf))) > 0)
+	{
+		for (ssize_t offset = 0; offset < len;)
+		{
+			const auto* event = reinterpret_cast<const struct inotify_event*>(buf + offset);
+			offset += static_cast<ssize_t>(sizeof(struct inotify_event) + event->len);
+
+			auto dirSearch = this->watchedDirs.find(event->wd);
+			if (dirSearch == this->watchedDirs.end() || event->len == 0)
+				continue;
+
+			std::string path = (std::filesystem::path(dirSearch->second) / event->name).string();
+			if (dirSearch->second == "." && this->watchedFiles.find(path) == this->watchedFiles.end())
+				path = event->name;
+
+			if (this->watchedFiles.find(path) != this->watchedFiles.end())
+				changed.insert(path);
+		}
+	}
+#else
+	for (auto& [path, mtime] : this->mtimes)
+	{
+		std::error_code err;
+		std::filesystem::file_time_type newMtime = std::filesystem::last_write_time(path, err);
+		if (err || newMtime == mtime)
+			continue;
+
+		mtime = newMtime;
+		changed.insert(path);
+	}
+#endif /* __linux__ */
+
+	return std::vector<std::string>(changed.begin(), changed.end());
+}
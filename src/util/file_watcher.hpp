@@ -0,0 +1,43 @@
+// SPDX-License-Identifier: GPL-3.0-only
+//
+// (c) 2024 h67ma <szycikm@gmail.com>
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#ifndef __linux__
+#include <filesystem>
+#endif /* __linux__ */
+
+/**
+ * FileWatcher notices when watched files are modified. Changes are not reported right away, ::pollChanged() should be
+ * called periodically (e.g. once per frame) instead.
+ *
+ * On Linux, inotify is used, so polling is cheap. Parent directories of watched files are watched (instead of the files
+ * themselves), as many editors save files by writing a new file and renaming it over the old one. On other platforms,
+ * modification times of watched files are compared on each poll.
+ */
+class FileWatcher
+{
+	private:
+		std::unordered_set<std::string> watchedFiles;
+#ifdef __linux__
+		int inotifyFd = -1;
+		std::unordered_map<int, std::string> watchedDirs; // watch descriptor -> dir path
+#else
+		std::unordered_map<std::string, std::filesystem::file_time_type> mtimes;
+#endif /* __linux__ */
+
+	public:
+		FileWatcher() = default;
+		~FileWatcher();
+		FileWatcher(const FileWatcher&) = delete;
+		FileWatcher& operator=(const FileWatcher&) = delete;
+		bool watch(const std::string& path);
+		void clear();
+		std::vector<std::string> pollChanged();
+};
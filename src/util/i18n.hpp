@@ -32,7 +32,7 @@
 #define STR_INVALID_TYPE "Error loading file (%s) - invalid value for key \"%s\""
 #define STR_INVALID_ARR_SIZE "Error loading file (%s) - invalid array size for key \"%s\", expected %u, got %u."
 #define STR_MISSING_KEY "Problem loading file (%s) - key is missing: \"%s\"."
-#define STR_ROOM_LINE_TOO_LONG "Error loading room (%s, \"%s\") - line longer than %u, skipping remaining cells."
+#define STR_ROOM_ROW_TOO_LONG "Error loading room (%s, \"%s\") - row %d longer than %u cells."
 #define STR_ROOM_ROW_TOO_SHORT "Error loading room (%s, \"%s\") - row %d too short."
 #define STR_UNKNOWN_SYMBOL_AT_POS "Error loading room (%s, \"%s\") - unknown symbol at (%d, %d)."
 #define STR_ROOM_MISSING "Error loading location (%s) - room is missing: \"%s\"."
@@ -42,11 +42,16 @@
 #define STR_DUPLICATE_ROOM_IN_SAME_COORDS "Error loading location (%s) - multiple rooms defined for (%d, %d, %d)."
 #define STR_LOC_MISSING_DATA "Error loading location (%s) - room map data is missing: \"%s\"."
 #define STR_FILE_NOT_FOUND "Error: file not found (%s)."
+#define STR_PREFETCHING_LOCATION "Prefetching location %s..."
+#define STR_ROOMS_RELOADED "Reloaded rooms from %s: %zu changed, %zu removed."
+#define STR_ROOMS_RELOAD_FAILED "Failed to reload rooms from %s, previously loaded rooms were kept."
+#define STR_HOT_RELOAD_WATCH_FAIL "Can't watch %s for changes, rooms won't be reloaded."
 #define STR_LOC_CHANGED "Changed location to %s."
 #define STR_LOC_NOT_FOUND "Error changing location - location not found (%s)."
+#define STR_START_LOC_NOT_FOUND "Start location not found (%s)."
 #define STR_CAMPAIGN_LOAD_ERR "Error loading campaign (%s)."
 #define STR_CAMPAIGN_LOADING "Loading campaign (%s)..."
-#define STR_CAMPAIGN_LOADED "Finished loading campaign (%s)."
+#define STR_CAMPAIGN_LOADED "Finished loading campaign (%s) in %d ms."
 #define STR_CAMPAIGN_UNLOADING "Unloading campaign..."
 #define STR_CAMPAIGN_UNLOADED "Campaign unloaded."
 #define STR_CAMPAIGN_LOAD_FAILED "Failed to load campaign."
@@ -80,6 +85,10 @@
 #define STR_LOADING_CORE_RES "Loading core resources..."
 #define STR_LOADING_CORE_RES_DONE "Finished loading core resources."
 #define STR_LOADING "Loading..."
+#define STR_LOADING_PROGRESS "Rooms: %zu/%zu, textures: %zu, read: %zu KiB"
+#define STR_LOADING_PROGRESS_NO_TOTAL "Rooms: %zu, textures: %zu, read: %zu KiB"
+#define STR_LOADING_CANCEL_HINT "Press Esc to cancel"
+#define STR_LOADING_CANCELLED "Loading cancelled."
 #define STR_EXIT_TO_MAIN_MENU "Exit to main menu"
 #define STR_SAVE "Save"
 #define STR_RESET_DEFAULT "Reset to defaults"
@@ -128,7 +137,23 @@
 #define STR_CMD_WHERE "log current position"
 #define STR_ROOM_GEOMETRY_VAL_FAIL "Room (%d, %d, %d) geometry validation failed at (%d, %d) - room edge collider mismatch"
 #define STR_ROOM_GEOMETRY_VAL_FAIL_INSUF "Room (%d, %d, %d) geometry validation failed at (%d, %d) - insufficient space for the player"
+#define STR_COMPILED_ROOMS_LOADED "Loaded compiled rooms (%s)."
+#define STR_COMPILED_ROOMS_STALE "Compiled rooms missing or outdated (%s), loading rooms from json."
+#define STR_COMPILED_ROOMS_CORRUPT "Compiled rooms file is corrupted (%s), loading rooms from json."
+#define STR_COMPILED_ROOMS_WRITE_FAIL "Failed to write compiled rooms file (%s)."
+#define STR_ASSET_ARCHIVE_MISSING "Asset archive not found (%s), using loose files only."
+#define STR_ASSET_ARCHIVE_CORRUPT "Asset archive is corrupted (%s), using loose files only."
+#define STR_ASSET_ARCHIVE_OPENED "Opened asset archive (%s) with %zu files."
+#define STR_TEXTURE_RELOADED "Reloaded texture %s."
+#define STR_TEXTURE_RELOAD_FAIL "Failed to reload texture %s, keeping the previous image."
+#define STR_TEXTURE_CACHE_WRITE_FAIL "Failed to write cached texture (%s)."
+#define STR_ROOM_BACK_CACHE_WRITE_FAIL "Failed to write cached room background (%s)."
+#define STR_ASSET_MANIFEST_BUILT "Found %zu resource files in %s."
+#define STR_MISSING_TEXTURES "%zu textures missing in %s, see log file for details."
+#define STR_MISSING_TEXTURES_LIST "Missing textures in %s: %s"
 #define STR_REFRESHING_CAMPAIGN_LIST "Refreshing campaign list"
+#define STR_CAMPAIGN_CATALOG_SCANNING "Scanning installed campaigns..."
+#define STR_CAMPAIGN_CATALOG_WRITE_FAIL "Failed to write campaign catalog (%s)."
 #define STR_REFRESH "Refresh"
 #define GPL_SPLAT "This program comes with ABSOLUTELY NO WARRANTY.\nThis is free software, and you are welcome to redistribute it\nunder certain conditions; see LICENSE file for details."
 // clang-format on
@@ -4,9 +4,13 @@
 
 #include "json.hpp"
 
+#include <filesystem>
 #include <fstream>
+#include <system_error>
 
 #include "../hud/log.hpp"
+#include "../resources/asset_archive.hpp"
+#include "load_progress.hpp"
 
 void writeJsonToFile(const nlohmann::json& root, const std::string& path)
 {
@@ -19,6 +23,7 @@ void writeJsonToFile(const nlohmann::json& root, const std::string& path)
  * @brief Loads a json file.
  *
  * Automatically checks if the file contains a proper key with api version, and if the version equals game api version.
+ * Archived files are parsed directly from the asset archive (see AssetArchive).
  *
  * @param root reference to json root
  * @param path path to json file to load
@@ -28,6 +33,26 @@ void writeJsonToFile(const nlohmann::json& root, const std::string& path)
  */
 bool loadJsonFromFile(nlohmann::json& root, const std::string& path, bool quiet)
 {
+	const char* archivedData;
+	std::size_t archivedSize;
+	if (AssetArchive::getFile(path, archivedData, archivedSize))
+	{
+		try
+		{
+			root = nlohmann::json::parse(archivedData, archivedData + archivedSize, nullptr, true, true);
+		}
+		catch (const nlohmann::json::parse_error& ex)
+		{
+			Log::e(STR_ERROR_PARSING_JSON_FILE, path.c_str(), ex.what());
+			return false;
+		}
+
+		checkJsonApiVersion(root, path);
+		LoadProgress::getCurrent()->addBytesRead(archivedSize);
+		Log::v(STR_LOADED_FILE, path.c_str());
+		return true;
+	}
+
 	std::ifstream reader(path);
 
 	if (!reader.is_open())
@@ -48,17 +73,31 @@ bool loadJsonFromFile(nlohmann::json& root, const std::string& path, bool quiet)
 		return false;
 	}
 
-	// check api version
-	int apiVersion = -1;
-	parseJsonKey<int>(root, path, FOERR_JSON_KEY_API_VERSION, apiVersion, true);
-	if (apiVersion != JSON_API_VERSION)
-		Log::w(STR_JSON_API_VERSION_MISMATCH, path.c_str(), apiVersion, JSON_API_VERSION);
+	checkJsonApiVersion(root, path);
 
 	reader.close();
+
+	std::error_code err;
+	std::uintmax_t fileSize = std::filesystem::file_size(path, err);
+	if (!err)
+		LoadProgress::getCurrent()->addBytesRead(fileSize);
+
 	Log::v(STR_LOADED_FILE, path.c_str());
 	return true;
 }
 
+/**
+ * Checks if the json root contains a proper key with api version, and if the version equals game api version.
+ * Only prints a warning on mismatch.
+ */
+void checkJsonApiVersion(const nlohmann::json& root, const std::string& path)
+{
+	int apiVersion = -1;
+	parseJsonKey<int>(root, path, FOERR_JSON_KEY_API_VERSION, apiVersion, true);
+	if (apiVersion != JSON_API_VERSION)
+		Log::w(STR_JSON_API_VERSION_MISMATCH, path.c_str(), apiVersion, JSON_API_VERSION);
+}
+
 /**
  * Parses a three-element vector from json. Useful for sizes, coordinates, etc.
  * Coordinate element in json looks like this: "key": [123, 456, 1]
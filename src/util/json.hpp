@@ -63,6 +63,7 @@ const std::string FOERR_JSON_KEY_SPAWN_COORDS = "spawn_coords";
 
 void writeJsonToFile(const nlohmann::json& root, const std::string& path);
 bool loadJsonFromFile(nlohmann::json& root, const std::string& path, bool quiet = false);
+void checkJsonApiVersion(const nlohmann::json& root, const std::string& path);
 bool parseJsonVector3iKey(const nlohmann::json& node, const std::string& filePath, const std::string& key,
 						  sf::Vector3i& value, bool quiet = false);
 
@@ -0,0 +1,106 @@
+// SPDX-License-Identifier: GPL-3.0-only
+//
+// (c) 2024 h67ma <szycikm@gmail.com>
+
+#include "load_progress.hpp"
+
+const std::shared_ptr<LoadProgress> LoadProgress::mainProgress = std::make_shared<LoadProgress>();
+thread_local std::shared_ptr<LoadProgress> LoadProgress::currentProgress = nullptr;
+
+/**
+ * @return progress of loads displayed on the loading screen (see Campaign::loadAsync())
+ */
+const std::shared_ptr<LoadProgress>& LoadProgress::getMain()
+{
+	return LoadProgress::mainProgress;
+}
+
+/**
+ * @return progress which the calling thread reports to, see ::setCurrent(). The main progress if none was set
+ */
+const std::shared_ptr<LoadProgress>& LoadProgress::getCurrent()
+{
+	if (LoadProgress::currentProgress == nullptr)
+		return LoadProgress::mainProgress;
+
+	return LoadProgress::currentProgress;
+}
+
+/**
+ * Sets progress which the calling thread reports to. Only affects the calling thread.
+ *
+ * @param progress progress to report to, or nullptr to report to the main progress
+ */
+void LoadProgress::setCurrent(const std::shared_ptr<LoadProgress>& progress)
+{
+	LoadProgress::currentProgress = progress;
+}
+
+/**
+ * Clears all counters and the cancel request. Should be called before starting a new load.
+ */
+void LoadProgress::reset()
+{
+	this->roomsParsed = 0;
+	this->roomsTotal = 0;
+	this->texturesDecoded = 0;
+	this->bytesRead = 0;
+	this->cancelled = false;
+}
+
+void LoadProgress::addRoomsParsed(std::size_t count)
+{
+	this->roomsParsed += count;
+}
+
+/**
+ * Should be called when the number of Rooms to load is known upfront. If it's not known, progress is only displayed
+ * as counters.
+ */
+void LoadProgress::addRoomsTotal(std::size_t count)
+{
+	this->roomsTotal += count;
+}
+
+void LoadProgress::addTextureDecoded()
+{
+	this->texturesDecoded++;
+}
+
+void LoadProgress::addBytesRead(std::uint64_t count)
+{
+	this->bytesRead += count;
+}
+
+/**
+ * Requests the load to be cancelled. The load will fail at the next ::isCancelled() check.
+ */
+void LoadProgress::cancel()
+{
+	this->cancelled = true;
+}
+
+bool LoadProgress::isCancelled() const
+{
+	return this->cancelled;
+}
+
+std::size_t LoadProgress::getRoomsParsed() const
+{
+	return this->roomsParsed;
+}
+
+std::size_t LoadProgress::getRoomsTotal() const
+{
+	return this->roomsTotal;
+}
+
+std::size_t LoadProgress::getTexturesDecoded() const
+{
+	return this->texturesDecoded;
+}
+
+std::uint64_t LoadProgress::getBytesRead() const
+{
+	return this->bytesRead;
+}
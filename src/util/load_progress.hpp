@@ -0,0 +1,53 @@
+// SPDX-License-Identifier: GPL-3.0-only
+//
+// (c) 2024 h67ma <szycikm@gmail.com>
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <atomic>
+#include <memory>
+
+/**
+ * LoadProgress collects progress of a background load, so that it can be displayed on the loading screen. Counters are
+ * updated by whatever is being loaded, from any thread, and read by the main thread.
+ *
+ * It's also used to cancel the load. Loading code should check ::isCancelled() between steps which take a while, and
+ * fail if the load was cancelled.
+ *
+ * Loading code reports to the progress of the thread it runs on (see ::getCurrent()). By default, that's the main
+ * progress (see ::getMain()), used by loads started via Campaign::loadAsync() and Campaign::changeLocationAsync().
+ * Prefetching a Location (see Campaign::prefetchLocation()) uses a progress of its own instead, so that it neither
+ * disturbs nor is cancelled by other loads. Threads started by the loading code (see parallelFor()) and textures it
+ * requests (see ResourceManager::requestTexture()) report to the same progress.
+ */
+class LoadProgress
+{
+	private:
+		std::atomic<std::size_t> roomsParsed = 0;
+		std::atomic<std::size_t> roomsTotal = 0;
+		std::atomic<std::size_t> texturesDecoded = 0;
+		std::atomic<std::uint64_t> bytesRead = 0;
+		std::atomic<bool> cancelled = false;
+
+		static const std::shared_ptr<LoadProgress> mainProgress;
+		static thread_local std::shared_ptr<LoadProgress> currentProgress;
+
+	public:
+		static const std::shared_ptr<LoadProgress>& getMain();
+		static const std::shared_ptr<LoadProgress>& getCurrent();
+		static void setCurrent(const std::shared_ptr<LoadProgress>& progress);
+		void reset();
+		void addRoomsParsed(std::size_t count);
+		void addRoomsTotal(std::size_t count);
+		void addTextureDecoded();
+		void addBytesRead(std::uint64_t count);
+		void cancel();
+		bool isCancelled() const;
+		std::size_t getRoomsParsed() const;
+		std::size_t getRoomsTotal() const;
+		std::size_t getTexturesDecoded() const;
+		std::uint64_t getBytesRead() const;
+};
@@ -0,0 +1,136 @@
+// SPDX-License-Identifier: GPL-3.0-only
+//
+// (c) 2024 h67ma <szycikm@gmail.com>
+
+#include "mapped_file.hpp"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif /* _WIN32 */
+
+MappedFile::~MappedFile()
+{
+	this->close();
+}
+
+/**
+ * Maps the whole file into memory. Any previously mapped file is released first.
+ *
+ * Empty files can be opened, but ::getData() will return nullptr for them.
+ *
+ * @param path path to the file
+ * @return true if the file was mapped
+ * @return false if the file does not exist or could not be mapped
+ */
+bool MappedFile::open(const std::string& path)
+{
+	this->close();
+
+#ifdef _WIN32
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL,
+							  NULL);
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize))
+	{
+		CloseHandle(file);
+		return false;
+	}
+
+	this->fileHandle = file;
+	this->size = static_cast<std::size_t>(fileSize.QuadPart);
+	if (this->size == 0)
+		return true; // can't map an empty file
+
+	HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (mapping == NULL)
+	{
+		this->close();
+		return false;
+	}
+
+	this->mappingHandle = mapping;
+	this->data = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+	if (this->data == nullptr)
+	{
+		this->close();
+		return false;
+	}
+#else
+	int fd = ::open(path.c_str(), O_RDONLY);
+	if (fd < 0)
+		return false;
+
+	struct stat fileStat;
+	if (fstat(fd, &fileStat) != 0)
+	{
+		::close(fd);
+		return false;
+	}
+
+	this->size = static_cast<std::size_t>(fileStat.st_size);
+	if (this->size == 0)
+	{
+		::close(fd);
+		return true; // can't map an empty file
+	}
+
+	void* mapped = mmap(nullptr, this->size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+	// the mapping stays valid after closing the descriptor
+	::close(fd);
+
+	if (mapped == MAP_FAILED)
+	{
+		this->size = 0;
+		return false;
+	}
+
+	this->data = static_cast<const char*>(mapped);
+#endif /* _WIN32 */
+
+	return true;
+}
+
+/**
+ * Releases the mapping. Safe to call multiple times.
+ */
+void MappedFile::close()
+{
+#ifdef _WIN32
+	if (this->data != nullptr)
+		UnmapViewOfFile(this->data);
+
+	if (this->mappingHandle != nullptr)
+		CloseHandle(this->mappingHandle);
+
+	if (this->fileHandle != nullptr)
+		CloseHandle(this->fileHandle);
+
+	this->mappingHandle = nullptr;
+	this->fileHandle = nullptr;
+#else
+	if (this->data != nullptr)
+		munmap(const_cast<char*>(this->data), this->size);
+#endif /* _WIN32 */
+
+	this->data = nullptr;
+	this->size = 0;
+}
+
+const char* MappedFile::getData() const
+{
+	return this->data;
+}
+
+std::size_t MappedFile::getSize() const
+{
+	return this->size;
+}
@@ -0,0 +1,36 @@
+// SPDX-License-Identifier: GPL-3.0-only
+//
+// (c) 2024 h67ma <szycikm@gmail.com>
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+/**
+ * MappedFile is a read-only view of a whole file, mapped into memory. This allows reading (potentially large) binary
+ * files without copying their contents into a separate buffer - the OS will load the pages as they are accessed.
+ *
+ * The mapping is released when the object is destroyed, or when ::close() is called. Any pointers obtained via
+ * ::getData() are invalid after that.
+ */
+class MappedFile
+{
+	private:
+		const char* data = nullptr;
+		std::size_t size = 0;
+#ifdef _WIN32
+		void* fileHandle = nullptr;
+		void* mappingHandle = nullptr;
+#endif /* _WIN32 */
+
+	public:
+		MappedFile() = default;
+		~MappedFile();
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+		bool open(const std::string& path);
+		void close();
+		const char* getData() const;
+		std::size_t getSize() const;
+};
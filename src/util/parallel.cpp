@@ -0,0 +1,82 @@
+// SPDX-License-Identifier: GPL-3.0-only
+//
+// (c) 2024 h67ma <szycikm@gmail.com>
+
+#include "parallel.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "load_progress.hpp"
+
+/**
+ * @return number of threads which can run at the same time (at least 1)
+ */
+std::size_t getParallelThreadCnt()
+{
+	// hardware_concurrency() can return 0 if the value is not computable
+	return std::max(1U, std::thread::hardware_concurrency());
+}
+
+/**
+ * Runs `job` for every index in range [0, count), spreading the work over as many threads as there are hardware
+ * threads available (but no more than `count`). The calling thread also takes part in the work, and is blocked until
+ * all jobs have finished.
+ *
+ * Jobs are picked up in ascending index order, but can finish in any order. As soon as any job fails, no new jobs are
+ * started (jobs which are already running will still finish).
+ *
+ * Jobs must not throw.
+ *
+ * Worker threads report load progress to the same LoadProgress as the calling thread (see LoadProgress::getCurrent()).
+ *
+ * @param count number of jobs to run
+ * @param job function to run for each index, should return false on failure
+ * @return true if all jobs succeeded
+ * @return false if any of the jobs failed
+ */
+bool parallelFor(std::size_t count, const std::function<bool(std::size_t)>& job)
+{
+	std::atomic<std::size_t> nextIdx = 0;
+	std::atomic<bool> failed = false;
+	const std::shared_ptr<LoadProgress> progress = LoadProgress::getCurrent();
+
+	auto worker = [&nextIdx, &failed, &job, count]()
+	{
+		while (!failed)
+		{
+			std::size_t idx = nextIdx++;
+			if (idx >= count)
+				return;
+
+			if (!job(idx))
+				failed = true;
+		}
+	};
+
+	std::size_t threadCnt = std::min(getParallelThreadCnt(), count);
+
+	std::vector<std::thread> threads;
+	for (std::size_t i = 1; i < threadCnt; i++)
+	{
+		threads.emplace_back(
+			[&worker, &progress]()
+			{
+				LoadProgress::setCurrent(progress);
+				worker();
+			});
+	}
+
+	// no reason for this thread to sit idle
+	worker();
+
+	for (auto& thread : threads)
+	{
+		thread.join();
+	}
+
+	return !failed;
+}
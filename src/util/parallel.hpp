@@ -0,0 +1,12 @@
+// SPDX-License-Identifier: GPL-3.0-only
+//
+// (c) 2024 h67ma <szycikm@gmail.com>
+
+#pragma once
+
+#include <cstddef>
+
+#include <functional>
+
+std::size_t getParallelThreadCnt();
+bool parallelFor(std::size_t count, const std::function<bool(std::size_t)>& job);
@@ -0,0 +1,237 @@
+// SPDX-License-Identifier: GPL-3.0-only
+//
+// (c) 2024 h67ma <szycikm@gmail.com>
+
+#include "qoi.hpp"
+
+#include <cstring>
+
+constexpr char QOI_MAGIC[] = { 'q', 'o', 'i', 'f' };
+constexpr std::uint8_t QOI_CHANNELS_RGBA = 4;
+constexpr std::uint8_t QOI_COLORSPACE_SRGB = 0;
+constexpr std::size_t QOI_HEADER_SIZE = 14;
+constexpr std::uint8_t QOI_PADDING[] = { 0, 0, 0, 0, 0, 0, 0, 1 };
+
+constexpr std::uint8_t QOI_OP_INDEX = 0x00;
+constexpr std::uint8_t QOI_OP_DIFF = 0x40;
+constexpr std::uint8_t QOI_OP_LUMA = 0x80;
+constexpr std::uint8_t QOI_OP_RUN = 0xC0;
+constexpr std::uint8_t QOI_OP_RGB = 0xFE;
+constexpr std::uint8_t QOI_OP_RGBA = 0xFF;
+constexpr std::uint8_t QOI_MASK_2 = 0xC0;
+constexpr std::uint32_t QOI_MAX_RUN = 62;
+constexpr std::uint32_t QOI_INDEX_SIZE = 64;
+
+struct qoi_pixel
+{
+		std::uint8_t r = 0;
+		std::uint8_t g = 0;
+		std::uint8_t b = 0;
+		std::uint8_t a = 0;
+
+		bool operator==(const struct qoi_pixel& other) const
+		{
+			return this->r == other.r && this->g == other.g && this->b == other.b && this->a == other.a;
+		}
+};
+
+static std::uint32_t qoiHash(const struct qoi_pixel& px)
+{
+	return (px.r * 3 + px.g * 5 + px.b * 7 + px.a * 11) % QOI_INDEX_SIZE;
+}
+
+static void writeBigEndian(BinaryWriter& writer, std::uint32_t value)
+{
+	const std::uint8_t bytes[] = { static_cast<std::uint8_t>(value >> 24), static_cast<std::uint8_t>(value >> 16),
+								   static_cast<std::uint8_t>(value >> 8), static_cast<std::uint8_t>(value) };
+	writer.writeBytes(bytes, sizeof(bytes));
+}
+
+static std::uint32_t readBigEndian(const std::uint8_t* bytes)
+{
+	return (static_cast<std::uint32_t>(bytes[0]) << 24) | (static_cast<std::uint32_t>(bytes[1]) << 16) |
+		   (static_cast<std::uint32_t>(bytes[2]) << 8) | static_cast<std::uint32_t>(bytes[3]);
+}
+
+/**
+ * Encodes an RGBA image as QOI and appends it to the writer.
+ *
+ * @param pixels image pixels, 4 bytes per pixel, row by row
+ * @param width image width
+ * @param height image height
+ * @param writer writer to append the encoded image to
+ */
+void qoiEncode(const std::uint8_t* pixels, std::uint32_t width, std::uint32_t height, BinaryWriter& writer)
+{
+	writer.writeBytes(QOI_MAGIC, sizeof(QOI_MAGIC));
+	writeBigEndian(writer, width);
+	writeBigEndian(writer, height);
+	writer.write(QOI_CHANNELS_RGBA);
+	writer.write(QOI_COLORSPACE_SRGB);
+
+	struct qoi_pixel index[QOI_INDEX_SIZE];
+	struct qoi_pixel prev;
+	prev.a = 255;
+	std::uint32_t run = 0;
+
+	const std::size_t pixelCnt = static_cast<std::size_t>(width) * height;
+	for (std::size_t i = 0; i < pixelCnt; i++)
+	{
+		struct qoi_pixel px;
+		std::memcpy(&px, pixels + i * 4, 4);
+
+		if (px == prev)
+		{
+			run++;
+			if (run == QOI_MAX_RUN || i == pixelCnt - 1)
+			{
+				writer.write(static_cast<std::uint8_t>(QOI_OP_RUN | (run - 1)));
+				run = 0;
+			}
+
+			continue;
+		}
+
+		if (run > 0)
+		{
+			writer.write(static_cast<std::uint8_t>(QOI_OP_RUN | (run - 1)));
+			run = 0;
+		}
+
+		const std::uint32_t hash = qoiHash(px);
+		if (index[hash] == px)
+		{
+			writer.write(static_cast<std::uint8_t>(QOI_OP_INDEX | hash));
+		}
+		else if (px.a != prev.a)
+		{
+			index[hash] = px;
+			writer.write(QOI_OP_RGBA);
+			writer.writeBytes(&px, 4);
+		}
+		else
+		{
+			index[hash] = px;
+
+			// differences wrap around, same as in the reference implementation
+			const int dr = static_cast<std::int8_t>(px.r - prev.r);
+			const int dg = static_cast<std::int8_t>(px.g - prev.g);
+			const int db = static_cast<std::int8_t>(px.b - prev.b);
+			const int dgr = dr - dg;
+			const int dgb = db - dg;
+
+			if (dr >= -2 && dr <= 1 && dg >= -2 && dg <= 1 && db >= -2 && db <= 1)
+			{
+				writer.write(static_cast<std::uint8_t>(QOI_OP_DIFF | (dr + 2) << 4 | (dg + 2) << 2 | (db + 2)));
+			}
+			else if (dgr >= -8 && dgr <= 7 && dg >= -32 && dg <= 31 && dgb >= -8 && dgb <= 7)
+			{
+				writer.write(static_cast<std::uint8_t>(QOI_OP_LUMA | (dg + 32)));
+				writer.write(static_cast<std::uint8_t>((dgr + 8) << 4 | (dgb + 8)));
+			}
+			else
+			{
+				writer.write(QOI_OP_RGB);
+				writer.writeBytes(&px, 3);
+			}
+		}
+
+		prev = px;
+	}
+
+	writer.writeBytes(QOI_PADDING, sizeof(QOI_PADDING));
+}
+
+/**
+ * Decodes a QOI image. Only images with 4 channels (RGBA) are supported.
+ *
+ * @param data encoded image
+ * @param size size of encoded image
+ * @param width image width will be stored here
+ * @param height image height will be stored here
+ * @param pixels decoded pixels will be stored here, 4 bytes per pixel, row by row
+ * @return true if the image was decoded
+ * @return false if the image is not a valid QOI image
+ */
+bool qoiDecode(const char* data, std::size_t size, std::uint32_t& width, std::uint32_t& height,
+			   std::vector<std::uint8_t>& pixels)
+{
+	if (size < QOI_HEADER_SIZE + sizeof(QOI_PADDING) || std::memcmp(data, QOI_MAGIC, sizeof(QOI_MAGIC)) != 0)
+		return false;
+
+	const std::uint8_t* bytes = reinterpret_cast<const std::uint8_t*>(data);
+	width = readBigEndian(bytes + 4);
+	height = readBigEndian(bytes + 8);
+	if (width == 0 || height == 0 || width > QOI_MAX_SIDE_LEN || height > QOI_MAX_SIDE_LEN ||
+		bytes[12] != QOI_CHANNELS_RGBA)
+		return false;
+
+	const std::size_t pixelCnt = static_cast<std::size_t>(width) * height;
+	pixels.resize(pixelCnt * 4);
+
+	struct qoi_pixel index[QOI_INDEX_SIZE];
+	struct qoi_pixel px;
+	px.a = 255;
+	std::uint32_t run = 0;
+
+	// every op is at most 5 bytes long, and the padding is 8 bytes long, so as long as the position is before the
+	// padding, the whole op can be read without checking bounds
+	std::size_t pos = QOI_HEADER_SIZE;
+	const std::size_t chunksEnd = size - sizeof(QOI_PADDING);
+
+	for (std::size_t i = 0; i < pixelCnt; i++)
+	{
+		if (run > 0)
+		{
+			run--;
+		}
+		else
+		{
+			if (pos >= chunksEnd)
+				return false;
+
+			const std::uint8_t b1 = bytes[pos++];
+			if (b1 == QOI_OP_RGB)
+			{
+				px.r = bytes[pos++];
+				px.g = bytes[pos++];
+				px.b = bytes[pos++];
+			}
+			else if (b1 == QOI_OP_RGBA)
+			{
+				px.r = bytes[pos++];
+				px.g = bytes[pos++];
+				px.b = bytes[pos++];
+				px.a = bytes[pos++];
+			}
+			else if ((b1 & QOI_MASK_2) == QOI_OP_INDEX)
+			{
+				px = index[b1];
+			}
+			else if ((b1 & QOI_MASK_2) == QOI_OP_DIFF)
+			{
+				px.r += ((b1 >> 4) & 0x03) - 2;
+				px.g += ((b1 >> 2) & 0x03) - 2;
+				px.b += (b1 & 0x03) - 2;
+			}
+			else if ((b1 & QOI_MASK_2) == QOI_OP_LUMA)
+			{
+				const std::uint8_t b2 = bytes[pos++];
+				const int dg = (b1 & 0x3F) - 32;
+				px.r += dg - 8 + ((b2 >> 4) & 0x0F);
+				px.g += dg;
+				px.b += dg - 8 + (b2 & 0x0F);
+			}
+			else // QOI_OP_RUN
+			{
+				run = b1 & 0x3F;
+			}
+
+			index[qoiHash(px)] = px;
+		}
+
+		std::memcpy(pixels.data() + i * 4, &px, 4);
+	}
+
+	return true;
+}
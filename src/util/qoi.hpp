@@ -0,0 +1,24 @@
+// SPDX-License-Identifier: GPL-3.0-only
+//
+// (c) 2024 h67ma <szycikm@gmail.com>
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <vector>
+
+#include "binary_stream.hpp"
+
+// images bigger than that are considered corrupted. it's way above max texture size of any sane GPU anyway
+constexpr std::uint32_t QOI_MAX_SIDE_LEN = 32768;
+
+/**
+ * Minimal implementation of the "Quite OK Image" format (https://qoiformat.org/qoi-specification.pdf), only supporting
+ * RGBA images. QOI compresses almost as well as PNG for the kind of images used in the game, but decodes several times
+ * faster, which makes it a good format for caching decoded textures (see TextureCache).
+ */
+void qoiEncode(const std::uint8_t* pixels, std::uint32_t width, std::uint32_t height, BinaryWriter& writer);
+bool qoiDecode(const char* data, std::size_t size, std::uint32_t& width, std::uint32_t& height,
+			   std::vector<std::uint8_t>& pixels);
@@ -1,11 +1,12 @@
 // SPDX-License-Identifier: GPL-3.0-only
 //
-// (c) 2023 h67ma <szycikm@gmail.com>
+// (c) 2023-2024 h67ma <szycikm@gmail.com>
 
 #include "random.hpp"
 
 std::random_device Randomizer::ranDev;
 std::default_random_engine Randomizer::engine(Randomizer::ranDev());
+std::mutex Randomizer::mutex;
 
 int Randomizer::getRandomBetween(int min, int max)
 {
@@ -13,5 +14,8 @@ int Randomizer::getRandomBetween(int min, int max)
 		return min;
 
 	std::uniform_int_distribution<int> dist(min, max);
+
+	// the engine can be shared between threads (e.g. Rooms being loaded in parallel)
+	const std::lock_guard<std::mutex> lock(Randomizer::mutex);
 	return dist(Randomizer::engine);
 }
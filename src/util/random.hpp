@@ -1,9 +1,10 @@
 // SPDX-License-Identifier: GPL-3.0-only
 //
-// (c) 2023 h67ma <szycikm@gmail.com>
+// (c) 2023-2024 h67ma <szycikm@gmail.com>
 
 #pragma once
 
+#include <mutex>
 #include <random>
 
 /**
@@ -16,6 +17,7 @@ class Randomizer
 	private:
 		static std::random_device ranDev; // rendez-vous...
 		static std::default_random_engine engine;
+		static std::mutex mutex;
 
 	public:
 		static int getRandomBetween(int min, int max);
@@ -1,12 +1,54 @@
 // SPDX-License-Identifier: GPL-3.0-only
 //
-// (c) 2022-2023 h67ma <szycikm@gmail.com>
+// (c) 2022-2024 h67ma <szycikm@gmail.com>
 
 #include "util.hpp"
 
 #include <sstream>
 #include <stdexcept>
 
+#include "mapped_file.hpp"
+
+constexpr std::uint64_t FNV_PRIME = 0x100000001B3;
+
+/**
+ * Calculates a 64-bit FNV-1a hash of a memory buffer. Not suitable for cryptography, but fast and good enough for
+ * detecting changes in files.
+ *
+ * Hashes can be chained by passing the result of a previous call as ::seed.
+ */
+std::uint64_t hashBytes(const char* data, std::size_t size, std::uint64_t seed)
+{
+	std::uint64_t hash = seed;
+
+	for (std::size_t i = 0; i < size; i++)
+	{
+		hash ^= static_cast<unsigned char>(data[i]);
+		hash *= FNV_PRIME;
+	}
+
+	return hash;
+}
+
+/**
+ * Calculates hash of file contents (see ::hashBytes()).
+ *
+ * @param path path to the file
+ * @param hash calculated hash will be stored here
+ * @param seed previous hash, when chaining hashes of multiple files
+ * @return true if the file was read
+ * @return false if the file could not be read
+ */
+bool hashFile(const std::string& path, std::uint64_t& hash, std::uint64_t seed)
+{
+	MappedFile file;
+	if (!file.open(path))
+		return false;
+
+	hash = hashBytes(file.getData(), file.getSize(), seed);
+	return true;
+}
+
 void splitString(std::vector<std::string>& tokens, const std::string& input, char delim)
 {
 	std::stringstream ss(input);
@@ -46,3 +88,17 @@ sf::Vector2u operator+(sf::Vector2f lhs, sf::Vector2u rhs)
 	rhs.y += lhs.y;
 	return rhs;
 }
+
+/**
+ * Mirrors a transformable (e.g. a sprite) horizontally, relative to the center of an area starting at x=0, with given
+ * width. The transformable itself is also flipped. Mirroring twice restores the original transform.
+ *
+ * Rotation is not taken into account.
+ */
+void mirrorHorizontally(sf::Transformable& transformable, float areaWidth)
+{
+	const sf::Vector2f scale = transformable.getScale();
+	const sf::Vector2f position = transformable.getPosition();
+	transformable.setScale(-scale.x, scale.y);
+	transformable.setPosition(areaWidth - position.x, position.y);
+}
@@ -4,9 +4,12 @@
 
 #pragma once
 
+#include <cstdint>
+
 #include <string>
 #include <vector>
 
+#include <SFML/Graphics/Transformable.hpp>
 #include <SFML/System/Vector2.hpp>
 
 #include "../consts.hpp"
@@ -69,11 +72,17 @@ inline void hash_combine(std::size_t& seed, const T& v)
 	seed ^= std::hash<T> {}(v) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
 }
 
+// FNV-1a offset basis
+constexpr std::uint64_t HASH_SEED = 0xCBF29CE484222325;
+
+std::uint64_t hashBytes(const char* data, std::size_t size, std::uint64_t seed = HASH_SEED);
+bool hashFile(const std::string& path, std::uint64_t& hash, std::uint64_t seed = HASH_SEED);
 void splitString(std::vector<std::string>& tokens, const std::string& input, char delim);
 bool strToInt(const std::string& input, int& output);
 
 void operator-=(sf::Vector2i& lhs, sf::Vector2f rhs);
 sf::Vector2u operator+(sf::Vector2f lhs, sf::Vector2u rhs);
+void mirrorHorizontally(sf::Transformable& transformable, float areaWidth);
 
 /**
  * Divides and ceils an uint value.
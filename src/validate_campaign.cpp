@@ -0,0 +1,125 @@
+// SPDX-License-Identifier: GPL-3.0-only
+//
+// (c) 2024 h67ma <szycikm@gmail.com>
+
+#include <cstdlib>
+
+#include <filesystem>
+#include <iostream>
+#include <set>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "campaigns/campaign.hpp"
+#include "consts.hpp"
+#include "hud/log.hpp"
+#include "resources/asset_archive.hpp"
+#include "resources/asset_manifest.hpp"
+#include "resources/resource_manager.hpp"
+#include "settings/settings_manager.hpp"
+
+/**
+ * Headless campaign validator.
+ *
+ * Loads all Locations of the selected campaigns (or all available campaigns, if none are selected), without creating a
+ * window, and prints a report in json format to stdout. Log messages are printed to stderr.
+ *
+ * Usage: foerr-validate [campaign_id...]
+ *
+ * Exit code is 0 if all campaigns are valid, 1 if any campaign is invalid.
+ */
+int main(int argc, char* argv[])
+{
+	SettingsManager::setup();
+	Log::setup();
+	SettingsManager::debugVerbose = false;
+
+	AssetArchive::open(PATH_ASSET_ARCHIVE); // optional
+	AssetManifest::build(PATH_DIR_RES);
+
+	std::set<std::string> campaignIds;
+	for (int i = 1; i < argc; i++)
+	{
+		campaignIds.insert(argv[i]);
+	}
+
+	if (campaignIds.empty())
+	{
+		// same as on the New Game page, campaigns can be either loose or archived
+		AssetArchive::addSubdirNames(PATH_CAMPAIGNS, campaignIds);
+
+		std::error_code err;
+		for (const auto& entry : std::filesystem::directory_iterator(PATH_CAMPAIGNS, err))
+		{
+			if (entry.is_directory())
+				campaignIds.insert(entry.path().stem().string());
+		}
+	}
+
+	// errors and warnings are collected separately for each campaign
+	std::vector<std::string> errors;
+	std::vector<std::string> warnings;
+	Log::setMsgAddedCallback(
+		[&errors, &warnings](const StringAndColor& message)
+		{
+			if (message.second == sf::Color::Red)
+				errors.push_back(message.first);
+			else if (message.second == sf::Color::Yellow)
+				warnings.push_back(message.first);
+		});
+
+	ResourceManager resMgr(true);
+	Campaign campaign(resMgr);
+
+	bool allValid = true;
+	nlohmann::json report;
+	report["campaigns"] = nlohmann::json::array();
+
+	for (const std::string& campaignId : campaignIds)
+	{
+		errors.clear();
+		warnings.clear();
+
+		struct campaign_validation result;
+		bool valid = campaign.validate(campaignId, result);
+
+		// pick up messages logged by worker threads
+		Log::tick();
+
+		nlohmann::json locationsNode = nlohmann::json::object();
+		for (const auto& [locId, locResult] : result.locations)
+		{
+			nlohmann::json unreachableNode = nlohmann::json::array();
+			for (const auto& coords : locResult.unreachableRooms)
+			{
+				unreachableNode.push_back({ coords.x, coords.y, coords.z });
+			}
+
+			locationsNode[locId] = {
+				{ "valid", locResult.valid },
+				{ "rooms", locResult.roomCnt },
+				{ "unreachable_rooms", unreachableNode },
+			};
+		}
+
+		report["campaigns"].push_back({
+			{ "id", campaignId },
+			{ "valid", valid },
+			{ "start_location_found", result.startLocationFound },
+			{ "locations", locationsNode },
+			{ "missing_textures", result.missingTextures },
+			{ "errors", errors },
+			{ "warnings", warnings },
+		});
+
+		allValid &= valid;
+	}
+
+	report["valid"] = allValid;
+	std::cout << report.dump(1, '\t') << std::endl;
+
+	return allValid ? EXIT_SUCCESS : EXIT_FAILURE;
+}
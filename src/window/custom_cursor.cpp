@@ -5,6 +5,7 @@
 #include "custom_cursor.hpp"
 
 #include "../hud/log.hpp"
+#include "../resources/asset_archive.hpp"
 #include "../settings/settings_manager.hpp"
 #include "../util/i18n.hpp"
 
@@ -28,8 +29,13 @@ bool CustomCursor::load()
 		return this->loadFromSystem(this->fallbackCursor);
 
 	sf::Image img;
+	const char* archivedData;
+	std::size_t archivedSize;
+	bool loaded = AssetArchive::getFile(this->path, archivedData, archivedSize) ?
+					  img.loadFromMemory(archivedData, archivedSize) :
+					  img.loadFromFile(this->path);
 
-	if (!img.loadFromFile(this->path))
+	if (!loaded)
 	{
 		Log::w(STR_CURSOR_LOAD_IMG_ERR, this->path.c_str());
 		return this->loadFromSystem(this->fallbackCursor);
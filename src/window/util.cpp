@@ -67,7 +67,8 @@ void setLetterboxView(sf::View& view, sf::Vector2u windowSize)
 }
 
 void windowSizeChanged(sf::Vector2u windowSize, FpsMeter& fpsMeter, sf::View& hudView, sf::View& gameWorldView,
-					   PipBuck& pipBuck, MainMenu& mainMenu, DevConsole& console)
+					   PipBuck& pipBuck, MainMenu& mainMenu, DevConsole& console, ResourceManager& resMgr,
+					   Campaign& campaign)
 {
 	// update position of dockable elements
 	Log::handleScreenResize(windowSize);
@@ -79,10 +80,19 @@ void windowSizeChanged(sf::Vector2u windowSize, FpsMeter& fpsMeter, sf::View& hu
 	// update views
 	hudView.reset({ 0.F, 0.F, static_cast<float>(windowSize.x), static_cast<float>(windowSize.y) });
 	setLetterboxView(gameWorldView, windowSize);
+
+	// pick texture variants matching the new size of game world viewport.
+	// Campaign can't be touched while loading, but it will pick up the new variant after entering the Location
+	const sf::FloatRect& viewport = gameWorldView.getViewport();
+	resMgr.setWorldViewportSize({ static_cast<uint>(static_cast<float>(windowSize.x) * viewport.width),
+								  static_cast<uint>(static_cast<float>(windowSize.y) * viewport.height) });
+	if (!campaign.isLoading())
+		campaign.handleWorldViewportChange();
 }
 
 void toggleFullscreen(sf::RenderWindow& window, FpsMeter& fpsMeter, sf::View& hudView, sf::View& gameWorldView,
-					  PipBuck& pipBuck, MainMenu& mainMenu, DevConsole& console)
+					  PipBuck& pipBuck, MainMenu& mainMenu, DevConsole& console, ResourceManager& resMgr,
+					  Campaign& campaign)
 {
 	if (SettingsManager::fullscreen)
 	{
@@ -96,5 +106,5 @@ void toggleFullscreen(sf::RenderWindow& window, FpsMeter& fpsMeter, sf::View& hu
 	}
 
 	recreateWindow(window);
-	windowSizeChanged(window.getSize(), fpsMeter, hudView, gameWorldView, pipBuck, mainMenu, console);
+	windowSizeChanged(window.getSize(), fpsMeter, hudView, gameWorldView, pipBuck, mainMenu, console, resMgr, campaign);
 }
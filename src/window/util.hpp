@@ -8,16 +8,20 @@
 #include <SFML/Graphics/View.hpp>
 #include <SFML/Window/Mouse.hpp>
 
+#include "../campaigns/campaign.hpp"
 #include "../hud/dev_console.hpp"
 #include "../hud/fps_meter.hpp"
 #include "../hud/main_menu/main_menu.hpp"
 #include "../hud/pipbuck/pipbuck.hpp"
+#include "../resources/resource_manager.hpp"
 
 void recreateWindow(sf::RenderWindow& window);
 void windowSizeChanged(sf::Vector2u windowSize, FpsMeter& fpsMeter, sf::View& hudView, sf::View& gameWorldView,
-					   PipBuck& pipBuck, MainMenu& mainMenu, DevConsole& console);
+					   PipBuck& pipBuck, MainMenu& mainMenu, DevConsole& console, ResourceManager& resMgr,
+					   Campaign& campaign);
 void toggleFullscreen(sf::RenderWindow& window, FpsMeter& fpsMeter, sf::View& hudView, sf::View& gameWorldView,
-					  PipBuck& pipBuck, MainMenu& mainMenu, DevConsole& console);
+					  PipBuck& pipBuck, MainMenu& mainMenu, DevConsole& console, ResourceManager& resMgr,
+					  Campaign& campaign);
 
 /**
  * Returns the coordinates of current mouse postion in world units.